@@ -0,0 +1,82 @@
+#include "ai/advisor.h"
+#include "ai/board.h"
+#include "ai/strategy.h"
+#include "logic/logic.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+Advisor::Advisor(std::unique_ptr<Strategy> strategy)
+    : strategy_(std::move(strategy))
+    , pending_generation_(0)
+    , finished_(false)
+    , cancel_(false)
+    , mailbox_(kEmptyMailbox)
+    , requested_generation_(0) {
+  if (!strategy_)
+    throw std::runtime_error("advisor needs a strategy");
+  strategy_->SetCancelFlag(&cancel_);
+  worker_ = std::thread(&Advisor::WorkerLoop, this);
+}
+
+Advisor::~Advisor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_ = true;
+    cancel_ = true;
+  }
+  condition_.notify_one();
+  worker_.join();
+}
+
+void Advisor::Request(Board board) {
+  if (requested_generation_ && board == requested_board_)
+    return;
+  requested_board_ = board;
+  requested_generation_++;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_board_ = board;
+    pending_generation_ = requested_generation_;
+    cancel_ = true;
+  }
+  condition_.notify_one();
+}
+
+bool Advisor::TryGetMove(Directions* move) const {
+  uint64_t mailbox = mailbox_.load(std::memory_order_acquire);
+  if (mailbox == kEmptyMailbox
+      || (mailbox >> kMoveBits) != requested_generation_)
+    return false;
+  *move = static_cast<Directions>(mailbox & ((1 << kMoveBits) - 1));
+  return true;
+}
+
+void Advisor::WorkerLoop() {
+  uint64_t done_generation = 0;
+  while (true) {
+    Board board;
+    uint64_t generation;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this, done_generation] {
+        return finished_ || pending_generation_ != done_generation;
+      });
+      if (finished_)
+        return;
+      board = pending_board_;
+      generation = done_generation = pending_generation_;
+      cancel_ = false;
+    }
+    Directions move = strategy_->ChooseMove(board);
+    if (cancel_)
+      continue;
+    mailbox_.store((generation << kMoveBits) | static_cast<uint64_t>(move),
+                   std::memory_order_release);
+  }
+}
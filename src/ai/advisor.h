@@ -0,0 +1,50 @@
+#ifndef _2048_AI_ADVISOR_H_
+#define _2048_AI_ADVISOR_H_
+
+#include "ai/board.h"
+#include "ai/strategy.h"
+#include "logic/logic.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/* Runs a strategy on a background thread. The game thread posts boards with
+ * Request and polls TryGetMove, which never blocks: the worker publishes
+ * the result together with the request generation in a single atomic word.
+ * A request for a new board cancels the search of the previous one. */
+class Advisor {
+ public:
+  explicit Advisor(std::unique_ptr<Strategy> strategy);
+  ~Advisor();
+
+  Advisor(const Advisor&) = delete;
+  Advisor& operator=(const Advisor&) = delete;
+
+  void Request(Board board);
+
+  bool TryGetMove(Directions* move) const;
+
+ private:
+  static constexpr uint64_t kEmptyMailbox = ~0ULL;
+  static constexpr int32_t kMoveBits = 8;
+
+  void WorkerLoop();
+
+  std::unique_ptr<Strategy> strategy_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  Board pending_board_;
+  uint64_t pending_generation_;
+  bool finished_;
+  std::atomic<bool> cancel_;
+  std::atomic<uint64_t> mailbox_;
+  Board requested_board_;
+  uint64_t requested_generation_;
+  std::thread worker_;
+};
+
+#endif
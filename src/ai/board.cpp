@@ -0,0 +1,113 @@
+#include "ai/board.h"
+#include "ai/row_tables.h"
+#include "cpu/cpu.h"
+#include "logic/logic.h"
+
+#include <stdexcept>
+#include <cstdint>
+#include <vector>
+
+#ifdef GAME2048_X86
+#include <immintrin.h>
+#endif
+
+constexpr uint64_t Board::kNibbleOnes;
+
+namespace {
+
+using FindBitFunction = int32_t (*)(uint64_t mask, int32_t number);
+
+/* position of the number-th set bit of mask */
+int32_t FindBit(uint64_t mask, int32_t number) {
+  for (int32_t k = 0; k < number; k++)
+    mask &= mask - 1;
+  return __builtin_ctzll(mask);
+}
+
+#ifdef GAME2048_X86
+
+__attribute__((target("bmi2")))
+int32_t FindBitBmi2(uint64_t mask, int32_t number) {
+  return __builtin_ctzll(_pdep_u64(1ULL << number, mask));
+}
+
+#endif
+
+FindBitFunction SelectFindBit() {
+#ifdef GAME2048_X86
+  if (HasFastBmi2())
+    return FindBitBmi2;
+#endif
+  return FindBit;
+}
+
+}  // namespace
+
+Board Board::FromMatrix(
+    const std::vector<std::vector<Logic::TileInfo>>& matrix) {
+  if (matrix.size() != kLength)
+    throw std::runtime_error("packed board supports only 4x4 matrix");
+  Board board;
+  for (int32_t i = 0; i < kLength; i++)
+    for (int32_t j = 0; j < kLength; j++)
+      board.SetTile(i, j, matrix[i][j].value);
+  return board;
+}
+
+void Board::SetTile(int32_t row_idx, int32_t column_idx, Tiles tile) {
+  int32_t shift = Shift(row_idx, column_idx);
+  cells_ &= ~(0xFULL << shift);
+  cells_ |= static_cast<uint64_t>(tile) << shift;
+}
+
+Board Board::Transposed() const {
+  uint64_t a1 = cells_ & 0xF0F00F0FF0F00F0FULL;
+  uint64_t a2 = cells_ & 0x0000F0F00000F0F0ULL;
+  uint64_t a3 = cells_ & 0x0F0F00000F0F0000ULL;
+  uint64_t a = a1 | (a2 << 12) | (a3 >> 12);
+  uint64_t b1 = a & 0xFF00FF0000FF00FFULL;
+  uint64_t b2 = a & 0x00FF00FF00000000ULL;
+  uint64_t b3 = a & 0x00000000FF00FF00ULL;
+  return Board(b1 | (b2 >> 24) | (b3 << 24));
+}
+
+Board Board::Move(Directions direction, int32_t* score) const {
+  const RowTables& tables = RowTables::Get(kLength);
+  bool is_vertical = direction == Directions::kUp
+      || direction == Directions::kDown;
+  bool is_left = direction == Directions::kLeft
+      || direction == Directions::kUp;
+  if (direction == Directions::kNone)
+    return *this;
+  Board board = is_vertical ? Transposed() : *this;
+  uint64_t moved = 0;
+  for (int32_t i = 0; i < kLength; i++) {
+    uint16_t row = board.GetRow(i);
+    uint16_t moved_row = is_left ? tables.MoveLeft(row)
+                                 : tables.MoveRight(row);
+    moved |= static_cast<uint64_t>(moved_row) << (16 * i);
+    if (score)
+      *score += tables.GetScore(row);
+  }
+  return is_vertical ? Board(moved).Transposed() : Board(moved);
+}
+
+/* the product sums all nibbles into the top one, which overflows only when
+ * all 16 cells are empty */
+int32_t Board::CountEmpty() const {
+  uint64_t empty = GetEmptyMask();
+  return empty == kNibbleOnes ? 16 : (empty * kNibbleOnes) >> 60;
+}
+
+int32_t Board::GetEmptyCell(int32_t number) const {
+  static const FindBitFunction find_bit = SelectFindBit();
+  return find_bit(GetEmptyMask(), number) / 4;
+}
+
+Tiles Board::GetMaxTile() const {
+  uint64_t max_tile = 0;
+  for (uint64_t cells = cells_; cells; cells >>= 4)
+    if ((cells & 0xF) > max_tile)
+      max_tile = cells & 0xF;
+  return static_cast<Tiles>(max_tile);
+}
@@ -0,0 +1,74 @@
+#ifndef _2048_AI_BOARD_H_
+#define _2048_AI_BOARD_H_
+
+#include "logic/logic.h"
+#include "display/display.h"
+
+#include <cstdint>
+#include <vector>
+
+/* 4x4 board packed into 64 bits: one nibble per cell holding a Tiles value,
+ * row i occupies bits [16 * i, 16 * i + 16), column j of a row is nibble j. */
+class Board {
+ public:
+  static constexpr int32_t kLength = 4;
+  static constexpr int32_t kRowsNumber = 1 << 16;
+
+  Board() : cells_(0) {}
+
+  explicit Board(uint64_t cells) : cells_(cells) {}
+
+  static Board FromMatrix(
+      const std::vector<std::vector<Logic::TileInfo>>& matrix);
+
+  uint64_t GetCells() const {
+    return cells_;
+  }
+
+  uint16_t GetRow(int32_t row_idx) const {
+    return static_cast<uint16_t>(cells_ >> (16 * row_idx));
+  }
+
+  Tiles GetTile(int32_t row_idx, int32_t column_idx) const {
+    return static_cast<Tiles>((cells_ >> Shift(row_idx, column_idx)) & 0xF);
+  }
+
+  void SetTile(int32_t row_idx, int32_t column_idx, Tiles tile);
+
+  Board Transposed() const;
+
+  Board Move(Directions direction, int32_t* score = nullptr) const;
+
+  int32_t CountEmpty() const;
+
+  /* cell 4 * row + column of the number-th empty cell in row-major order,
+   * number must be less than CountEmpty() */
+  int32_t GetEmptyCell(int32_t number) const;
+
+  Tiles GetMaxTile() const;
+
+  bool operator==(const Board& other) const {
+    return cells_ == other.cells_;
+  }
+
+  bool operator!=(const Board& other) const {
+    return cells_ != other.cells_;
+  }
+
+ private:
+  static constexpr uint64_t kNibbleOnes = 0x1111111111111111ULL;
+
+  static int32_t Shift(int32_t row_idx, int32_t column_idx) {
+    return 16 * row_idx + 4 * column_idx;
+  }
+
+  /* the lowest bit of every empty cell's nibble */
+  uint64_t GetEmptyMask() const {
+    uint64_t cells = cells_ | cells_ >> 2;
+    return ~(cells | cells >> 1) & kNibbleOnes;
+  }
+
+  uint64_t cells_;
+};
+
+#endif
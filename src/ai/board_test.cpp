@@ -0,0 +1,41 @@
+#include "ai/board.h"
+#include "ai/sliced_board.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+
+/* run once per GAME2048_ISA level, see CMakeLists.txt: whichever kernel the
+ * level selects has to agree with these cell by cell references */
+
+TEST(BoardTest, GetEmptyCellFindsNumberedEmptyCell) {
+  std::mt19937_64 rng(1);
+  for (int32_t k = 0; k < 20000; k++) {
+    /* mostly empty boards through mostly full ones */
+    uint64_t cells = rng() & rng() & (k % 2 ? rng() : ~0ULL);
+    Board board(cells);
+    int32_t number = 0;
+    for (int32_t cell = 0; cell < 16; cell++) {
+      if ((cells >> (4 * cell)) & 0xF)
+        continue;
+      ASSERT_EQ(cell, board.GetEmptyCell(number++)) << std::hex << cells;
+    }
+    ASSERT_EQ(number, board.CountEmpty()) << std::hex << cells;
+  }
+}
+
+TEST(BoardTest, SlicedBoardRoundTrips) {
+  std::mt19937_64 rng(1);
+  for (int32_t k = 0; k < 20000; k++) {
+    Board board(rng());
+    SlicedBoard sliced(board);
+    for (int32_t bit = 0; bit < SlicedBoard::kPlanesNumber; bit++) {
+      uint16_t plane = 0;
+      for (int32_t cell = 0; cell < 16; cell++)
+        plane |= ((board.GetCells() >> (4 * cell + bit)) & 1) << cell;
+      ASSERT_EQ(plane, sliced.GetPlane(bit)) << std::hex << board.GetCells();
+    }
+    ASSERT_EQ(board, sliced.ToBoard());
+  }
+}
@@ -0,0 +1,62 @@
+#include "ai/heuristic.h"
+#include "ai/board.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+Heuristic::Heuristic(const Weights& weights)
+    : weights_(weights)
+    , row_scores_(Board::kRowsNumber) {
+  for (int32_t row = 0; row < Board::kRowsNumber; row++)
+    row_scores_[row] = EvaluateRow(row);
+}
+
+double Heuristic::EvaluateRow(uint16_t row) const {
+  int32_t cells[Board::kLength];
+  for (int32_t i = 0; i < Board::kLength; i++)
+    cells[i] = (row >> (4 * i)) & 0xF;
+
+  double sum = 0;
+  int32_t empty = 0, merges = 0, previous = 0, counter = 0;
+  for (int32_t i = 0; i < Board::kLength; i++) {
+    sum += std::pow(cells[i], weights_.sum_power);
+    if (!cells[i]) {
+      empty++;
+      continue;
+    }
+    if (previous == cells[i]) {
+      counter++;
+    } else if (counter > 0) {
+      merges += 1 + counter;
+      counter = 0;
+    }
+    previous = cells[i];
+  }
+  if (counter > 0)
+    merges += 1 + counter;
+
+  double monotonicity_left = 0, monotonicity_right = 0;
+  for (int32_t i = 1; i < Board::kLength; i++) {
+    double previous_power = std::pow(cells[i - 1], weights_.monotonicity_power);
+    double current_power = std::pow(cells[i], weights_.monotonicity_power);
+    if (cells[i - 1] > cells[i])
+      monotonicity_left += previous_power - current_power;
+    else
+      monotonicity_right += current_power - previous_power;
+  }
+
+  return weights_.lost_penalty + weights_.empty * empty
+      + weights_.merges * merges
+      - weights_.monotonicity * std::min(monotonicity_left, monotonicity_right)
+      - weights_.sum * sum;
+}
+
+double Heuristic::Evaluate(Board board) const {
+  Board transposed = board.Transposed();
+  double score = 0;
+  for (int32_t i = 0; i < Board::kLength; i++)
+    score += row_scores_[board.GetRow(i)] + row_scores_[transposed.GetRow(i)];
+  return score;
+}
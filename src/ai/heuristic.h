@@ -0,0 +1,37 @@
+#ifndef _2048_AI_HEURISTIC_H_
+#define _2048_AI_HEURISTIC_H_
+
+#include "ai/board.h"
+
+#include <vector>
+
+class Heuristic {
+ public:
+  struct Weights {
+    double lost_penalty = 200000;
+    double monotonicity_power = 4;
+    double monotonicity = 47;
+    double sum_power = 3.5;
+    double sum = 11;
+    double merges = 700;
+    double empty = 270;
+  };
+
+  Heuristic() : Heuristic(Weights()) {}
+
+  explicit Heuristic(const Weights& weights);
+
+  const Weights& GetWeights() const {
+    return weights_;
+  }
+
+  double Evaluate(Board board) const;
+
+ private:
+  double EvaluateRow(uint16_t row) const;
+
+  Weights weights_;
+  std::vector<float> row_scores_;
+};
+
+#endif
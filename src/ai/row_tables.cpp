@@ -0,0 +1,56 @@
+#include "ai/row_tables.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+RowTables::RowTables(int32_t length)
+    : length_(length) {
+  if (length < 1 || length > kMaxLength)
+    throw std::runtime_error("row tables support rows of 1 to 4 cells");
+  int32_t rows_number = 1 << (4 * length);
+  left_.resize(rows_number);
+  right_.resize(rows_number);
+  score_.resize(rows_number);
+  for (int32_t row = 0; row < rows_number; row++) {
+    int32_t cells[kMaxLength], result[kMaxLength] = {0};
+    for (int32_t i = 0; i < length; i++)
+      cells[i] = (row >> (4 * i)) & 0xF;
+    int32_t to = 0, row_score = 0;
+    for (int32_t from = 0; from < length; from++) {
+      if (!cells[from])
+        continue;
+      if (result[to] == cells[from] && result[to] < 0xF) {
+        result[to]++;
+        row_score += 1 << (result[to] - 1);
+        to++;
+      } else {
+        if (result[to])
+          to++;
+        result[to] = cells[from];
+      }
+    }
+    uint16_t moved = 0;
+    for (int32_t i = 0; i < length; i++)
+      moved |= result[i] << (4 * i);
+    left_[row] = moved;
+    score_[row] = row_score;
+    right_[ReverseRow(row)] = ReverseRow(moved);
+  }
+}
+
+uint16_t RowTables::ReverseRow(uint16_t row) const {
+  uint16_t reversed = 0;
+  for (int32_t i = 0; i < length_; i++)
+    reversed |= ((row >> (4 * i)) & 0xF) << (4 * (length_ - 1 - i));
+  return reversed;
+}
+
+const RowTables& RowTables::Get(int32_t length) {
+  static const RowTables tables[kMaxLength] = {
+    RowTables(1), RowTables(2), RowTables(3), RowTables(4),
+  };
+  if (length < 1 || length > kMaxLength)
+    throw std::runtime_error("row tables support rows of 1 to 4 cells");
+  return tables[length - 1];
+}
@@ -0,0 +1,44 @@
+#ifndef _2048_AI_ROW_TABLES_H_
+#define _2048_AI_ROW_TABLES_H_
+
+#include <cstdint>
+#include <vector>
+
+/* Results of moving every packed row (one nibble per cell, cell 0 in the
+ * lowest nibble) of the given length to the left and to the right. */
+class RowTables {
+ public:
+  static constexpr int32_t kMaxLength = 4;
+
+  explicit RowTables(int32_t length);
+
+  /* shared tables, built on first use */
+  static const RowTables& Get(int32_t length);
+
+  int32_t GetLength() const {
+    return length_;
+  }
+
+  uint16_t MoveLeft(uint16_t row) const {
+    return left_[row];
+  }
+
+  uint16_t MoveRight(uint16_t row) const {
+    return right_[row];
+  }
+
+  /* sum of merged tile values, equal for both directions */
+  int32_t GetScore(uint16_t row) const {
+    return score_[row];
+  }
+
+ private:
+  uint16_t ReverseRow(uint16_t row) const;
+
+  int32_t length_;
+  std::vector<uint16_t> left_;
+  std::vector<uint16_t> right_;
+  std::vector<int32_t> score_;
+};
+
+#endif
@@ -0,0 +1,170 @@
+#include "ai/search.h"
+#include "ai/board.h"
+#include "ai/heuristic.h"
+#include "ai/transposition_table.h"
+#include "logic/logic.h"
+#include "logic/spawn_distribution.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+constexpr Directions Search::kMoves[];
+
+Search::Search(const Heuristic::Weights& weights, const Options& options)
+    : Search(weights, options,
+             std::make_shared<TranspositionTable>(options.table_size_log2)) {}
+
+Search::Search(const Heuristic::Weights& weights, const Options& options,
+               std::shared_ptr<TranspositionTable> table)
+    : heuristic_(weights)
+    , options_(options)
+    , table_(std::move(table))
+    , root_depth_(0)
+    , time_out_(false)
+    , cancel_(nullptr) {
+  if (!table_)
+    throw std::runtime_error("search needs a transposition table");
+  for (double& value : move_values_)
+    value = -1;
+}
+
+double Search::GetMoveValue(Directions direction) const {
+  for (int32_t k = 0; k < kMovesNumber; k++)
+    if (kMoves[k] == direction)
+      return move_values_[k];
+  return -1;
+}
+
+bool Search::IsCancelled() const {
+  return cancel_ && cancel_->load(std::memory_order_relaxed);
+}
+
+bool Search::IsTimeOut() {
+  if (time_out_)
+    return true;
+  if (!statistics_.completed_depth || (statistics_.nodes & kTimeCheckMask))
+    return false;
+  if (IsCancelled())
+    time_out_ = true;
+  else if (options_.time_budget_us)
+    time_out_ = Clock::now() >= deadline_;
+  return time_out_;
+}
+
+double Search::ChanceNode(Board board, int32_t depth, double probability) {
+  if (board.GetMaxTile() == Tiles::kTile_2048)
+    return kWinValue;
+  if (!depth)
+    return heuristic_.Evaluate(board);
+  if (probability < options_.probability_threshold) {
+    statistics_.probability_cuts++;
+    return heuristic_.Evaluate(board);
+  }
+
+  uint64_t cells = board.GetCells();
+  float stored;
+  if (table_->Probe(cells, depth, &stored)) {
+    statistics_.table_hits++;
+    return stored;
+  }
+
+  int32_t empty[Board::kLength * Board::kLength], count = 0;
+  for (int32_t i = 0; i < Board::kLength; i++)
+    for (int32_t j = 0; j < Board::kLength; j++)
+      if (board.GetTile(i, j) == Tiles::kNoTile)
+        empty[count++] = i * Board::kLength + j;
+
+  int32_t children = count;
+  if (options_.sampled_cells && count > options_.sampled_cells
+      && root_depth_ - depth >= options_.sampling_ply) {
+    children = options_.sampled_cells;
+    statistics_.sampled_out_cells += count - children;
+  }
+  int32_t offset = (TranspositionTable::Hash(cells) >> 32) % count;
+  double cell_probability = probability / count, sum = 0;
+  for (int32_t k = 0; k < children; k++) {
+    int32_t cell = empty[(offset + k * count / children) % count];
+    for (const auto& spawn : options_.spawns.GetOutcomes()) {
+      Board child = board;
+      child.SetTile(cell / Board::kLength, cell % Board::kLength, spawn.tile);
+      sum += spawn.probability
+          * MaxNode(child, depth - 1, cell_probability * spawn.probability);
+      if (time_out_)
+        return 0;
+    }
+  }
+  double value = sum / children;
+  table_->Store(cells, depth, static_cast<float>(value));
+  return value;
+}
+
+double Search::MaxNode(Board board, int32_t depth, double probability) {
+  statistics_.nodes++;
+  if (IsTimeOut())
+    return 0;
+  double best = 0;
+  for (Directions direction : kMoves) {
+    Board moved = board.Move(direction);
+    if (moved == board)
+      continue;
+    double value = ChanceNode(moved, depth, probability);
+    if (time_out_)
+      return 0;
+    if (value > best)
+      best = value;
+  }
+  return best;
+}
+
+Directions Search::SearchRoot(Board board, int32_t depth,
+                              double values[kMovesNumber]) {
+  root_depth_ = depth;
+  Directions best_move = Directions::kNone;
+  double best = -1;
+  for (int32_t k = 0; k < kMovesNumber; k++) {
+    values[k] = -1;
+    Board moved = board.Move(kMoves[k]);
+    if (moved == board)
+      continue;
+    values[k] = ChanceNode(moved, depth, 1);
+    if (time_out_)
+      return Directions::kNone;
+    if (values[k] > best) {
+      best = values[k];
+      best_move = kMoves[k];
+    }
+  }
+  return best_move;
+}
+
+Directions Search::ChooseMove(Board board) {
+  statistics_ = Statistics();
+  int32_t budget_us = options_.time_budget_us
+      - options_.time_budget_us / kDeadlineMarginFraction;
+  deadline_ = Clock::now() + std::chrono::microseconds(budget_us);
+  time_out_ = false;
+
+  Directions best_move = Directions::kNone;
+  for (double& value : move_values_)
+    value = -1;
+  for (int32_t depth = 1; depth <= options_.max_depth; depth++) {
+    double values[kMovesNumber];
+    Directions move = SearchRoot(board, depth, values);
+    if (time_out_)
+      break;
+    best_move = move;
+    std::copy(values, values + kMovesNumber, move_values_);
+    statistics_.completed_depth = depth;
+    if (move == Directions::kNone)
+      break;
+    if (IsCancelled()
+        || (options_.time_budget_us && Clock::now() >= deadline_))
+      break;
+  }
+  return best_move;
+}
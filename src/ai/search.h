@@ -0,0 +1,99 @@
+#ifndef _2048_AI_SEARCH_H_
+#define _2048_AI_SEARCH_H_
+
+#include "ai/board.h"
+#include "ai/heuristic.h"
+#include "ai/transposition_table.h"
+#include "logic/logic.h"
+#include "logic/spawn_distribution.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+/* Expectimax with iterative deepening: every ChooseMove searches depth 1, 2,
+ * ... until max_depth or the time budget runs out and returns the best move
+ * of the last fully completed depth. */
+class Search {
+ public:
+  struct Options {
+    int32_t max_depth = 8;
+    /* zero means no time limit, only max_depth */
+    int32_t time_budget_us = 5000;
+    int32_t table_size_log2 = 20;
+    /* chance node reached with lower probability is evaluated statically */
+    double probability_threshold = 0.0001;
+    /* at plies >= sampling_ply at most sampled_cells empty cells (spread
+     * evenly over the board) get a spawn, zero disables sampling */
+    int32_t sampling_ply = 3;
+    int32_t sampled_cells = 0;
+    /* has to match the game; every outcome is a chance node child */
+    SpawnDistribution spawns;
+  };
+
+  struct Statistics {
+    int64_t nodes = 0;
+    int64_t table_hits = 0;
+    int64_t probability_cuts = 0;
+    int64_t sampled_out_cells = 0;
+    int32_t completed_depth = 0;
+  };
+
+  static constexpr double kWinValue = 1e9;
+
+  Search() : Search(Heuristic::Weights(), Options()) {}
+
+  Search(const Heuristic::Weights& weights, const Options& options);
+
+  /* searches built with the same weights may share one table, then
+   * table_size_log2 of the options is ignored */
+  Search(const Heuristic::Weights& weights, const Options& options,
+         std::shared_ptr<TranspositionTable> table);
+
+  Directions ChooseMove(Board board);
+
+  /* expected value of the move at the last completed depth of the last
+   * ChooseMove, negative for a move that does not change the board */
+  double GetMoveValue(Directions direction) const;
+
+  /* once the flag is raised the running ChooseMove returns the move of the
+   * last completed depth as if its time budget had run out */
+  void SetCancelFlag(const std::atomic<bool>* cancel) {
+    cancel_ = cancel;
+  }
+
+  const Statistics& GetStatistics() const {
+    return statistics_;
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr int64_t kTimeCheckMask = (1 << 6) - 1;
+  /* part of the budget reserved for unwinding after the deadline is hit */
+  static constexpr int32_t kDeadlineMarginFraction = 32;
+  static constexpr int32_t kMovesNumber = 4;
+  static constexpr Directions kMoves[kMovesNumber] = {
+    Directions::kLeft, Directions::kRight, Directions::kUp, Directions::kDown,
+  };
+
+  Directions SearchRoot(Board board, int32_t depth,
+                        double values[kMovesNumber]);
+  double MaxNode(Board board, int32_t depth, double probability);
+  double ChanceNode(Board board, int32_t depth, double probability);
+  bool IsTimeOut();
+  bool IsCancelled() const;
+
+  Heuristic heuristic_;
+  Options options_;
+  Statistics statistics_;
+  std::shared_ptr<TranspositionTable> table_;
+  double move_values_[kMovesNumber];
+  int32_t root_depth_;
+  Clock::time_point deadline_;
+  bool time_out_;
+  const std::atomic<bool>* cancel_;
+};
+
+#endif
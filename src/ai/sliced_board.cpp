@@ -0,0 +1,111 @@
+#include "ai/sliced_board.h"
+#include "ai/board.h"
+#include "cpu/cpu.h"
+#include "display/display.h"
+
+#include <cstdint>
+
+#ifdef GAME2048_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr uint64_t kNibbleBits = 0x1111111111111111ULL;
+
+/* plane k gathers bit k of every cell nibble */
+struct SliceFunctions {
+  uint64_t (*slice)(uint64_t cells);
+  uint64_t (*unslice)(uint64_t planes);
+};
+
+/* packs bits 0, 4, 8, ..., 60 into the low 16 bits */
+uint64_t CompressNibbles(uint64_t bits) {
+  bits &= kNibbleBits;
+  bits = (bits | bits >> 3) & 0x0303030303030303ULL;
+  bits = (bits | bits >> 6) & 0x000F000F000F000FULL;
+  bits = (bits | bits >> 12) & 0x000000FF000000FFULL;
+  return (bits | bits >> 24) & 0xFFFFULL;
+}
+
+/* spreads the low 16 bits back to bits 0, 4, 8, ..., 60 */
+uint64_t SpreadNibbles(uint64_t bits) {
+  bits &= 0xFFFFULL;
+  bits = (bits | bits << 24) & 0x000000FF000000FFULL;
+  bits = (bits | bits << 12) & 0x000F000F000F000FULL;
+  bits = (bits | bits << 6) & 0x0303030303030303ULL;
+  return (bits | bits << 3) & kNibbleBits;
+}
+
+uint64_t Slice(uint64_t cells) {
+  uint64_t planes = 0;
+  for (int32_t bit = 0; bit < SlicedBoard::kPlanesNumber; bit++)
+    planes |= CompressNibbles(cells >> bit) << (16 * bit);
+  return planes;
+}
+
+uint64_t Unslice(uint64_t planes) {
+  uint64_t cells = 0;
+  for (int32_t bit = 0; bit < SlicedBoard::kPlanesNumber; bit++)
+    cells |= SpreadNibbles(planes >> (16 * bit)) << bit;
+  return cells;
+}
+
+#ifdef GAME2048_X86
+
+__attribute__((target("bmi2")))
+uint64_t SliceBmi2(uint64_t cells) {
+  uint64_t planes = 0;
+  for (int32_t bit = 0; bit < SlicedBoard::kPlanesNumber; bit++)
+    planes |= _pext_u64(cells, kNibbleBits << bit) << (16 * bit);
+  return planes;
+}
+
+__attribute__((target("bmi2")))
+uint64_t UnsliceBmi2(uint64_t planes) {
+  uint64_t cells = 0;
+  for (int32_t bit = 0; bit < SlicedBoard::kPlanesNumber; bit++)
+    cells |= _pdep_u64(planes >> (16 * bit), kNibbleBits << bit);
+  return cells;
+}
+
+#endif
+
+SliceFunctions SelectSliceFunctions() {
+#ifdef GAME2048_X86
+  if (HasFastBmi2())
+    return {SliceBmi2, UnsliceBmi2};
+#endif
+  return {Slice, Unslice};
+}
+
+const SliceFunctions& GetSliceFunctions() {
+  static const SliceFunctions functions = SelectSliceFunctions();
+  return functions;
+}
+
+}  // namespace
+
+constexpr int32_t SlicedBoard::kPlanesNumber;
+constexpr uint64_t SlicedBoard::kNotLastColumn;
+constexpr uint64_t SlicedBoard::kNotLastRow;
+
+SlicedBoard::SlicedBoard(const Board& board)
+    : planes_(GetSliceFunctions().slice(board.GetCells())) {}
+
+Board SlicedBoard::ToBoard() const {
+  return Board(GetSliceFunctions().unslice(planes_));
+}
+
+/* from the lowest bit up, a cell stays at least tile while its bit beats
+ * the tile bit, or ties and the lower bits already were at least */
+uint16_t SlicedBoard::GetAtLeast(Tiles tile) const {
+  uint16_t at_least = 0xFFFF;
+  for (int32_t bit = 0; bit < kPlanesNumber; bit++) {
+    if ((static_cast<int32_t>(tile) >> bit) & 1)
+      at_least &= GetPlane(bit);
+    else
+      at_least |= GetPlane(bit);
+  }
+  return at_least;
+}
@@ -0,0 +1,65 @@
+#ifndef _2048_AI_SLICED_BOARD_H_
+#define _2048_AI_SLICED_BOARD_H_
+
+#include "ai/board.h"
+#include "display/display.h"
+
+#include <cstdint>
+
+/* 4x4 board sliced into bitplanes: bit c of plane k is bit k of the Tiles
+ * value of cell c = 4 * row + column. The four 16-bit planes share one
+ * 64-bit word, plane k at bits [16 * k, 16 * k + 16), so every query below
+ * is a handful of bitwise operations for the whole board and answers with
+ * a 16-bit mask of cells. */
+class SlicedBoard {
+ public:
+  static constexpr int32_t kPlanesNumber = 4;
+
+  SlicedBoard() : planes_(0) {}
+
+  explicit SlicedBoard(const Board& board);
+
+  Board ToBoard() const;
+
+  uint16_t GetPlane(int32_t bit) const {
+    return static_cast<uint16_t>(planes_ >> (16 * bit));
+  }
+
+  uint16_t GetOccupied() const {
+    return Fold(planes_);
+  }
+
+  /* cells holding tile or a bigger one */
+  uint16_t GetAtLeast(Tiles tile) const;
+
+  /* cells equal to their right neighbour, the last column never is */
+  uint16_t GetEqualRight() const {
+    return ~Fold((planes_ ^ (planes_ >> 1)) & kNotLastColumn)
+        & static_cast<uint16_t>(kNotLastColumn);
+  }
+
+  /* cells equal to the cell below, the last row never is */
+  uint16_t GetEqualDown() const {
+    return ~Fold((planes_ ^ (planes_ >> 4)) & kNotLastRow)
+        & static_cast<uint16_t>(kNotLastRow);
+  }
+
+  /* occupied cells merging with the neighbour to the right or below */
+  uint16_t GetMergeable() const {
+    return (GetEqualRight() | GetEqualDown()) & GetOccupied();
+  }
+
+ private:
+  static constexpr uint64_t kNotLastColumn = 0x7777777777777777ULL;
+  static constexpr uint64_t kNotLastRow = 0x0FFF0FFF0FFF0FFFULL;
+
+  /* a cell is set if it is set in any plane */
+  static uint16_t Fold(uint64_t planes) {
+    return static_cast<uint16_t>(planes | planes >> 16 | planes >> 32
+                                 | planes >> 48);
+  }
+
+  uint64_t planes_;
+};
+
+#endif
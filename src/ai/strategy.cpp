@@ -0,0 +1,80 @@
+#include "ai/strategy.h"
+#include "ai/board.h"
+#include "ai/heuristic.h"
+#include "ai/search.h"
+#include "logic/logic.h"
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr Directions kMoves[] = {
+  Directions::kLeft, Directions::kRight, Directions::kUp, Directions::kDown,
+};
+
+constexpr Directions kCornerOrder[] = {
+  Directions::kLeft, Directions::kDown, Directions::kRight, Directions::kUp,
+};
+
+}  // namespace
+
+Directions GreedyStrategy::ChooseMove(const Board& board) {
+  Directions best_move = Directions::kNone;
+  double best = 0;
+  for (Directions direction : kMoves) {
+    Board moved = board.Move(direction);
+    if (moved == board)
+      continue;
+    double value = heuristic_.Evaluate(moved);
+    if (best_move == Directions::kNone || value > best) {
+      best = value;
+      best_move = direction;
+    }
+  }
+  return best_move;
+}
+
+Directions CornerStrategy::ChooseMove(const Board& board) {
+  for (Directions direction : kCornerOrder)
+    if (board.Move(direction) != board)
+      return direction;
+  return Directions::kNone;
+}
+
+Directions RandomStrategy::ChooseMove(const Board& board) {
+  Directions legal[4];
+  int32_t count = 0;
+  for (Directions direction : kMoves)
+    if (board.Move(direction) != board)
+      legal[count++] = direction;
+  return count ? legal[rng_() % count] : Directions::kNone;
+}
+
+StrategyFactory GetStrategyFactory(const std::string& name,
+                                   const Heuristic::Weights& weights,
+                                   const Search::Options& options) {
+  if (name == "expectimax") {
+    return [weights, options] {
+      return std::unique_ptr<Strategy>(new SearchStrategy(weights, options));
+    };
+  }
+  if (name == "greedy") {
+    return [weights] {
+      return std::unique_ptr<Strategy>(new GreedyStrategy(weights));
+    };
+  }
+  if (name == "corner") {
+    return [] {
+      return std::unique_ptr<Strategy>(new CornerStrategy());
+    };
+  }
+  if (name == "random") {
+    return [] {
+      return std::unique_ptr<Strategy>(new RandomStrategy(0));
+    };
+  }
+  throw std::runtime_error("unknown strategy " + name);
+}
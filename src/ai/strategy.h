@@ -0,0 +1,109 @@
+#ifndef _2048_AI_STRATEGY_H_
+#define _2048_AI_STRATEGY_H_
+
+#include "ai/board.h"
+#include "ai/heuristic.h"
+#include "ai/search.h"
+#include "logic/logic.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+
+/* Source of moves for the engine autoplay, the simulator and the bots.
+ * ChooseMove returns kNone only when no move changes the board. */
+class Strategy {
+ public:
+  virtual ~Strategy() {}
+
+  virtual Directions ChooseMove(const Board& board) = 0;
+
+  virtual std::string GetName() const = 0;
+
+  /* called before every game, randomized strategies reseed from the game
+   * seed so that results do not depend on which thread played the game */
+  virtual void Reset(uint64_t seed) {}
+
+  /* strategies that think for a while return early once the flag is raised */
+  virtual void SetCancelFlag(const std::atomic<bool>* cancel) {}
+};
+
+/* strategies keep per-game state, so every thread makes its own */
+using StrategyFactory = std::function<std::unique_ptr<Strategy>()>;
+
+class SearchStrategy : public Strategy {
+ public:
+  SearchStrategy(const Heuristic::Weights& weights,
+                 const Search::Options& options)
+      : search_(weights, options) {}
+
+  Directions ChooseMove(const Board& board) override {
+    return search_.ChooseMove(board);
+  }
+
+  std::string GetName() const override {
+    return "expectimax";
+  }
+
+  void SetCancelFlag(const std::atomic<bool>* cancel) override {
+    search_.SetCancelFlag(cancel);
+  }
+
+ private:
+  Search search_;
+};
+
+/* the move whose result the heuristic likes most, without looking ahead */
+class GreedyStrategy : public Strategy {
+ public:
+  explicit GreedyStrategy(const Heuristic::Weights& weights)
+      : heuristic_(weights) {}
+
+  Directions ChooseMove(const Board& board) override;
+
+  std::string GetName() const override {
+    return "greedy";
+  }
+
+ private:
+  Heuristic heuristic_;
+};
+
+/* the first move in the fixed order left, down, right, up that changes the
+ * board, which keeps the big tiles in the bottom left corner */
+class CornerStrategy : public Strategy {
+ public:
+  Directions ChooseMove(const Board& board) override;
+
+  std::string GetName() const override {
+    return "corner";
+  }
+};
+
+class RandomStrategy : public Strategy {
+ public:
+  explicit RandomStrategy(uint64_t seed) : rng_(seed) {}
+
+  Directions ChooseMove(const Board& board) override;
+
+  std::string GetName() const override {
+    return "random";
+  }
+
+  void Reset(uint64_t seed) override {
+    rng_.seed(seed);
+  }
+
+ private:
+  std::mt19937_64 rng_;
+};
+
+/* factory by name: expectimax, greedy, corner or random */
+StrategyFactory GetStrategyFactory(const std::string& name,
+                                   const Heuristic::Weights& weights,
+                                   const Search::Options& options);
+
+#endif
@@ -0,0 +1,36 @@
+#include "ai/transposition_table.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+TranspositionTable::TranspositionTable(int32_t size_log2)
+    : size_log2_(size_log2) {
+  if (size_log2 < 1 || size_log2 > 40)
+    throw std::runtime_error("transposition table size is out of range");
+  entries_ = std::vector<Entry>(static_cast<size_t>(1) << size_log2);
+}
+
+bool TranspositionTable::Probe(uint64_t cells, int32_t depth,
+                               float* value) const {
+  const Entry& entry = entries_[GetIndex(cells)];
+  uint64_t data = entry.data.load(std::memory_order_relaxed);
+  uint64_t check = entry.check.load(std::memory_order_relaxed);
+  /* an empty entry has zero depth and never satisfies a probe */
+  if ((check ^ data) != cells || static_cast<int32_t>(data >> 32) < depth)
+    return false;
+  uint32_t bits = static_cast<uint32_t>(data);
+  std::memcpy(value, &bits, sizeof(bits));
+  return true;
+}
+
+void TranspositionTable::Store(uint64_t cells, int32_t depth, float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  uint64_t data = static_cast<uint64_t>(depth) << 32 | bits;
+  Entry& entry = entries_[GetIndex(cells)];
+  entry.data.store(data, std::memory_order_relaxed);
+  entry.check.store(cells ^ data, std::memory_order_relaxed);
+}
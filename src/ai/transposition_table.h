@@ -0,0 +1,39 @@
+#ifndef _2048_AI_TRANSPOSITION_TABLE_H_
+#define _2048_AI_TRANSPOSITION_TABLE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* Direct-mapped table of chance node values that may be shared by searches
+ * running on different threads. Entries are written without locks: the key
+ * is stored xor-ed with the data word, so an entry torn by a concurrent
+ * store fails the check on probe instead of returning a wrong value. */
+class TranspositionTable {
+ public:
+  explicit TranspositionTable(int32_t size_log2);
+
+  bool Probe(uint64_t cells, int32_t depth, float* value) const;
+
+  void Store(uint64_t cells, int32_t depth, float value);
+
+  static uint64_t Hash(uint64_t cells) {
+    return cells * 0x9E3779B97F4A7C15ULL;
+  }
+
+ private:
+  struct Entry {
+    std::atomic<uint64_t> check;
+    std::atomic<uint64_t> data;
+  };
+
+  size_t GetIndex(uint64_t cells) const {
+    return Hash(cells) >> (64 - size_log2_);
+  }
+
+  int32_t size_log2_;
+  std::vector<Entry> entries_;
+};
+
+#endif
@@ -0,0 +1,4 @@
+#include "ai/wide_board.h"
+
+template class WideBoard<5>;
+template class WideBoard<6>;
@@ -0,0 +1,99 @@
+#ifndef _2048_AI_WIDE_BOARD_H_
+#define _2048_AI_WIDE_BOARD_H_
+
+#include "ai/wide_row_tables.h"
+#include "display/display.h"
+#include "logic/logic.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/* Length x Length board for 5 and 6, the wide counterpart of Board: one
+ * packed row of nibbles per row, moved by WideRowTables lookups. Columns are
+ * gathered into packed rows for vertical moves. */
+template <int32_t Length>
+class WideBoard {
+ public:
+  static constexpr int32_t kLength = Length;
+
+  WideBoard() : rows_() {}
+
+  static WideBoard FromMatrix(
+      const std::vector<std::vector<Logic::TileInfo>>& matrix) {
+    WideBoard board;
+    for (int32_t i = 0; i < Length; i++)
+      for (int32_t j = 0; j < Length; j++)
+        board.SetTile(i, j, matrix[i][j].value);
+    return board;
+  }
+
+  uint32_t GetRow(int32_t row_idx) const {
+    return rows_[row_idx];
+  }
+
+  Tiles GetTile(int32_t row_idx, int32_t column_idx) const {
+    return static_cast<Tiles>((rows_[row_idx] >> (4 * column_idx)) & 0xF);
+  }
+
+  void SetTile(int32_t row_idx, int32_t column_idx, Tiles tile) {
+    rows_[row_idx] &= ~(0xFU << (4 * column_idx));
+    rows_[row_idx] |= static_cast<uint32_t>(tile) << (4 * column_idx);
+  }
+
+  WideBoard Move(Directions direction, int32_t* score = nullptr) const {
+    const WideRowTables& tables = WideRowTables::Get(Length);
+    bool horizontal = direction == Directions::kLeft
+        || direction == Directions::kRight;
+    bool right = direction == Directions::kRight
+        || direction == Directions::kDown;
+    WideBoard lines = horizontal ? *this : Transposed();
+    for (uint32_t& row : lines.rows_) {
+      if (score)
+        *score += tables.GetScore(row);
+      row = right ? tables.MoveRight(row) : tables.MoveLeft(row);
+    }
+    return horizontal ? lines : lines.Transposed();
+  }
+
+  WideBoard Transposed() const {
+    WideBoard transposed;
+    for (int32_t i = 0; i < Length; i++)
+      for (int32_t j = 0; j < Length; j++)
+        transposed.rows_[j] |= ((rows_[i] >> (4 * j)) & 0xF) << (4 * i);
+    return transposed;
+  }
+
+  int32_t CountEmpty() const {
+    int32_t count = 0;
+    for (uint32_t row : rows_)
+      for (int32_t j = 0; j < Length; j++)
+        count += !((row >> (4 * j)) & 0xF);
+    return count;
+  }
+
+  Tiles GetMaxTile() const {
+    uint32_t max_tile = 0;
+    for (uint32_t row : rows_)
+      for (int32_t j = 0; j < Length; j++)
+        if (((row >> (4 * j)) & 0xF) > max_tile)
+          max_tile = (row >> (4 * j)) & 0xF;
+    return static_cast<Tiles>(max_tile);
+  }
+
+  bool operator==(const WideBoard& other) const {
+    return rows_ == other.rows_;
+  }
+
+  bool operator!=(const WideBoard& other) const {
+    return rows_ != other.rows_;
+  }
+
+ private:
+  std::array<uint32_t, Length> rows_;
+};
+
+extern template class WideBoard<5>;
+extern template class WideBoard<6>;
+
+#endif
@@ -0,0 +1,169 @@
+#include "ai/wide_row_tables.h"
+#include "parallel/parallel.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+constexpr char WideRowTables::kMagic[];
+
+namespace {
+
+constexpr size_t kChunkSize = 1 << 14;
+
+}  // namespace
+
+WideRowTables::WideRowTables(int32_t length, const std::string& cache_path)
+    : length_(length)
+    , entries_number_(static_cast<size_t>(1) << (4 * length))
+    , entries_(nullptr)
+    , data_(nullptr)
+    , size_(0) {
+  if (length < kMinLength || length > kMaxLength)
+    throw std::runtime_error("wide row tables support rows of 5 or 6 cells");
+  if (!cache_path.empty() && Map(cache_path))
+    return;
+  Build();
+  if (cache_path.empty())
+    return;
+  Save(cache_path);
+  if (Map(cache_path))
+    memory_ = std::vector<uint32_t>();
+}
+
+WideRowTables::~WideRowTables() {
+  if (data_)
+    munmap(data_, size_);
+}
+
+const WideRowTables& WideRowTables::Get(int32_t length) {
+  if (length < kMinLength || length > kMaxLength)
+    throw std::runtime_error("wide row tables support rows of 5 or 6 cells");
+  static std::string directory = GetCacheDirectory();
+  auto path = [](int32_t length) {
+    return directory.empty() ? directory
+        : directory + "/row_tables_" + std::to_string(length) + ".bin";
+  };
+  /* each length is built only when it is first asked for */
+  if (length == kMinLength) {
+    static const WideRowTables tables(kMinLength, path(kMinLength));
+    return tables;
+  }
+  static const WideRowTables tables(kMaxLength, path(kMaxLength));
+  return tables;
+}
+
+std::string WideRowTables::GetCacheDirectory() {
+  const char* directory = std::getenv("GAME2048_CACHE_DIR");
+  if (!directory || !*directory)
+    return "";
+  mkdir(directory, 0755);
+  return directory;
+}
+
+uint32_t WideRowTables::MakeEntry(uint32_t row, int32_t length) {
+  int32_t result[kMaxLength] = {0};
+  bool merged[kMaxLength] = {false};
+  int32_t to = 0;
+  for (int32_t from = 0; from < length; from++) {
+    int32_t cell = (row >> (4 * from)) & 0xF;
+    if (!cell)
+      continue;
+    if (result[to] == cell && cell < 0xF) {
+      result[to]++;
+      merged[to] = true;
+      to++;
+    } else {
+      if (result[to])
+        to++;
+      result[to] = cell;
+    }
+  }
+  uint32_t entry = 0;
+  for (int32_t i = 0; i < length; i++)
+    entry |= result[i] << (4 * i) | merged[i] << (kMergedShift + i);
+  return entry;
+}
+
+int32_t WideRowTables::GetScore(uint32_t row) const {
+  uint32_t entry = entries_[row];
+  int32_t score = 0;
+  for (int32_t i = 0; i < length_; i++)
+    if (entry >> (kMergedShift + i) & 1)
+      score += 1 << (((entry >> (4 * i)) & 0xF) - 1);
+  return score;
+}
+
+void WideRowTables::Build() {
+  memory_.resize(entries_number_);
+  ParallelFor(entries_number_, kChunkSize, GetThreadsNumber(0),
+              [this](size_t begin, size_t end, int32_t) {
+    for (size_t row = begin; row < end; row++)
+      memory_[row] = MakeEntry(row, length_);
+  });
+  entries_ = memory_.data();
+}
+
+bool WideRowTables::Map(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  size_t expected = sizeof(Header) + entries_number_ * sizeof(uint32_t);
+  struct stat info;
+  if (fstat(fd, &info) || static_cast<size_t>(info.st_size) != expected) {
+    close(fd);
+    return false;
+  }
+  void* data = mmap(nullptr, expected, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+    return false;
+  const Header* header = static_cast<const Header*>(data);
+  if (std::memcmp(header->magic, kMagic, sizeof(kMagic))
+      || header->version != kVersion
+      || header->length != static_cast<uint32_t>(length_)
+      || header->entries_number != entries_number_) {
+    munmap(data, expected);
+    return false;
+  }
+  data_ = data;
+  size_ = expected;
+  entries_ = reinterpret_cast<const uint32_t*>(
+      static_cast<const char*>(data) + sizeof(Header));
+  return true;
+}
+
+/* written aside and renamed, so concurrent runs never map a partial file;
+ * a cache that cannot be written is not an error */
+void WideRowTables::Save(const std::string& path) const {
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.length = length_;
+  header.entries_number = entries_number_;
+
+  std::string temporary = path + ".tmp" + std::to_string(getpid());
+  {
+    std::ofstream out(temporary, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(memory_.data()),
+              memory_.size() * sizeof(uint32_t));
+    if (!out) {
+      std::remove(temporary.c_str());
+      return;
+    }
+  }
+  if (std::rename(temporary.c_str(), path.c_str()))
+    std::remove(temporary.c_str());
+}
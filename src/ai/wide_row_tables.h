@@ -0,0 +1,92 @@
+#ifndef _2048_AI_WIDE_ROW_TABLES_H_
+#define _2048_AI_WIDE_ROW_TABLES_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Left moves of every packed row of 5 or 6 cells (one nibble per cell, cell
+ * 0 in the lowest nibble), 2^20 and 2^24 rows. An entry keeps the moved row
+ * in its low 24 bits and in bit kMergedShift + i whether cell i of the
+ * result is a merge, which is enough for the score and for tile sources;
+ * right moves go through reversed rows. The tables are built in parallel on
+ * first use; when $GAME2048_CACHE_DIR is set they are saved there, and
+ * later runs map the file read-only. */
+class WideRowTables {
+ public:
+  static constexpr int32_t kMinLength = 5;
+  static constexpr int32_t kMaxLength = 6;
+  static constexpr int32_t kMergedShift = 24;
+  static constexpr uint32_t kRowMask = (1U << kMergedShift) - 1;
+
+  /* empty cache_path keeps the table in memory only, a missing or stale
+   * cache file is rebuilt and replaced */
+  WideRowTables(int32_t length, const std::string& cache_path);
+  ~WideRowTables();
+
+  WideRowTables(const WideRowTables&) = delete;
+  WideRowTables& operator=(const WideRowTables&) = delete;
+
+  /* shared tables, cached in GetCacheDirectory() when there is one */
+  static const WideRowTables& Get(int32_t length);
+
+  /* $GAME2048_CACHE_DIR, created if missing, empty if it is not set */
+  static std::string GetCacheDirectory();
+
+  int32_t GetLength() const {
+    return length_;
+  }
+
+  bool IsMapped() const {
+    return data_ != nullptr;
+  }
+
+  uint32_t GetEntry(uint32_t row) const {
+    return entries_[row];
+  }
+
+  uint32_t MoveLeft(uint32_t row) const {
+    return entries_[row] & kRowMask;
+  }
+
+  uint32_t MoveRight(uint32_t row) const {
+    return ReverseRow(MoveLeft(ReverseRow(row)));
+  }
+
+  /* sum of merged tile values, equal for both directions */
+  int32_t GetScore(uint32_t row) const;
+
+  /* nibbles swapped inside each byte, then the bytes of the 24-bit row;
+   * a row of 5 cells ends one nibble too high */
+  uint32_t ReverseRow(uint32_t row) const {
+    uint32_t swapped = (row & 0x0F0F0FU) << 4 | (row >> 4 & 0x0F0F0FU);
+    return __builtin_bswap32(swapped) >> (8 + 4 * (kMaxLength - length_));
+  }
+
+  static uint32_t MakeEntry(uint32_t row, int32_t length);
+
+ private:
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t length;
+    uint64_t entries_number;
+  };
+
+  static constexpr char kMagic[8] = "2048ROW";
+  static constexpr uint32_t kVersion = 1;
+
+  void Build();
+  bool Map(const std::string& path);
+  void Save(const std::string& path) const;
+
+  int32_t length_;
+  size_t entries_number_;
+  std::vector<uint32_t> memory_;
+  const uint32_t* entries_;
+  void* data_;
+  size_t size_;
+};
+
+#endif
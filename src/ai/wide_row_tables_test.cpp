@@ -0,0 +1,40 @@
+#include "ai/wide_row_tables.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+
+namespace {
+
+uint32_t ReverseCells(uint32_t row, int32_t length) {
+  uint32_t reversed = 0;
+  for (int32_t i = 0; i < length; i++)
+    reversed |= ((row >> (4 * i)) & 0xF) << (4 * (length - 1 - i));
+  return reversed;
+}
+
+}  // namespace
+
+TEST(WideRowTablesTest, MoveRightMirrorsMoveLeft) {
+  for (int32_t length : {WideRowTables::kMinLength,
+                         WideRowTables::kMaxLength}) {
+    WideRowTables tables(length, "");
+    uint32_t rows = 1U << (4 * length);
+    /* every row of 5 cells, a sample of the rows of 6 */
+    for (uint32_t row = 0; row < rows; row += length == 5 ? 1 : 97) {
+      ASSERT_EQ(ReverseCells(row, length), tables.ReverseRow(row));
+      ASSERT_EQ(ReverseCells(WideRowTables::MakeEntry(
+                                 ReverseCells(row, length), length)
+                                 & WideRowTables::kRowMask, length),
+                tables.MoveRight(row));
+    }
+  }
+}
+
+TEST(WideRowTablesTest, CacheIsOptIn) {
+  unsetenv("GAME2048_CACHE_DIR");
+  EXPECT_EQ("", WideRowTables::GetCacheDirectory());
+  setenv("GAME2048_CACHE_DIR", "", 1);
+  EXPECT_EQ("", WideRowTables::GetCacheDirectory());
+}
@@ -0,0 +1,147 @@
+#include "analysis/analyzer.h"
+#include "ai/board.h"
+#include "ai/search.h"
+#include "ai/transposition_table.h"
+#include "logic/logic.h"
+#include "parallel/parallel.h"
+#include "replay/replay.h"
+#include "replay/replay_file.h"
+#include "replay/replay_player.h"
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr size_t kChunkSize = 4;
+
+Directions ParseMove(const std::string& name) {
+  for (Directions direction : {Directions::kLeft, Directions::kRight,
+                               Directions::kUp, Directions::kDown})
+    if (name == Analyzer::GetMoveName(direction))
+      return direction;
+  throw std::runtime_error("unknown move " + name);
+}
+
+}  // namespace
+
+Analyzer::Analyzer(const Heuristic::Weights& weights,
+                   const Search::Options& options, int32_t threads_number)
+    : weights_(weights)
+    , options_(options)
+    , threads_number_(GetThreadsNumber(threads_number)) {}
+
+const char* Analyzer::GetMoveName(Directions direction) {
+  switch (direction) {
+    case Directions::kLeft:
+      return "left";
+    case Directions::kRight:
+      return "right";
+    case Directions::kUp:
+      return "up";
+    case Directions::kDown:
+      return "down";
+    default:
+      return "none";
+  }
+}
+
+std::vector<Analyzer::Game> Analyzer::ReadGames(std::istream& in,
+                                                const std::string& name) {
+  std::vector<Game> games;
+  Game game;
+  auto finish_game = [&]() {
+    if (game.positions.empty())
+      return;
+    game.name = name + ":" + std::to_string(games.size());
+    games.push_back(std::move(game));
+    game = Game();
+  };
+
+  std::string line;
+  for (int32_t line_number = 1; std::getline(in, line); line_number++) {
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    std::string cells, move;
+    if (!(fields >> cells)) {
+      finish_game();
+      continue;
+    }
+    if (!(fields >> move))
+      throw std::runtime_error(name + ":" + std::to_string(line_number)
+                               + ": missing move");
+    Position position{Board(std::stoull(cells, nullptr, 16)),
+                      ParseMove(move)};
+    if (position.board.Move(position.played) == position.board)
+      throw std::runtime_error(name + ":" + std::to_string(line_number)
+                               + ": move does not change the board");
+    game.positions.push_back(position);
+  }
+  finish_game();
+  return games;
+}
+
+std::vector<Analyzer::Game> Analyzer::ReadGames(const ReplayFile& file,
+                                                const std::string& name) {
+  std::vector<Game> games;
+  for (size_t i = 0; i < file.GetGamesNumber(); i++) {
+    std::string game_name = name + ":" + std::to_string(i);
+    ReplayPlayer player(file.GetGame(i));
+    const Replay& replay = player.GetReplay();
+    if (replay.rows != Board::kLength || replay.columns != Board::kLength
+        || replay.rule != MergeRules::kPowerOfTwo)
+      throw std::runtime_error(game_name + ": not a 4x4 power of two game");
+    Game game;
+    game.name = game_name;
+    for (const Replay::Turn& turn : replay.turns) {
+      Position position{Board::FromMatrix(player.GetLogic().GetMatrix()),
+                        turn.direction};
+      if (position.board.Move(position.played) == position.board)
+        throw std::runtime_error(game_name + " move "
+                                 + std::to_string(game.positions.size())
+                                 + ": move does not change the board");
+      game.positions.push_back(position);
+      player.Step();
+    }
+    if (!game.positions.empty())
+      games.push_back(std::move(game));
+  }
+  return games;
+}
+
+std::vector<Analyzer::GameReport> Analyzer::Analyze(
+    const std::vector<Game>& games) const {
+  std::vector<GameReport> reports(games.size());
+  std::vector<std::pair<size_t, size_t>> positions;
+  for (size_t i = 0; i < games.size(); i++) {
+    reports[i].name = games[i].name;
+    reports[i].moves.resize(games[i].positions.size());
+    for (size_t j = 0; j < games[i].positions.size(); j++)
+      positions.emplace_back(i, j);
+  }
+
+  auto table = std::make_shared<TranspositionTable>(options_.table_size_log2);
+  std::vector<std::unique_ptr<Search>> searches;
+  for (int32_t k = 0; k < threads_number_; k++)
+    searches.emplace_back(new Search(weights_, options_, table));
+
+  ParallelFor(positions.size(), kChunkSize, threads_number_,
+              [&](size_t begin, size_t end, int32_t thread_idx) {
+    Search& search = *searches[thread_idx];
+    for (size_t k = begin; k < end; k++) {
+      size_t game = positions[k].first, move = positions[k].second;
+      const Position& position = games[game].positions[move];
+      MoveReport& report = reports[game].moves[move];
+      report.best = search.ChooseMove(position.board);
+      report.best_value = search.GetMoveValue(report.best);
+      report.played_value = search.GetMoveValue(position.played);
+    }
+  });
+  return reports;
+}
@@ -0,0 +1,75 @@
+#ifndef _2048_ANALYSIS_ANALYZER_H_
+#define _2048_ANALYSIS_ANALYZER_H_
+
+#include "ai/board.h"
+#include "ai/heuristic.h"
+#include "ai/search.h"
+#include "logic/logic.h"
+#include "replay/replay_file.h"
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+/* Scores every move of recorded games against the search: each position is
+ * searched to a fixed depth and the expected value of the move played is
+ * compared with the best one. Positions of all games are spread over a
+ * thread pool whose searches share one transposition table. */
+class Analyzer {
+ public:
+  struct Position {
+    Board board;
+    Directions played;
+  };
+
+  struct Game {
+    std::string name;
+    std::vector<Position> positions;
+  };
+
+  struct MoveReport {
+    Directions best = Directions::kNone;
+    double best_value = 0;
+    double played_value = 0;
+
+    double GetLoss() const {
+      return best_value - played_value;
+    }
+
+    /* loss as a fraction of the best value */
+    double GetRelativeLoss() const {
+      return best_value > 0 ? GetLoss() / best_value : 0;
+    }
+  };
+
+  struct GameReport {
+    std::string name;
+    std::vector<MoveReport> moves;
+  };
+
+  Analyzer(const Heuristic::Weights& weights, const Search::Options& options,
+           int32_t threads_number);
+
+  std::vector<GameReport> Analyze(const std::vector<Game>& games) const;
+
+  /* Text replay: one position per line, the board as 16 hex digits (as
+   * Board::GetCells) followed by the move played (left, right, up or down).
+   * An empty line separates games, '#' starts a comment. */
+  static std::vector<Game> ReadGames(std::istream& in,
+                                     const std::string& name);
+
+  /* games of a binary replay file, replayed move by move; throws on games
+   * that are not 4x4 power of two ones */
+  static std::vector<Game> ReadGames(const ReplayFile& file,
+                                     const std::string& name);
+
+  static const char* GetMoveName(Directions direction);
+
+ private:
+  Heuristic::Weights weights_;
+  Search::Options options_;
+  int32_t threads_number_;
+};
+
+#endif
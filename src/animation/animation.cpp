@@ -1,5 +1,6 @@
 #include "animation/animation.h"
 #include <chrono>
+#include <stdexcept>
 
 static Tiles GetNextTile(Tiles tile) {
   if (tile == Tiles::kTile_2048)
@@ -51,28 +52,69 @@ static int32_t GetCurrentTime() {
 }
 
 Animation::Animation(const std::vector<std::vector<Logic::TileInfo>>& logic_matrix) {
-  for (size_t i = 0; i < logic_matrix.size(); i++) {
-    for (size_t j = 0; j < logic_matrix[i].size(); j++) {
-      const Logic::TileInfo& tile = logic_matrix[i][j];
-      if (tile.value == Tiles::kNoTile)
-        continue;
-      Tiles value = GetValue(tile);
-      /* same state */
-      int32_t dst_row = i, dst_column = j;
-      double current = tile.source_1, speed = GetSpeed(tile, i , j);
-      double opacity = (tile.state == TileStates::kArising) ? 0 : 1;
-      Animation::TileInfo animation_tile(value, tile.state,
-                                         dst_row, dst_column, current ,
-                                         speed, opacity, tile.direction);
-      tiles_to_draw_.push_back(animation_tile);
+  for (size_t i = 0; i < logic_matrix.size(); i++)
+    for (size_t j = 0; j < logic_matrix[i].size(); j++)
+      AddTile(logic_matrix[i][j], i, j);
+  Start();
+}
 
-      if (animation_tile.state != TileStates::kMerging)
+Animation::Animation(const GameLogic& logic) {
+  int32_t rows = logic.GetRows(), columns = logic.GetColumns();
+  std::vector<bool> moved(rows * columns);
+  for (const GameLogic::MoveEvent& event : logic.GetMoveEvents()) {
+    int32_t from_row = event.from / columns;
+    int32_t from_column = event.from % columns;
+    int32_t to_row = event.to / columns, to_column = event.to % columns;
+    bool is_vertical = from_row != to_row;
+    Directions direction;
+    if (is_vertical)
+      direction = to_row < from_row ? Directions::kUp : Directions::kDown;
+    else
+      direction = to_column < from_column ? Directions::kLeft
+                                          : Directions::kRight;
+    double current = is_vertical ? from_row : from_column;
+    double destination = is_vertical ? to_row : to_column;
+    TileStates state = event.merged ? TileStates::kMerging
+                                    : TileStates::kMoving;
+    tiles_to_draw_.push_back(Animation::TileInfo(
+        event.value, state, to_row, to_column, current,
+        (destination - current) * kBaseMovingRate, 1, direction));
+    moved[event.to] = true;
+  }
+  for (int32_t i = 0; i < rows; i++) {
+    for (int32_t j = 0; j < columns; j++) {
+      Tiles value = logic.GetTile(i, j).value;
+      if (value == Tiles::kNoTile || moved[i * columns + j])
         continue;
-      animation_tile.current = tile.source_2;
-      animation_tile.speed = GetSpeed(tile, i, j, true);
-      tiles_to_draw_.push_back(animation_tile);
+      tiles_to_draw_.push_back(Animation::TileInfo(
+          value, TileStates::kDefault, i, j, 0, 0, 1, Directions::kNone));
     }
   }
+  Start();
+}
+
+void Animation::AddTile(const Logic::TileInfo& tile,
+                        int32_t row, int32_t column) {
+  if (tile.value == Tiles::kNoTile)
+    return;
+  Tiles value = GetValue(tile);
+  /* same state */
+  int32_t dst_row = row, dst_column = column;
+  double current = tile.source_1, speed = GetSpeed(tile, row, column);
+  double opacity = (tile.state == TileStates::kArising) ? 0 : 1;
+  Animation::TileInfo animation_tile(value, tile.state,
+                                     dst_row, dst_column, current ,
+                                     speed, opacity, tile.direction);
+  tiles_to_draw_.push_back(animation_tile);
+
+  if (animation_tile.state != TileStates::kMerging)
+    return;
+  animation_tile.current = tile.source_2;
+  animation_tile.speed = GetSpeed(tile, row, column, true);
+  tiles_to_draw_.push_back(animation_tile);
+}
+
+void Animation::Start() {
   old_time_ = GetCurrentTime();
   elapsed_time_ = 0;
 }
@@ -1,6 +1,7 @@
 #ifndef _2048_ANIMATION_ANIMATION_H_
 #define _2048_ANIMATION_ANIMATION_H_
 
+#include "logic/game_logic.h"
 #include "logic/logic.h"
 
 class Animation {
@@ -32,10 +33,18 @@ class Animation {
 
   Animation(const std::vector<std::vector<Logic::TileInfo>>& logic_matrix);
 
+  /* the last move of logic: tiles named by its move events slide and
+   * merge, all the others stay in place */
+  explicit Animation(const GameLogic& logic);
+
   const std::vector<Animation::TileInfo>& GetAnimationVector() {
     return tiles_to_draw_;
   }
 
+  void AddTile(const Logic::TileInfo& logic_tile, int32_t row, int32_t column);
+
+  void Start();
+
   void UpdateMoving();
 
   void Merge();
@@ -0,0 +1,232 @@
+#include "bench/byte_transpose.h"
+#include "cpu/cpu.h"
+#include "logic/transpose.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef GAME2048_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/* transposes the size x size block at a in place when b is a, otherwise
+ * swaps it with the transpose of the block at b */
+using BlockKernel = void (*)(uint8_t* a, uint8_t* b, int32_t length);
+
+/* register kernels picked once for the instruction set, kernel_size is 1
+ * when the leaves are swapped cell by cell */
+struct Kernels {
+  int32_t kernel_size;
+  BlockKernel transpose_16;
+  BlockKernel transpose_8;
+};
+
+#ifdef __SSE2__
+
+/* Interleaving bytes of register i with register i + half rotates the
+ * (register, byte) index bits left by one. Starting from (row, column),
+ * as many rounds as the index has row bits leave (column, row). */
+template <int32_t Registers>
+void InterleaveRounds(__m128i* rows, int32_t rounds) {
+  constexpr int32_t kHalf = Registers / 2;
+  __m128i next[Registers];
+  for (int32_t round = 0; round < rounds; round++) {
+    for (int32_t i = 0; i < kHalf; i++) {
+      next[2 * i] = _mm_unpacklo_epi8(rows[i], rows[i + kHalf]);
+      next[2 * i + 1] = _mm_unpackhi_epi8(rows[i], rows[i + kHalf]);
+    }
+    std::copy(next, next + Registers, rows);
+  }
+}
+
+/* 16 rows of 16 bytes, one row per register */
+void Load16(const uint8_t* cells, int32_t length, __m128i* rows) {
+  for (int32_t i = 0; i < 16; i++)
+    rows[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+        cells + static_cast<int64_t>(i) * length));
+}
+
+void Store16(uint8_t* cells, int32_t length, const __m128i* rows) {
+  for (int32_t i = 0; i < 16; i++)
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(
+        cells + static_cast<int64_t>(i) * length), rows[i]);
+}
+
+/* 8 rows of 8 bytes, two rows per register */
+void Load8(const uint8_t* cells, int32_t length, __m128i* rows) {
+  for (int32_t i = 0; i < 4; i++) {
+    const uint8_t* row = cells + static_cast<int64_t>(2 * i) * length;
+    rows[i] = _mm_unpacklo_epi64(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row)),
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + length)));
+  }
+}
+
+void Store8(uint8_t* cells, int32_t length, const __m128i* rows) {
+  for (int32_t i = 0; i < 4; i++) {
+    uint8_t* row = cells + static_cast<int64_t>(2 * i) * length;
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(row), rows[i]);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(row + length),
+                     _mm_unpackhi_epi64(rows[i], rows[i]));
+  }
+}
+
+template <int32_t Size>
+void TransposeBlocksSse2(uint8_t* a, uint8_t* b, int32_t length) {
+  constexpr int32_t kRegisters = Size == 16 ? 16 : 4;
+  constexpr int32_t kRounds = Size == 16 ? 4 : 3;
+  auto load = Size == 16 ? Load16 : Load8;
+  auto store = Size == 16 ? Store16 : Store8;
+  __m128i rows_a[kRegisters], rows_b[kRegisters];
+  load(a, length, rows_a);
+  InterleaveRounds<kRegisters>(rows_a, kRounds);
+  if (a == b) {
+    store(a, length, rows_a);
+    return;
+  }
+  load(b, length, rows_b);
+  InterleaveRounds<kRegisters>(rows_b, kRounds);
+  store(b, length, rows_a);
+  store(a, length, rows_b);
+}
+
+#endif
+
+#ifdef GAME2048_X86
+
+/* the interleaves stay within 128-bit lanes, so with block a in the low
+ * lanes and block b in the high ones both are transposed at once */
+__attribute__((target("avx2")))
+void TransposeBlocksAvx2(uint8_t* a, uint8_t* b, int32_t length) {
+  if (a == b) {
+    TransposeBlocksSse2<16>(a, b, length);
+    return;
+  }
+  __m256i rows[16], next[16];
+  for (int32_t i = 0; i < 16; i++) {
+    int64_t offset = static_cast<int64_t>(i) * length;
+    rows[i] = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(a + offset))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + offset)), 1);
+  }
+  for (int32_t round = 0; round < 4; round++) {
+    for (int32_t i = 0; i < 8; i++) {
+      next[2 * i] = _mm256_unpacklo_epi8(rows[i], rows[i + 8]);
+      next[2 * i + 1] = _mm256_unpackhi_epi8(rows[i], rows[i + 8]);
+    }
+    for (int32_t i = 0; i < 16; i++)
+      rows[i] = next[i];
+  }
+  for (int32_t i = 0; i < 16; i++) {
+    int64_t offset = static_cast<int64_t>(i) * length;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(b + offset),
+                     _mm256_castsi256_si128(rows[i]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(a + offset),
+                     _mm256_extracti128_si256(rows[i], 1));
+  }
+}
+
+#endif
+
+Kernels SelectKernels() {
+  InstructionSets set = GetInstructionSet();
+  Kernels kernels = {1, nullptr, nullptr};
+#ifdef __SSE2__
+  if (set >= InstructionSets::kSse2)
+    kernels = {16, TransposeBlocksSse2<16>, TransposeBlocksSse2<8>};
+#endif
+#ifdef GAME2048_X86
+  if (set >= InstructionSets::kAvx2)
+    kernels.transpose_16 = TransposeBlocksAvx2;
+#endif
+  return kernels;
+}
+
+int32_t GetKernelSize(const Kernels& kernels, int32_t rows,
+                      int32_t columns) {
+  for (int32_t size = kernels.kernel_size; size >= 8; size /= 2)
+    if (rows % size == 0 && columns % size == 0)
+      return size;
+  return 1;
+}
+
+/* splits on leaf boundaries where possible, else on kernel boundaries, so
+ * that as many leaves as possible get a register kernel */
+int32_t GetHalf(int32_t size, int32_t kernel) {
+  int32_t half = size / 2 / kTransposeLeaf * kTransposeLeaf;
+  return half ? half : size / 2 / kernel * kernel;
+}
+
+/* runs the kernel over the leaf, over its upper triangle on the diagonal */
+void TransposeLeaf(const Kernels& kernels, int32_t kernel, uint8_t* cells,
+                   int32_t length, int32_t row, int32_t column, int32_t rows,
+                   int32_t columns, bool diagonal) {
+  BlockKernel transpose = kernel == 16 ? kernels.transpose_16
+                                       : kernels.transpose_8;
+  for (int32_t i = row; i < row + rows; i += kernel) {
+    for (int32_t j = diagonal ? i : column; j < column + columns;
+         j += kernel) {
+      transpose(cells + static_cast<int64_t>(i) * length + j,
+                cells + static_cast<int64_t>(j) * length + i, length);
+    }
+  }
+}
+
+/* as transpose_internal::SwapMirrored, with register kernels at leaves */
+void SwapMirrored(const Kernels& kernels, uint8_t* cells, int32_t length,
+                  int32_t row, int32_t column, int32_t rows,
+                  int32_t columns) {
+  int32_t kernel = GetKernelSize(kernels, rows, columns);
+  if (rows <= kTransposeLeaf && columns <= kTransposeLeaf) {
+    if (kernel > 1)
+      TransposeLeaf(kernels, kernel, cells, length, row, column, rows,
+                    columns, false);
+    else
+      transpose_internal::SwapMirrored(cells, length, row, column, rows,
+                                       columns);
+    return;
+  }
+  if (rows >= columns) {
+    int32_t half = GetHalf(rows, kernel);
+    SwapMirrored(kernels, cells, length, row, column, half, columns);
+    SwapMirrored(kernels, cells, length, row + half, column, rows - half,
+                 columns);
+  } else {
+    int32_t half = GetHalf(columns, kernel);
+    SwapMirrored(kernels, cells, length, row, column, rows, half);
+    SwapMirrored(kernels, cells, length, row, column + half, rows,
+                 columns - half);
+  }
+}
+
+void TransposeDiagonal(const Kernels& kernels, uint8_t* cells,
+                       int32_t length, int32_t begin, int32_t size) {
+  int32_t kernel = GetKernelSize(kernels, size, size);
+  if (size <= kTransposeLeaf) {
+    if (kernel > 1)
+      TransposeLeaf(kernels, kernel, cells, length, begin, begin, size, size,
+                    true);
+    else
+      transpose_internal::TransposeDiagonal(cells, length, begin, size);
+    return;
+  }
+  int32_t half = GetHalf(size, kernel);
+  TransposeDiagonal(kernels, cells, length, begin, half);
+  TransposeDiagonal(kernels, cells, length, begin + half, size - half);
+  SwapMirrored(kernels, cells, length, begin + half, begin, size - half,
+               half);
+}
+
+}  // namespace
+
+void TransposeSquare(uint8_t* cells, int32_t length) {
+  static const Kernels kernels = SelectKernels();
+  TransposeDiagonal(kernels, cells, length, 0, length);
+}
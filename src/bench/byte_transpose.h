@@ -0,0 +1,12 @@
+#ifndef _2048_BENCH_BYTE_TRANSPOSE_H_
+#define _2048_BENCH_BYTE_TRANSPOSE_H_
+
+#include <cstdint>
+
+/* TransposeSquare for one byte per cell, as packed exponents, which the
+ * transpose benchmark compares with the generic one on TileInfo: leaves
+ * are transposed 16x16 or 8x8 at a time in SSE2 registers, mirrored 16x16
+ * pairs together in AVX2 registers, as GetInstructionSet allows */
+void TransposeSquare(uint8_t* cells, int32_t length);
+
+#endif
@@ -0,0 +1,30 @@
+#include "bench/byte_transpose.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/* run once per GAME2048_ISA level, see CMakeLists.txt, so that the scalar,
+ * SSE2 and AVX2 byte kernels each meet lengths that are and are not
+ * multiples of their block sizes */
+TEST(ByteTransposeTest, MatchesCellByCellTranspose) {
+  std::mt19937_64 rng(1);
+  std::vector<int32_t> lengths;
+  for (int32_t length = 1; length <= 70; length++)
+    lengths.push_back(length);
+  for (int32_t length : {96, 100, 128, 255, 256, 520})
+    lengths.push_back(length);
+  for (int32_t length : lengths) {
+    SCOPED_TRACE(length);
+    std::vector<uint8_t> cells(static_cast<size_t>(length) * length);
+    for (uint8_t& cell : cells)
+      cell = rng();
+    std::vector<uint8_t> bytes = cells;
+    TransposeSquare(bytes.data(), length);
+    for (int32_t i = 0; i < length; i++)
+      for (int32_t j = 0; j < length; j++)
+        ASSERT_EQ(cells[j * length + i], bytes[i * length + j]);
+  }
+}
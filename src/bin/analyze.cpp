@@ -0,0 +1,106 @@
+#include "analysis/analyzer.h"
+#include "ai/heuristic.h"
+#include "ai/search.h"
+#include "replay/replay.h"
+#include "replay/replay_file.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/* binary replay files start with the replay magic, anything else is read
+ * as a text replay */
+static bool IsReplayFile(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    throw std::runtime_error("cannot open " + path);
+  char magic[sizeof(replay_format::kMagic)] = {};
+  in.read(magic, sizeof(magic));
+  return in && !std::memcmp(magic, replay_format::kMagic, sizeof(magic));
+}
+
+int main(int argc, char** argv) {
+  Search::Options options;
+  options.max_depth = 3;
+  options.time_budget_us = 0;
+  options.table_size_log2 = 22;
+  int32_t threads_number = 0;
+  double blunder = 0.05;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; i++) {
+    std::string name = argv[i];
+    if (name.compare(0, 2, "--")) {
+      paths.push_back(name);
+      continue;
+    }
+    if (i + 1 >= argc)
+      throw std::runtime_error("missing value for " + name);
+    std::string value = argv[++i];
+    if (name == "--depth")
+      options.max_depth = std::stoi(value);
+    else if (name == "--threads")
+      threads_number = std::stoi(value);
+    else if (name == "--blunder")
+      blunder = std::stod(value);
+    else
+      throw std::runtime_error("unknown option " + name);
+  }
+  if (paths.empty())
+    throw std::runtime_error("no replay files given");
+
+  std::vector<Analyzer::Game> games;
+  for (const std::string& path : paths) {
+    std::vector<Analyzer::Game> file_games;
+    if (IsReplayFile(path)) {
+      file_games = Analyzer::ReadGames(ReplayFile(path), path);
+    } else {
+      std::ifstream in(path);
+      if (!in)
+        throw std::runtime_error("cannot open " + path);
+      file_games = Analyzer::ReadGames(in, path);
+    }
+    for (Analyzer::Game& game : file_games)
+      games.push_back(std::move(game));
+  }
+
+  Analyzer analyzer(Heuristic::Weights(), options, threads_number);
+  auto start = std::chrono::steady_clock::now();
+  std::vector<Analyzer::GameReport> reports = analyzer.Analyze(games);
+  double seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+  int64_t positions = 0, blunders = 0;
+  for (size_t i = 0; i < reports.size(); i++) {
+    double loss = 0;
+    int64_t game_blunders = 0;
+    for (size_t j = 0; j < reports[i].moves.size(); j++) {
+      const Analyzer::MoveReport& move = reports[i].moves[j];
+      loss += move.GetLoss();
+      if (move.GetRelativeLoss() < blunder)
+        continue;
+      game_blunders++;
+      std::cout << reports[i].name << " move " << j << " "
+                << std::hex << std::setw(16) << std::setfill('0')
+                << games[i].positions[j].board.GetCells() << std::dec
+                << std::setfill(' ') << " played "
+                << Analyzer::GetMoveName(games[i].positions[j].played)
+                << " best " << Analyzer::GetMoveName(move.best) << " loss "
+                << move.GetRelativeLoss() * 100 << "%\n";
+    }
+    std::cout << reports[i].name << ": moves " << reports[i].moves.size()
+              << " blunders " << game_blunders << " total loss " << loss
+              << "\n";
+    positions += reports[i].moves.size();
+    blunders += game_blunders;
+  }
+  std::cout << "games " << reports.size() << " positions " << positions
+            << " blunders " << blunders << " positions/s "
+            << (seconds > 0 ? positions / seconds : 0) << std::endl;
+  return 0;
+}
@@ -0,0 +1,212 @@
+#include "ai/board.h"
+#include "ai/sliced_board.h"
+#include "bench/byte_transpose.h"
+#include "cpu/cpu.h"
+#include "display/display.h"
+#include "logic/game_logic.h"
+#include "logic/transpose.h"
+
+#include <array>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using TileInfo = GameLogic::TileInfo;
+
+constexpr double kMinSeconds = 0.2;
+constexpr int32_t kBoardsNumber = 1 << 16;
+constexpr Tiles kQueryTile = Tiles::kTile_64;
+
+/* runs body until kMinSeconds pass and returns the calls per second */
+double Measure(const std::function<void()>& body) {
+  using Clock = std::chrono::steady_clock;
+  int64_t calls = 0;
+  auto start = Clock::now();
+  double seconds = 0;
+  for (int64_t batch = 1; seconds < kMinSeconds; batch *= 2) {
+    for (int64_t k = 0; k < batch; k++)
+      body();
+    calls += batch;
+    seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  }
+  return calls / seconds;
+}
+
+/* the swap over separately allocated rows Logic used before */
+void TransposeRows(std::vector<std::vector<TileInfo>>& matrix) {
+  int32_t length = matrix.size();
+  for (int32_t i = 0; i < length; i++)
+    for (int32_t j = i + 1; j < length; j++)
+      std::swap(matrix[i][j], matrix[j][i]);
+}
+
+void TransposeNaive(uint8_t* cells, int32_t length) {
+  for (int32_t i = 0; i < length; i++)
+    for (int32_t j = i + 1; j < length; j++)
+      std::swap(cells[static_cast<int64_t>(i) * length + j],
+                cells[static_cast<int64_t>(j) * length + i]);
+}
+
+void BenchTranspose(const std::vector<int32_t>& lengths) {
+  std::mt19937 rng(1);
+  for (int32_t length : lengths) {
+    int64_t cells_number = static_cast<int64_t>(length) * length;
+    std::vector<std::vector<TileInfo>> rows(length,
+                                            std::vector<TileInfo>(length));
+    std::vector<TileInfo> tiles(cells_number);
+    std::vector<uint8_t> bytes(cells_number);
+    for (int32_t i = 0; i < length; i++) {
+      for (int32_t j = 0; j < length; j++) {
+        Tiles value = static_cast<Tiles>(rng() % 12);
+        rows[i][j] = tiles[i * length + j] = TileInfo(value);
+        bytes[i * length + j] = static_cast<uint8_t>(value);
+      }
+    }
+    std::pair<const char*, std::function<void()>> variants[] = {
+      {"rows", [&] { TransposeRows(rows); }},
+      {"tiles blocked", [&] { TransposeSquare(tiles.data(), length); }},
+      {"bytes naive", [&] { TransposeNaive(bytes.data(), length); }},
+      {"bytes blocked", [&] { TransposeSquare(bytes.data(), length); }},
+    };
+    double baseline = 0;
+    for (const auto& variant : variants) {
+      double cells_per_second = Measure(variant.second) * cells_number;
+      if (!baseline)
+        baseline = cells_per_second;
+      std::cout << "transpose " << length << "x" << length << " "
+                << variant.first << " " << cells_per_second / 1e6
+                << " Mcells/s x" << cells_per_second / baseline << std::endl;
+    }
+  }
+}
+
+using ByteBoard = std::array<uint8_t, Board::kLength * Board::kLength>;
+
+/* mergeable neighbour cells plus cells at or above kQueryTile */
+int64_t QueryBytes(const std::vector<ByteBoard>& boards) {
+  constexpr int32_t kLength = Board::kLength;
+  int64_t count = 0;
+  for (const ByteBoard& cells : boards) {
+    for (int32_t c = 0; c < kLength * kLength; c++) {
+      bool right = c % kLength != kLength - 1 && cells[c] == cells[c + 1];
+      bool down = c < kLength * (kLength - 1)
+          && cells[c] == cells[c + kLength];
+      count += cells[c] && (right || down);
+      count += cells[c] >= static_cast<uint8_t>(kQueryTile);
+    }
+  }
+  return count;
+}
+
+int64_t QuerySliced(const std::vector<SlicedBoard>& boards) {
+  int64_t count = 0;
+  for (const SlicedBoard& board : boards) {
+    count += std::bitset<16>(board.GetMergeable()).count();
+    count += std::bitset<16>(board.GetAtLeast(kQueryTile)).count();
+  }
+  return count;
+}
+
+void BenchSliced() {
+  std::mt19937_64 rng(1);
+  std::vector<Board> packed(kBoardsNumber);
+  std::vector<ByteBoard> bytes(kBoardsNumber);
+  std::vector<SlicedBoard> sliced(kBoardsNumber);
+  for (int32_t k = 0; k < kBoardsNumber; k++) {
+    Board board;
+    for (int32_t i = 0; i < Board::kLength; i++) {
+      for (int32_t j = 0; j < Board::kLength; j++) {
+        Tiles tile = static_cast<Tiles>(rng() % 8);
+        board.SetTile(i, j, tile);
+        bytes[k][i * Board::kLength + j] = static_cast<uint8_t>(tile);
+      }
+    }
+    packed[k] = board;
+    sliced[k] = SlicedBoard(board);
+    if (sliced[k].ToBoard() != board)
+      throw std::runtime_error("sliced board does not convert back");
+  }
+  if (QueryBytes(bytes) != QuerySliced(sliced))
+    throw std::runtime_error("sliced board answers differ from bytes");
+
+  int64_t sink = 0;
+  std::pair<const char*, std::function<void()>> variants[] = {
+    {"bytes", [&] { sink += QueryBytes(bytes); }},
+    {"sliced", [&] { sink += QuerySliced(sliced); }},
+    {"slice and query", [&] {
+      for (const Board& board : packed)
+        sink += SlicedBoard(board).GetMergeable();
+    }},
+    {"slice round trip", [&] {
+      for (const Board& board : packed)
+        sink += SlicedBoard(board).ToBoard().GetCells() & 1;
+    }},
+  };
+  double baseline = 0;
+  for (const auto& variant : variants) {
+    double boards_per_second = Measure(variant.second) * kBoardsNumber;
+    if (!baseline)
+      baseline = boards_per_second;
+    std::cout << "sliced " << variant.first << " "
+              << boards_per_second / 1e6 << " Mboards/s x"
+              << boards_per_second / baseline << std::endl;
+  }
+  if (!sink)
+    std::cout << "nothing found" << std::endl;
+}
+
+std::vector<int32_t> ParseLengths(const std::string& value) {
+  std::vector<int32_t> lengths;
+  for (size_t begin = 0; begin < value.size();) {
+    size_t end = value.find(',', begin);
+    if (end == std::string::npos)
+      end = value.size();
+    lengths.push_back(std::stoi(value.substr(begin, end - begin)));
+    begin = end + 1;
+  }
+  return lengths;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<int32_t> lengths = {64, 256, 1024};
+  std::vector<std::string> names;
+  for (int i = 1; i < argc; i++) {
+    std::string name = argv[i];
+    if (name.compare(0, 2, "--")) {
+      names.push_back(name);
+      continue;
+    }
+    if (i + 1 >= argc)
+      throw std::runtime_error("missing value for " + name);
+    std::string value = argv[++i];
+    if (name == "--lengths")
+      lengths = ParseLengths(value);
+    else
+      throw std::runtime_error("unknown option " + name);
+  }
+  if (names.empty())
+    names = {"transpose", "sliced"};
+
+  std::cout << "instruction set "
+            << GetInstructionSetName(GetInstructionSet()) << std::endl;
+  for (const std::string& name : names) {
+    if (name == "transpose")
+      BenchTranspose(lengths);
+    else if (name == "sliced")
+      BenchSliced();
+    else
+      throw std::runtime_error("unknown benchmark " + name);
+  }
+  return 0;
+}
@@ -0,0 +1,44 @@
+#include "enumerator/enumerator.h"
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+int main(int argc, char** argv) {
+  Enumerator::Options options;
+  for (int i = 1; i < argc; i++) {
+    std::string name = argv[i];
+    if (i + 1 >= argc)
+      throw std::runtime_error("missing value for " + name);
+    std::string value = argv[++i];
+    if (name == "--max-sum")
+      options.max_sum = std::stoi(value);
+    else if (name == "--memory-mb")
+      options.memory_bytes = std::stoll(value) << 20;
+    else if (name == "--threads")
+      options.threads = std::stoi(value);
+    else if (name == "--directory")
+      options.directory = value;
+    else
+      throw std::runtime_error("unknown option " + name);
+  }
+
+  int64_t positions = 0, bytes = 0;
+  double seconds = 0;
+  Enumerator enumerator(options);
+  enumerator.Run([&](const Enumerator::LayerStatistics& layer) {
+    positions += layer.positions;
+    bytes += layer.bytes;
+    seconds += layer.seconds;
+    std::cout << "sum " << layer.sum << " positions " << layer.positions
+              << " runs " << layer.runs << " bytes/position "
+              << (layer.positions ? 1.0 * layer.bytes / layer.positions : 0)
+              << " generated/s " << layer.generated / layer.seconds
+              << std::endl;
+  });
+  std::cout << "total positions " << positions << " bytes " << bytes
+            << " bytes/position " << (positions ? 1.0 * bytes / positions : 0)
+            << " positions/s " << positions / seconds << std::endl;
+  return 0;
+}
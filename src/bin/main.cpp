@@ -1,7 +1,105 @@
 #include "engine/engine.h"
+#include "ai/heuristic.h"
+#include "ai/search.h"
+#include "ai/strategy.h"
+#include "logic/spawn_distribution.h"
+#include "replay/replay.h"
+#include "replay/replay_file.h"
 
-int main() {
-  Engine engine(4);
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+constexpr int32_t kAutoplayBudgetUs = 200000;
+constexpr char kSavePath[] = "2048.sav";
+constexpr char kPlayerProfile[] = "player";
+
+/* --autoplay [expectimax|greedy|corner|random] lets a strategy play,
+ * --hints [expectimax|greedy|corner|random] shows the moves of a strategy
+ * to a human player,
+ * --spawn 2:0.9,4:0.1 sets the spawned values and their weights,
+ * --record path appends the game to a replay file,
+ * --replay path [--game n] plays back the n-th game of a replay file,
+ * --save path keeps the game there instead of 2048.sav and resumes it on
+ * the next start unless --new is given,
+ * --scores directory [--profile name] keeps the results of finished games
+ * there, under the strategy name for autoplay and "player" otherwise */
+int main(int argc, char** argv) {
+  std::string autoplay_name, hints_name, record_path, replay_path;
+  std::string save_path = kSavePath;
+  std::string scores_directory, profile;
+  size_t game_idx = 0;
+  bool new_game = false;
+  SpawnDistribution spawns;
+  for (int i = 1; i < argc; i++) {
+    std::string name = argv[i];
+    bool has_value = i + 1 < argc
+        && std::string(argv[i + 1]).compare(0, 2, "--");
+    if (name == "--autoplay")
+      autoplay_name = has_value ? argv[++i] : "expectimax";
+    else if (name == "--hints")
+      hints_name = has_value ? argv[++i] : "expectimax";
+    else if (name == "--spawn" && has_value)
+      spawns = SpawnDistribution::Parse(argv[++i]);
+    else if (name == "--record" && has_value)
+      record_path = argv[++i];
+    else if (name == "--replay" && has_value)
+      replay_path = argv[++i];
+    else if (name == "--game" && has_value)
+      game_idx = std::stoull(argv[++i]);
+    else if (name == "--save" && has_value)
+      save_path = argv[++i];
+    else if (name == "--new")
+      new_game = true;
+    else if (name == "--scores" && has_value)
+      scores_directory = argv[++i];
+    else if (name == "--profile" && has_value)
+      profile = argv[++i];
+    else
+      throw std::runtime_error("unknown option " + name);
+  }
+
+  Search::Options options;
+  options.time_budget_us = kAutoplayBudgetUs;
+  options.spawns = spawns;
+  std::unique_ptr<Strategy> autoplay;
+  if (!autoplay_name.empty()) {
+    if (!hints_name.empty())
+      throw std::runtime_error("hints are for a human player");
+    autoplay = GetStrategyFactory(autoplay_name, Heuristic::Weights(),
+                                  options)();
+  }
+  if (!replay_path.empty()) {
+    if (!autoplay_name.empty() || !hints_name.empty()
+        || !record_path.empty())
+      throw std::runtime_error("a replay is only played back");
+    ReplayFile file(replay_path);
+    if (game_idx >= file.GetGamesNumber())
+      throw std::runtime_error("no game " + std::to_string(game_idx)
+                               + " in " + replay_path);
+    Replay replay = file.GetGame(game_idx);
+    Engine engine(replay.rows, nullptr, SpawnDistribution(replay.spawns));
+    engine.PlayBack(std::move(replay));
+    engine.MainLoop();
+    return 0;
+  }
+
+  Engine engine(4, std::move(autoplay), spawns);
+  if (!hints_name.empty())
+    engine.ShowHints(GetStrategyFactory(hints_name, Heuristic::Weights(),
+                                        options)());
+  if (!new_game)
+    engine.Resume(save_path);
+  engine.AutoSave(save_path);
+  if (!scores_directory.empty()) {
+    if (profile.empty())
+      profile = autoplay_name.empty() ? kPlayerProfile : autoplay_name;
+    engine.KeepScores(scores_directory, profile);
+  }
+  if (!record_path.empty())
+    engine.Record(record_path);
   engine.MainLoop();
   return 0;
 }
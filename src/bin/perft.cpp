@@ -0,0 +1,156 @@
+#include "perft/perft.h"
+#include "ai/board.h"
+#include "ai/wide_board.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+struct KnownCount {
+  uint64_t cells;
+  int64_t counts[4];
+};
+
+/* depth 1 to 4 counts, cross-checked against both tile matrix logics */
+constexpr KnownCount kKnownCounts[] = {
+  {0x0000000000000022ULL, {88, 8876, 875584, 82675002}},
+  {0x1232004300320002ULL, {46, 2748, 152092, 8500628}},
+  {0x0123456789AB0000ULL, {30, 716, 14962, 266194}},
+  {0x2222333344440000ULL, {48, 3448, 252000, 18075752}},
+};
+
+constexpr int32_t kLogicMaxDepth = 3;
+
+/* 5x5 and 6x6 counts have no known values, the tables are checked against
+ * both tile matrix logics */
+struct WideCase {
+  int32_t length;
+  const char* cells;
+};
+
+constexpr WideCase kWideCases[] = {
+  {5, "22"},
+  {5, "1232004300320002"},
+  {6, "22"},
+  {6, "123456789AB00000222233334444"},
+};
+
+constexpr int32_t kWideMaxDepth = 2;
+
+/* hex digits with cell 0 (top left) last, as Board::GetCells prints */
+template <class BoardType>
+BoardType ParseBoard(const std::string& cells) {
+  BoardType board;
+  int32_t cells_number = BoardType::kLength * BoardType::kLength;
+  if (static_cast<int32_t>(cells.size()) > cells_number)
+    throw std::runtime_error("too many cells in board " + cells);
+  for (size_t k = 0; k < cells.size(); k++) {
+    int32_t cell = cells.size() - 1 - k;
+    board.SetTile(cell / BoardType::kLength, cell % BoardType::kLength,
+                  static_cast<Tiles>(std::stoi(cells.substr(k, 1), nullptr,
+                                               16)));
+  }
+  return board;
+}
+
+template <class BoardType>
+bool ValidateWide(const std::string& cells, int32_t threads_number) {
+  bool success = true;
+  BoardType board = ParseBoard<BoardType>(cells);
+  for (int32_t depth = 1; depth <= kWideMaxDepth; depth++) {
+    int64_t count = Perft::CountBoardParallel(board, depth, threads_number);
+    bool ok = true;
+    for (bool runtime_sized : {true, false})
+      ok = ok && Perft::CountLogic(*Perft::ToLogic(board, runtime_sized),
+                                   depth) == count;
+    std::cout << BoardType::kLength << "x" << BoardType::kLength << " "
+              << cells << " depth " << depth << " got " << count
+              << (ok ? " ok" : " FAILED") << "\n";
+    success = success && ok;
+  }
+  return success;
+}
+
+template <class BoardType>
+void Run(const std::string& cells, int32_t depth, int32_t threads_number) {
+  BoardType board = ParseBoard<BoardType>(cells);
+  for (int32_t d = 1; d <= depth; d++) {
+    auto start = std::chrono::steady_clock::now();
+    int64_t count = Perft::CountBoardParallel(board, d, threads_number);
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "depth " << d << " positions " << count << " positions/s "
+              << (seconds > 0 ? count / seconds : 0) << std::endl;
+  }
+}
+
+bool Validate(int32_t threads_number) {
+  bool success = true;
+  for (const auto& known : kKnownCounts) {
+    for (int32_t depth = 1; depth <= 4; depth++) {
+      Board board(known.cells);
+      int64_t expected = known.counts[depth - 1];
+      int64_t count = Perft::CountBoardParallel(board, depth, threads_number);
+      bool ok = count == expected;
+      for (bool runtime_sized : {true, false})
+        if (depth <= kLogicMaxDepth)
+          ok = ok && Perft::CountLogic(*Perft::ToLogic(board, runtime_sized),
+                                       depth) == expected;
+      std::cout << std::hex << known.cells << std::dec << " depth " << depth
+                << " expected " << expected << " got " << count
+                << (ok ? " ok" : " FAILED") << "\n";
+      success = success && ok;
+    }
+  }
+  for (const auto& wide : kWideCases) {
+    bool ok = wide.length == 5
+        ? ValidateWide<WideBoard<5>>(wide.cells, threads_number)
+        : ValidateWide<WideBoard<6>>(wide.cells, threads_number);
+    success = success && ok;
+  }
+  return success;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string cells = "22";
+  int32_t length = Board::kLength, depth = 5, threads_number = 0;
+  bool validate = false;
+  for (int i = 1; i < argc; i++) {
+    std::string name = argv[i];
+    if (name == "--validate") {
+      validate = true;
+      continue;
+    }
+    if (i + 1 >= argc)
+      throw std::runtime_error("missing value for " + name);
+    std::string value = argv[++i];
+    if (name == "--board")
+      cells = value.compare(0, 2, "0x") ? value : value.substr(2);
+    else if (name == "--length")
+      length = std::stoi(value);
+    else if (name == "--depth")
+      depth = std::stoi(value);
+    else if (name == "--threads")
+      threads_number = std::stoi(value);
+    else
+      throw std::runtime_error("unknown option " + name);
+  }
+  if (validate)
+    return Validate(threads_number) ? 0 : 1;
+
+  if (length == Board::kLength)
+    Run<Board>(cells, depth, threads_number);
+  else if (length == 5)
+    Run<WideBoard<5>>(cells, depth, threads_number);
+  else if (length == 6)
+    Run<WideBoard<6>>(cells, depth, threads_number);
+  else
+    throw std::runtime_error("perft supports boards of 4 to 6 cells");
+  return 0;
+}
@@ -0,0 +1,73 @@
+#include "replay/replay_file.h"
+#include "replay/verifier.h"
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Problems = ReplayVerifier::Problems;
+
+/* prints the report of one file, returns whether every game is legal */
+bool VerifyFile(const std::string& path, int32_t threads_number) {
+  ReplayFile file(path);
+  ReplayVerifier::Report report = ReplayVerifier::Verify(file,
+                                                         threads_number);
+  std::cout << path << ": " << report.games << " games, " << report.moves
+            << " moves, " << report.games / report.seconds << " games/s, "
+            << report.moves / report.seconds / 1e6 << " Mmoves/s\n";
+  bool legal = !file.GetTrailingBytes();
+  if (file.GetTrailingBytes())
+    std::cout << "  " << file.GetTrailingBytes()
+              << " bytes of an unfinished game at the end\n";
+  for (size_t k = 1; k < report.problems.size(); k++) {
+    if (!report.problems[k])
+      continue;
+    legal = false;
+    std::cout << "  " << ReplayVerifier::GetProblemName(
+                             static_cast<Problems>(k))
+              << ": " << report.problems[k] << " games\n";
+  }
+  for (const ReplayVerifier::Failure& failure : report.failures) {
+    std::cout << "  game " << failure.game_idx;
+    if (failure.turn >= 0)
+      std::cout << " turn " << failure.turn;
+    std::cout << ": " << ReplayVerifier::GetProblemName(failure.problem)
+              << "\n";
+  }
+  std::cout << std::flush;
+  return legal;
+}
+
+}  // namespace
+
+/* verify FILE... re-simulates the recorded games and exits with 1 if any
+ * of them breaks the rules, --threads sets the number of threads */
+int main(int argc, char** argv) {
+  int32_t threads_number = 0;
+  std::vector<std::string> arguments;
+  for (int i = 1; i < argc; i++) {
+    std::string name = argv[i];
+    if (name.compare(0, 2, "--")) {
+      arguments.push_back(name);
+      continue;
+    }
+    if (i + 1 >= argc)
+      throw std::runtime_error("missing value for " + name);
+    std::string value = argv[++i];
+    if (name == "--threads")
+      threads_number = std::stoi(value);
+    else
+      throw std::runtime_error("unknown option " + name);
+  }
+  if (arguments.size() < 2 || arguments[0] != "verify")
+    throw std::runtime_error("usage: 2048-replay verify FILE...");
+
+  bool legal = true;
+  for (size_t i = 1; i < arguments.size(); i++)
+    legal = VerifyFile(arguments[i], threads_number) && legal;
+  return legal ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+#include "scores/score_store.h"
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t kDefaultTopSize = 10;
+constexpr double kPercentiles[] = {10, 25, 50, 75, 90, 99};
+
+void PrintSummary(const ScoreStore& store) {
+  ScoreStore::Summary summary = store.GetSummary();
+  std::cout << summary.games << " games, mean score " << summary.mean_score
+            << ", best " << summary.best_score << ", success rate "
+            << summary.success_rate << ", " << summary.moves << " moves in "
+            << summary.seconds << " s\nscore";
+  for (double percentile : kPercentiles)
+    std::cout << " p" << percentile << " "
+              << store.GetPercentile(percentile);
+  std::cout << "\nmax tile";
+  for (size_t tile = 1; tile < summary.max_tiles.size(); tile++)
+    if (summary.max_tiles[tile])
+      std::cout << " " << (1 << (tile - 1)) << ":"
+                << summary.max_tiles[tile];
+  std::cout << std::endl;
+}
+
+void PrintTop(const ScoreStore& store, size_t number) {
+  std::vector<ScoreStore::Result> top = store.GetTop(number);
+  for (size_t k = 0; k < top.size(); k++) {
+    const ScoreStore::Result& result = top[k];
+    std::cout << k + 1 << ". " << result.score << " max tile "
+              << (1 << (static_cast<int32_t>(result.max_tile) - 1)) << ", "
+              << result.moves << " moves, " << result.seconds
+              << " s, seed " << result.seed << "\n";
+  }
+  std::cout << std::flush;
+}
+
+}  // namespace
+
+/* summary DIRECTORY PROFILE prints the totals and score percentiles,
+ * top DIRECTORY PROFILE [N] the N best games, rank DIRECTORY PROFILE SCORE
+ * the percentage of games scoring less */
+int main(int argc, char** argv) {
+  std::vector<std::string> arguments(argv + 1, argv + argc);
+  if (arguments.size() < 3)
+    throw std::runtime_error(
+        "usage: 2048-scores summary|top|rank DIRECTORY PROFILE [VALUE]");
+  const std::string& command = arguments[0];
+  ScoreStore store(arguments[1], arguments[2]);
+  if (command == "summary") {
+    PrintSummary(store);
+  } else if (command == "top") {
+    PrintTop(store, arguments.size() > 3 ? std::stoull(arguments[3])
+                                         : kDefaultTopSize);
+  } else if (command == "rank" && arguments.size() > 3) {
+    std::cout << store.GetPercentRank(std::stoll(arguments[3])) << "%"
+              << std::endl;
+  } else {
+    throw std::runtime_error("unknown command " + command);
+  }
+  return 0;
+}
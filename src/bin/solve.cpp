@@ -0,0 +1,51 @@
+#include "solver/solver.h"
+#include "display/display.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+int main(int argc, char** argv) {
+  Solver::Options options;
+  std::string output = "solver.table";
+  for (int i = 1; i < argc; i++) {
+    std::string name = argv[i];
+    if (i + 1 >= argc)
+      throw std::runtime_error("missing value for " + name);
+    std::string value = argv[++i];
+    if (name == "--goal") {
+      int32_t goal = std::stoi(value), tile = 1;
+      while ((1 << (tile - 1)) < goal)
+        tile++;
+      if ((1 << (tile - 1)) != goal || tile > 0xF)
+        throw std::runtime_error("goal must be a power of two tile");
+      options.goal = static_cast<Tiles>(tile);
+    } else if (name == "--threads") {
+      options.threads = std::stoi(value);
+    } else if (name == "--output") {
+      output = value;
+    } else {
+      throw std::runtime_error("unknown option " + name);
+    }
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  Solver solver(options);
+  solver.Solve();
+  double seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+  double win_probability = 0;
+  const Solver::Layer& first = solver.GetLayers().front();
+  for (float value : first.values)
+    win_probability += value / first.values.size();
+  std::cout << "positions " << solver.GetPositionsNumber()
+            << " layers " << solver.GetLayers().size()
+            << " seconds " << seconds << "\n"
+            << "win probability from a random start " << win_probability
+            << "\n";
+  solver.Write(output);
+  return 0;
+}
@@ -0,0 +1,129 @@
+#include "tournament/tournament.h"
+#include "ai/heuristic.h"
+#include "ai/search.h"
+#include "ai/strategy.h"
+#include "display/display.h"
+#include "logic/spawn_distribution.h"
+#include "replay/replay_writer.h"
+#include "scores/score_store.h"
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+void PrintEstimate(const std::string& name,
+                   const Tournament::Estimate& estimate) {
+  std::cout << "  " << name << " " << estimate.mean << " +- "
+            << estimate.half_width << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Search::Options options;
+  options.max_depth = 2;
+  options.time_budget_us = 0;
+  options.table_size_log2 = 16;
+  int32_t games = 100, threads_number = 0;
+  uint64_t seed = 1;
+  std::string record_path, scores_directory;
+  std::vector<std::string> names;
+  for (int i = 1; i < argc; i++) {
+    std::string name = argv[i];
+    if (name.compare(0, 2, "--")) {
+      names.push_back(name);
+      continue;
+    }
+    if (i + 1 >= argc)
+      throw std::runtime_error("missing value for " + name);
+    std::string value = argv[++i];
+    if (name == "--games")
+      games = std::stoi(value);
+    else if (name == "--threads")
+      threads_number = std::stoi(value);
+    else if (name == "--seed")
+      seed = std::stoull(value);
+    else if (name == "--depth")
+      options.max_depth = std::stoi(value);
+    else if (name == "--budget-us")
+      options.time_budget_us = std::stoi(value);
+    else if (name == "--threshold")
+      options.probability_threshold = std::stod(value);
+    else if (name == "--sampled-cells")
+      options.sampled_cells = std::stoi(value);
+    else if (name == "--sampling-ply")
+      options.sampling_ply = std::stoi(value);
+    else if (name == "--spawn")
+      options.spawns = SpawnDistribution::Parse(value);
+    else if (name == "--record")
+      record_path = value;
+    else if (name == "--scores")
+      scores_directory = value;
+    else
+      throw std::runtime_error("unknown option " + name);
+  }
+  if (names.empty())
+    names = {"expectimax", "greedy", "corner", "random"};
+
+  std::vector<Tournament::Entry> entries;
+  for (const std::string& name : names)
+    entries.push_back({name, GetStrategyFactory(name, Heuristic::Weights(),
+                                                options)});
+  std::mt19937_64 rng(seed);
+  std::vector<uint64_t> seeds(games);
+  for (uint64_t& game_seed : seeds)
+    game_seed = rng();
+
+  std::unique_ptr<ReplayWriter> recorder;
+  if (!record_path.empty())
+    recorder.reset(new ReplayWriter(record_path));
+  Tournament tournament(entries, threads_number, options.spawns);
+  std::vector<Tournament::Standing> standings =
+      tournament.Run(seeds, recorder.get());
+  for (const Tournament::Standing& standing : standings) {
+    std::cout << standing.name << ":\n";
+    PrintEstimate("score", standing.score);
+    PrintEstimate("score vs " + names[0], standing.score_difference);
+    PrintEstimate("moves/s", standing.moves_per_second);
+    std::cout << "  success rate " << standing.success_rate << "\n  score";
+    for (size_t k = 0; k < standing.score_percentiles.size(); k++)
+      std::cout << " p" << Tournament::kPercentiles[k] << " "
+                << standing.score_percentiles[k];
+    std::cout << "\n  max tile";
+    for (size_t tile = 1; tile < standing.max_tiles.size(); tile++)
+      if (standing.max_tiles[tile])
+        std::cout << " " << (1 << (tile - 1)) << ":"
+                  << standing.max_tiles[tile];
+    std::cout << std::endl;
+  }
+  if (recorder) {
+    recorder->Close();
+    std::cout << recorder->GetGamesNumber() << " games recorded to "
+              << record_path << std::endl;
+  }
+  /* one profile per strategy */
+  if (!scores_directory.empty()) {
+    for (const Tournament::Standing& standing : standings) {
+      ScoreStore store(scores_directory, standing.name);
+      for (size_t j = 0; j < seeds.size(); j++) {
+        const Simulator::GameResult& game = standing.games[j];
+        ScoreStore::Result result;
+        result.score = game.score;
+        result.moves = game.moves;
+        result.max_tile = game.max_tile;
+        result.success = game.success;
+        result.seconds = game.seconds;
+        result.seed = seeds[j];
+        store.Add(result);
+      }
+    }
+    std::cout << "scores kept in " << scores_directory << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,158 @@
+#include "ai/heuristic.h"
+#include "ai/search.h"
+#include "logic/spawn_distribution.h"
+#include "simulator/simulator.h"
+#include "tuner/cma_es.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct TuneOptions {
+  int32_t games = 200;
+  int32_t generations = 50;
+  int32_t threads = 0;
+  int32_t depth = 2;
+  uint64_t seed = 1;
+  double sigma = 0.3;
+  std::string checkpoint = "tune.checkpoint";
+  std::string spawn = "2:1";
+};
+
+/* every weight is tuned in log scale relative to the default one */
+double* GetWeight(Heuristic::Weights& weights, size_t idx) {
+  double* fields[] = {
+    &weights.lost_penalty, &weights.monotonicity_power, &weights.monotonicity,
+    &weights.sum_power, &weights.sum, &weights.merges, &weights.empty,
+  };
+  return fields[idx];
+}
+
+constexpr size_t kWeightsNumber = 7;
+
+Heuristic::Weights ToWeights(const CmaEs::Vector& x) {
+  Heuristic::Weights weights;
+  for (size_t i = 0; i < kWeightsNumber; i++)
+    *GetWeight(weights, i) *= std::exp(x[i]);
+  return weights;
+}
+
+void PrintWeights(std::ostream& out, const Heuristic::Weights& weights) {
+  Heuristic::Weights copy = weights;
+  for (size_t i = 0; i < kWeightsNumber; i++)
+    out << *GetWeight(copy, i) << (i + 1 < kWeightsNumber ? ' ' : '\n');
+}
+
+TuneOptions ParseOptions(int argc, char** argv) {
+  TuneOptions options;
+  for (int i = 1; i < argc; i++) {
+    std::string name = argv[i];
+    if (i + 1 >= argc)
+      throw std::runtime_error("missing value for " + name);
+    std::string value = argv[++i];
+    if (name == "--games")
+      options.games = std::stoi(value);
+    else if (name == "--generations")
+      options.generations = std::stoi(value);
+    else if (name == "--threads")
+      options.threads = std::stoi(value);
+    else if (name == "--depth")
+      options.depth = std::stoi(value);
+    else if (name == "--seed")
+      options.seed = std::stoull(value);
+    else if (name == "--sigma")
+      options.sigma = std::stod(value);
+    else if (name == "--checkpoint")
+      options.checkpoint = value;
+    else if (name == "--spawn")
+      options.spawn = value;
+    else
+      throw std::runtime_error("unknown option " + name);
+  }
+  return options;
+}
+
+void SaveCheckpoint(const std::string& path, const CmaEs& cma_es,
+                    double best_fitness, const CmaEs::Vector& best) {
+  std::string temporary = path + ".tmp";
+  {
+    std::ofstream out(temporary);
+    cma_es.Save(out);
+    out << best_fitness;
+    for (double value : best)
+      out << ' ' << value;
+    out << '\n';
+    if (!out)
+      throw std::runtime_error("cannot write checkpoint " + temporary);
+  }
+  if (std::rename(temporary.c_str(), path.c_str()))
+    throw std::runtime_error("cannot replace checkpoint " + path);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  TuneOptions options = ParseOptions(argc, argv);
+  Search::Options search_options;
+  search_options.max_depth = options.depth;
+  search_options.time_budget_us = 0;
+  search_options.table_size_log2 = 16;
+  search_options.spawns = SpawnDistribution::Parse(options.spawn);
+
+  CmaEs cma_es(CmaEs::Vector(kWeightsNumber, 0), options.sigma, options.seed);
+  double best_fitness = -1;
+  CmaEs::Vector best(kWeightsNumber, 0);
+  std::ifstream checkpoint(options.checkpoint);
+  if (checkpoint) {
+    cma_es.Load(checkpoint);
+    checkpoint >> best_fitness;
+    for (double& value : best)
+      checkpoint >> value;
+    std::cout << "resumed from generation " << cma_es.GetGeneration() << "\n";
+  }
+
+  while (cma_es.GetGeneration() < options.generations) {
+    /* all candidates of a generation play the same spawn streams */
+    std::mt19937_64 seeds_rng(options.seed * 1000003 + cma_es.GetGeneration());
+    std::vector<uint64_t> seeds(options.games);
+    for (auto& seed : seeds)
+      seed = seeds_rng();
+
+    std::vector<CmaEs::Vector> population = cma_es.Ask();
+    CmaEs::Vector fitness(population.size());
+    double seconds = 0;
+    for (size_t i = 0; i < population.size(); i++) {
+      Simulator simulator(ToWeights(population[i]), search_options);
+      Simulator::BatchResult batch = simulator.PlayBatch(seeds,
+                                                         options.threads);
+      fitness[i] = batch.mean_score;
+      seconds += batch.seconds;
+      if (fitness[i] > best_fitness) {
+        best_fitness = fitness[i];
+        best = population[i];
+      }
+    }
+    cma_es.Tell(population, fitness);
+    SaveCheckpoint(options.checkpoint, cma_es, best_fitness, best);
+
+    double mean_fitness = 0;
+    for (double value : fitness)
+      mean_fitness += value / fitness.size();
+    std::cout << "generation " << cma_es.GetGeneration()
+              << " mean " << mean_fitness << " best " << best_fitness
+              << " sigma " << cma_es.GetSigma() << " games/s "
+              << options.games * population.size() / seconds << "\n";
+  }
+  std::cout << "best weights: ";
+  PrintWeights(std::cout, ToWeights(best));
+  return 0;
+}
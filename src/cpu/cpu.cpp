@@ -0,0 +1,105 @@
+#include "cpu/cpu.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#ifdef GAME2048_X86
+#include <cpuid.h>
+#endif
+
+namespace {
+
+constexpr const char* kNames[] = {
+  "scalar", "sse2", "avx2",
+};
+
+struct Features {
+  InstructionSets set;
+  bool fast_bmi2;
+};
+
+#ifdef GAME2048_X86
+
+/* extended states the OS saves on context switches */
+uint64_t GetEnabledStates() {
+  uint32_t low, high;
+  __asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+  return static_cast<uint64_t>(high) << 32 | low;
+}
+
+/* AMD (and Hygon, licensed Zen 1) families before 0x19, Zen 3 */
+bool HasMicrocodedBmi2() {
+  unsigned eax, ebx, ecx, edx;
+  if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx))
+    return false;
+  bool amd = (ebx == 0x68747541 && edx == 0x69746E65 && ecx == 0x444D4163)
+      || (ebx == 0x6F677948 && edx == 0x6E65476E && ecx == 0x656E6975);
+  if (!amd || !__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return false;
+  unsigned family = (eax >> 8) & 0xF;
+  if (family == 0xF)
+    family += (eax >> 20) & 0xFF;
+  return family < 0x19;
+}
+
+Features DetectFeatures() {
+  constexpr uint64_t kYmmStates = 0x6;
+  unsigned eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(edx & bit_SSE2))
+    return {InstructionSets::kScalar, false};
+  uint64_t states = (ecx & bit_OSXSAVE) ? GetEnabledStates() : 0;
+  bool avx = (ecx & bit_AVX) && (states & kYmmStates) == kYmmStates;
+  if (!avx || !__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)
+      || !(ebx & bit_AVX2))
+    return {InstructionSets::kSse2, false};
+  return {InstructionSets::kAvx2,
+          (ebx & bit_BMI2) && !HasMicrocodedBmi2()};
+}
+
+#else
+
+Features DetectFeatures() {
+  return {InstructionSets::kScalar, false};
+}
+
+#endif
+
+Features SelectFeatures() {
+  Features features = DetectFeatures();
+  if (const char* name = std::getenv("GAME2048_ISA"))
+    features.set = std::min(features.set, ParseInstructionSet(name));
+  features.fast_bmi2 = features.fast_bmi2
+      && features.set >= InstructionSets::kAvx2;
+  return features;
+}
+
+/* a bad override throws here on every call, static initialization is not
+ * completed by an exception */
+const Features& GetFeatures() {
+  static const Features features = SelectFeatures();
+  return features;
+}
+
+}  // namespace
+
+InstructionSets GetInstructionSet() {
+  return GetFeatures().set;
+}
+
+bool HasFastBmi2() {
+  return GetFeatures().fast_bmi2;
+}
+
+const char* GetInstructionSetName(InstructionSets set) {
+  return kNames[static_cast<int32_t>(set)];
+}
+
+InstructionSets ParseInstructionSet(const std::string& name) {
+  auto it = std::find(std::begin(kNames), std::end(kNames), name);
+  if (it == std::end(kNames))
+    throw std::runtime_error("unknown instruction set " + name);
+  return static_cast<InstructionSets>(it - std::begin(kNames));
+}
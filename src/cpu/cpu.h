@@ -0,0 +1,35 @@
+#ifndef _2048_CPU_CPU_H_
+#define _2048_CPU_CPU_H_
+
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define GAME2048_X86 1
+#endif
+
+/* each set includes the ones before it; only sets some kernel has a
+ * variant for are listed */
+enum class InstructionSets {
+  kScalar,
+  kSse2,
+  kAvx2,
+};
+
+/* Best set supported by both the CPU and the OS, detected once with cpuid.
+ * GAME2048_ISA (scalar, sse2 or avx2) lowers it, which lets every
+ * kernel variant be tested on one machine. An unknown name throws from
+ * every call; kernels make their first call when they are first used, not
+ * during static initialization. */
+InstructionSets GetInstructionSet();
+
+/* bmi2 whose pdep and pext beat the bit loops they replace: AMD runs them
+ * in microcode up to Zen 2. Off below kAvx2, so GAME2048_ISA turns it off
+ * too. */
+bool HasFastBmi2();
+
+const char* GetInstructionSetName(InstructionSets set);
+
+InstructionSets ParseInstructionSet(const std::string& name);
+
+#endif
@@ -0,0 +1,30 @@
+#include "cpu/cpu.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <stdexcept>
+
+TEST(CpuTest, NamesRoundTrip) {
+  for (InstructionSets set : {InstructionSets::kScalar, InstructionSets::kSse2,
+                              InstructionSets::kAvx2})
+    EXPECT_EQ(set, ParseInstructionSet(GetInstructionSetName(set)));
+  EXPECT_THROW(ParseInstructionSet("sse4.2"), std::runtime_error);
+  EXPECT_THROW(ParseInstructionSet("avx512"), std::runtime_error);
+}
+
+/* registered on its own with GAME2048_ISA=sse2, before anything else in
+ * the process detects the set */
+TEST(CpuTest, OverrideLowersSet) {
+  const char* name = std::getenv("GAME2048_ISA");
+  ASSERT_TRUE(name);
+  EXPECT_LE(GetInstructionSet(), ParseInstructionSet(name));
+  EXPECT_FALSE(HasFastBmi2());
+}
+
+/* registered on its own with an unknown GAME2048_ISA */
+TEST(CpuTest, UnknownOverrideThrowsOnEveryCall) {
+  EXPECT_THROW(GetInstructionSet(), std::runtime_error);
+  EXPECT_THROW(GetInstructionSet(), std::runtime_error);
+  EXPECT_THROW(HasFastBmi2(), std::runtime_error);
+}
@@ -16,6 +16,7 @@ class Display::Impl {
 
   void DrawTile(float x, float y, Tiles type, float alpha);
   void DrawWinMessage();
+  void DrawHint(Keys key);
 
   bool IsKeyPressed(Keys key) const;
   bool Closed() const;
@@ -50,12 +51,14 @@ class Display::Impl {
 
   std::vector<Tile> tiles_;
   bool win_message_;
+  Keys hint_;
 };
 
 Display::Impl::Impl()
     : next_texture_index_(0)
     , tiles_()
-    , win_message_(false) {
+    , win_message_(false)
+    , hint_(Keys::kNoKey) {
   InitWindow();
   InitOpenGL();
   InitTextures();
@@ -137,6 +140,10 @@ void Display::Impl::DrawWinMessage() {
   win_message_ = true;
 }
 
+void Display::Impl::DrawHint(Keys key) {
+  hint_ = key;
+}
+
 bool Display::Impl::IsKeyPressed(Keys key) const {
   switch (key) {
     case Keys::kKeyUp:
@@ -151,6 +158,9 @@ bool Display::Impl::IsKeyPressed(Keys key) const {
     case Keys::kKeyRight:
       return glfwGetKey(window_, GLFW_KEY_D) == GLFW_PRESS ||
              glfwGetKey(window_, GLFW_KEY_RIGHT) == GLFW_PRESS;
+    case Keys::kKeyUndo:
+      return glfwGetKey(window_, GLFW_KEY_Z) == GLFW_PRESS ||
+             glfwGetKey(window_, GLFW_KEY_BACKSPACE) == GLFW_PRESS;
     default:
       return false;
   }
@@ -193,6 +203,27 @@ void Display::Impl::Render() {
     glEnd(); 
   }
 
+  if (hint_ != Keys::kNoKey) {
+    /* a triangle in the middle of the board, tip towards the move */
+    float dx = 0, dy = 0;
+    if (hint_ == Keys::kKeyLeft)
+      dx = -1;
+    else if (hint_ == Keys::kKeyRight)
+      dx = 1;
+    else if (hint_ == Keys::kKeyUp)
+      dy = -1;
+    else if (hint_ == Keys::kKeyDown)
+      dy = 1;
+    glDisable(GL_TEXTURE_2D);
+    glColor4f(1.0f, 1.0f, 1.0f, 0.5f);
+    glBegin(GL_TRIANGLES);
+    glVertex2f(1.5f + 0.8f * dx, 1.5f + 0.8f * dy);
+    glVertex2f(1.5f - 0.4f * dx - 0.6f * dy, 1.5f - 0.4f * dy + 0.6f * dx);
+    glVertex2f(1.5f - 0.4f * dx + 0.6f * dy, 1.5f - 0.4f * dy - 0.6f * dx);
+    glEnd();
+    glEnable(GL_TEXTURE_2D);
+  }
+
   if (win_message_) {
     glBindTexture(GL_TEXTURE_2D, win_texture_);
     glColor4f(1.0f, 1.0f, 1.0f, 0.9f);
@@ -212,6 +243,7 @@ void Display::Impl::Render() {
 
   tiles_.clear();
   win_message_ = false;
+  hint_ = Keys::kNoKey;
 }
 
 Display::Display()
@@ -227,6 +259,10 @@ void Display::DrawWinMessage() {
   impl_->DrawWinMessage();
 }
 
+void Display::DrawHint(Keys key) {
+  impl_->DrawHint(key);
+}
+
 double Display::GetTime() const {
   return glfwGetTime();
 }
@@ -24,6 +24,7 @@ enum class Keys {
   kKeyDown,
   kKeyLeft,
   kKeyRight,
+  kKeyUndo,
 };
 
 namespace std {
@@ -42,6 +43,8 @@ class Display {
 
   void DrawTile(float x, float y, Tiles type, float alpha = 1.0f);
   void DrawWinMessage();
+  /* an arrow over the board pointing the way of the key */
+  void DrawHint(Keys key);
 
   double GetTime() const;
   bool IsKeyPressed(Keys key) const;
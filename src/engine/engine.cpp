@@ -1,10 +1,272 @@
 #include "display/display.h"
+#include "logic/game_logic.h"
 #include "logic/logic.h"
+#include "logic/snapshot.h"
+#include "logic/spawn_distribution.h"
 #include "engine/engine.h"
 #include "animation/animation.h"
+#include "ai/board.h"
+#include "ai/advisor.h"
+#include "ai/strategy.h"
+#include "replay/replay.h"
+#include "replay/replay_player.h"
+#include "replay/replay_writer.h"
+#include "save/autosaver.h"
+#include "save/saved_game.h"
+#include "scores/score_store.h"
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
 #include <stdexcept>
 #include <iostream>
+#include <string>
+#include <utility>
+
+constexpr Keys Engine::kMoveKeys[];
+constexpr double Engine::kPlaybackSpeed;
+constexpr double Engine::kMinPlaybackSpeed;
+constexpr double Engine::kMaxPlaybackSpeed;
+constexpr double Engine::kMaxAnimatedSpeed;
+
+Engine::Engine(int32_t length, std::unique_ptr<Strategy> autoplay,
+               const SpawnDistribution& spawns)
+    : seed_(std::random_device()())
+    , logic_(GameLogic::Create(length, length, MergeRules::kPowerOfTwo,
+                               spawns, seed_))
+    , animation_(logic_->GetMatrix())
+    , state_(States::kArising)
+    , key_pressed_(Keys::kNoKey)
+    , moves_(0)
+    , score_(0)
+    , start_time_(display_.GetTime())
+    , snapshots_(length, length)
+    , saved_turns_(0)
+    , undo_held_(false)
+    , playback_speed_(kPlaybackSpeed)
+    , playback_position_(0)
+    , playback_time_(0)
+    , playback_key_(Keys::kNoKey) {
+  if (autoplay) {
+    if (length != Board::kLength)
+      throw std::runtime_error("autoplay is supported only for 4x4 board");
+    advisor_.reset(new Advisor(std::move(autoplay)));
+    RequestAdvice();
+  }
+  snapshots_.Publish(*logic_, moves_, score_);
+  replay_.seed = seed_;
+  replay_.rows = replay_.columns = length;
+  replay_.spawns = spawns.GetOutcomes();
+  /* in spawn order, which for two tiles only needs the last one last */
+  int32_t last = logic_->GetNewTileRow() * length
+      + logic_->GetNewTileColumn();
+  for (int32_t cell = 0; cell < length * length; cell++) {
+    Tiles value = logic_->GetTile(cell / length, cell % length).value;
+    if (value != Tiles::kNoTile && cell != last)
+      replay_.initial_tiles.push_back({cell, value});
+  }
+  if (logic_->GetNewTileRow() >= 0)
+    replay_.initial_tiles.push_back(
+        {last, logic_->GetTile(last / length, last % length).value});
+  Draw();
+}
+
+void Engine::ShowHints(std::unique_ptr<Strategy> strategy) {
+  if (logic_->GetRows() != Board::kLength
+      || logic_->GetColumns() != Board::kLength)
+    throw std::runtime_error("hints are supported only for 4x4 board");
+  hinter_.reset(new Advisor(std::move(strategy)));
+  RequestAdvice();
+}
+
+void Engine::Record(const std::string& path) {
+  recorder_.reset(new ReplayWriter(path));
+}
+
+bool Engine::Resume(const std::string& path) {
+  SavedGame game;
+  if (!SavedGame::Load(path, &game)
+      || game.replay.rows != logic_->GetRows()
+      || game.replay.columns != logic_->GetColumns())
+    return false;
+  const Replay& replay = game.replay;
+  std::unique_ptr<GameLogic> logic = GameLogic::Create(
+      replay.rows, replay.columns, replay.rule,
+      SpawnDistribution(replay.spawns), replay.seed);
+  for (int32_t i = 0; i < replay.rows; i++) {
+    for (int32_t j = 0; j < replay.columns; j++) {
+      int32_t cell = i * replay.columns + j;
+      logic->SetTile(i, j, static_cast<Tiles>(
+          (game.cells[cell / 16] >> (4 * (cell % 16))) & 0xF));
+    }
+  }
+  logic->ResetStates();
+  logic->SetRng(game.rng);
+
+  logic_ = std::move(logic);
+  seed_ = replay.seed;
+  moves_ = replay.turns.size();
+  score_ = replay.score;
+  start_time_ = display_.GetTime() - game.seconds;
+  replay_ = std::move(game.replay);
+  saved_turns_ = 0;
+  outcomes_.clear();
+  animation_ = Animation(logic_->GetMatrix());
+  state_ = States::kArising;
+  snapshots_.Publish(*logic_, moves_, score_);
+  RequestAdvice();
+  return true;
+}
+
+void Engine::AutoSave(const std::string& path) {
+  saver_.reset(new AutoSaver(path));
+  saved_turns_ = 0;
+}
+
+void Engine::Save() {
+  if (!saver_)
+    return;
+  if (logic_->IsGameOver()) {
+    saver_->Clear();
+    saved_turns_ = 0;
+    return;
+  }
+  saver_->Save(replay_, saved_turns_,
+               Replay::MakeKeyframe(*logic_, score_).cells,
+               logic_->GetRng(), display_.GetTime() - start_time_);
+  saved_turns_ = replay_.turns.size();
+}
+
+void Engine::KeepScores(const std::string& directory,
+                        const std::string& profile) {
+  scores_.reset(new ScoreStore(directory, profile));
+}
+
+/* an ended game is not resumed, its result is kept instead */
+void Engine::Finish() {
+  if (saver_)
+    saver_->Clear();
+  saved_turns_ = 0;
+  if (!scores_)
+    return;
+  ScoreStore::Result result;
+  result.score = score_;
+  result.moves = moves_;
+  result.success = logic_->IsSuccess();
+  result.seconds = display_.GetTime() - start_time_;
+  result.seed = seed_;
+  for (int32_t i = 0; i < logic_->GetRows(); i++)
+    for (int32_t j = 0; j < logic_->GetColumns(); j++)
+      result.max_tile = std::max(result.max_tile,
+                                 logic_->GetTile(i, j).value);
+  scores_->Add(result);
+  scores_->RequestFlush();
+}
+
+/* rebuilds the board from the record without the last move; the rng is
+ * rewound too, so the same move spawns the same tile again */
+void Engine::Undo() {
+  if (replay_.turns.empty())
+    return;
+  uint64_t draws = logic_->GetRng().GetDraws();
+  if (replay_.turns.back().spawn.cell >= 0)
+    draws -= 1 + SpawnDistribution(replay_.spawns).GetSampleDraws();
+  replay_.turns.pop_back();
+  saved_turns_ = std::min(saved_turns_, replay_.turns.size());
+  replay_.keyframes.resize(replay_.turns.size()
+                           / replay_.keyframe_interval);
+  ReplayPlayer player(replay_);
+  player.Seek(player.GetMovesNumber());
+  std::unique_ptr<GameLogic> logic = player.GetLogic().Clone();
+  logic->ResetStates();
+  SpawnRng rng;
+  rng.Restore(logic->GetRng().GetSeed(), draws);
+  logic->SetRng(rng);
+
+  logic_ = std::move(logic);
+  moves_ = player.GetMove();
+  score_ = replay_.score = player.GetScore();
+  outcomes_.clear();
+  animation_ = Animation(logic_->GetMatrix());
+  state_ = States::kArising;
+  snapshots_.Publish(*logic_, moves_, score_);
+  Save();
+  RequestAdvice();
+}
+
+void Engine::PlayBack(Replay replay) {
+  if (replay.rows != logic_->GetRows()
+      || replay.columns != logic_->GetColumns())
+    throw std::runtime_error("replay board size differs from the engine");
+  advisor_.reset();
+  hinter_.reset();
+  player_.reset(new ReplayPlayer(std::move(replay)));
+  playback_position_ = 0;
+  playback_time_ = display_.GetTime();
+  ShowPlayback();
+  state_ = States::kTurn;
+}
+
+/* the board at the current move without animation */
+void Engine::ShowPlayback() {
+  std::unique_ptr<GameLogic> logic = player_->GetLogic().Clone();
+  logic->ResetStates();
+  animation_ = Animation(logic->GetMatrix());
+  snapshots_.Publish(*logic, player_->GetMove(), player_->GetScore());
+}
+
+void Engine::PlayBackTurn() {
+  Keys key = GetPressedKey();
+  if (key != playback_key_) {
+    double speed = std::fabs(playback_speed_);
+    if (key == Keys::kKeyRight)
+      playback_speed_ = speed;
+    else if (key == Keys::kKeyLeft)
+      playback_speed_ = -speed;
+    else if (key == Keys::kKeyUp)
+      playback_speed_ = std::copysign(std::min(2 * speed, kMaxPlaybackSpeed),
+                                      playback_speed_);
+    else if (key == Keys::kKeyDown)
+      playback_speed_ = std::copysign(std::max(speed / 2, kMinPlaybackSpeed),
+                                      playback_speed_);
+  }
+  playback_key_ = key;
+
+  double time = display_.GetTime();
+  playback_position_ += playback_speed_ * (time - playback_time_);
+  playback_time_ = time;
+  playback_position_ = std::max(0.0, std::min<double>(
+      playback_position_, player_->GetMovesNumber()));
+  int32_t move = static_cast<int32_t>(playback_position_);
+  if (move == player_->GetMove())
+    return;
+  if (move != player_->GetMove() + 1
+      || std::fabs(playback_speed_) > kMaxAnimatedSpeed) {
+    player_->Seek(move);
+    ShowPlayback();
+    return;
+  }
+
+  /* the animation of the move comes before its spawn arises */
+  std::unique_ptr<GameLogic> moved = player_->GetLogic().Clone();
+  moved->ResetStates();
+  moved->Move(player_->GetReplay().turns[player_->GetMove()].direction);
+  animation_ = Animation(*moved);
+  player_->Step();
+  const Replay::Spawn& spawn =
+      player_->GetReplay().turns[player_->GetMove() - 1].spawn;
+  if (spawn.cell >= 0) {
+    int32_t row = spawn.cell / moved->GetColumns();
+    int32_t column = spawn.cell % moved->GetColumns();
+    animation_.AddTile(GameLogic::TileInfo(spawn.tile, TileStates::kArising),
+                       row, column);
+  }
+  animation_.Start();
+  snapshots_.Publish(player_->GetLogic(), player_->GetMove(),
+                     player_->GetScore());
+  state_ = States::kMoving;
+}
 
 Keys Engine::GetPressedKey() {
   if (display_.IsKeyPressed(Keys::kKeyLeft))
@@ -15,39 +277,121 @@ Keys Engine::GetPressedKey() {
     return Keys::kKeyUp;
   if (display_.IsKeyPressed(Keys::kKeyDown))
     return Keys::kKeyDown;
+  if (display_.IsKeyPressed(Keys::kKeyUndo))
+    return Keys::kKeyUndo;
   return Keys::kNoKey;
 }
 
-void Engine::Move() {
-  switch (key_pressed_) {
+Keys Engine::GetAutoplayKey() {
+  Directions move;
+  if (!advisor_->TryGetMove(&move))
+    return Keys::kNoKey;
+  Keys key = GetKey(move);
+  if (key == Keys::kNoKey)
+    state_ = States::kFail;
+  return key;
+}
+
+Keys Engine::GetKey(Directions direction) {
+  switch (direction) {
+    case Directions::kLeft:
+      return Keys::kKeyLeft;
+    case Directions::kRight:
+      return Keys::kKeyRight;
+    case Directions::kUp:
+      return Keys::kKeyUp;
+    case Directions::kDown:
+      return Keys::kKeyDown;
+    default:
+      return Keys::kNoKey;
+  }
+}
+
+void Engine::RequestAdvice() {
+  if (!advisor_ && !hinter_)
+    return;
+  Board board = Board::FromMatrix(logic_->GetMatrix());
+  if (advisor_)
+    advisor_->Request(board);
+  if (hinter_)
+    hinter_->Request(board);
+}
+
+Directions Engine::GetDirection(Keys key) {
+  switch (key) {
     case Keys::kKeyLeft:
-      logic_.MoveLeft();
-      break;
+      return Directions::kLeft;
     case Keys::kKeyRight:
-      logic_.MoveRight();
-      break;
+      return Directions::kRight;
     case Keys::kKeyUp:
-      logic_.MoveUp();
-      break;
+      return Directions::kUp;
     case Keys::kKeyDown:
-      logic_.MoveDown();
-      break;
+      return Directions::kDown;
     default:
-      throw std::runtime_error("no key pressed => no moving");
+      return Directions::kNone;
   }
 }
 
+void Engine::Move(GameLogic& logic, Keys key) {
+  Directions direction = GetDirection(key);
+  if (direction == Directions::kNone)
+    throw std::runtime_error("no key pressed => no moving");
+  logic.Move(direction);
+}
+
 void Engine::Turn() {
-  key_pressed_ = GetPressedKey();
-  if (key_pressed_ == Keys::kNoKey)
+  if (player_) {
+    PlayBackTurn();
+    return;
+  }
+  key_pressed_ = advisor_ ? GetAutoplayKey() : GetPressedKey();
+  /* one move back per press however long the key is held */
+  bool undo = key_pressed_ == Keys::kKeyUndo;
+  if (undo && !undo_held_)
+    Undo();
+  undo_held_ = undo;
+  if (key_pressed_ == Keys::kNoKey || undo)
     return;
-  Move();
-  if (logic_.HasSomethingChanged())
-    logic_.NewTile();
+  if (outcomes_.empty())
+    PrecomputeOutcomes();
+  Outcome& outcome = outcomes_[static_cast<int32_t>(key_pressed_) - 1];
+  bool changed = outcome.changed;
+  logic_ = std::move(outcome.logic);
+  animation_ = std::move(outcome.animation);
+  outcomes_.clear();
+  if (changed) {
+    moves_++;
+    score_ += logic_->GetMoveScore();
+    logic_->NewTile();
+    int32_t row = logic_->GetNewTileRow();
+    int32_t column = logic_->GetNewTileColumn();
+    Replay::Spawn spawn = {-1, Tiles::kNoTile};
+    if (row >= 0) {
+      animation_.AddTile(logic_->GetTile(row, column), row, column);
+      spawn = {row * logic_->GetColumns() + column,
+               logic_->GetTile(row, column).value};
+    }
+    replay_.turns.push_back({GetDirection(key_pressed_), spawn});
+    replay_.score = score_;
+    /* kept as the game goes, so that saving it does not replay it */
+    if (replay_.turns.size() % replay_.keyframe_interval == 0)
+      replay_.keyframes.push_back(Replay::MakeKeyframe(*logic_, score_));
+    snapshots_.Publish(*logic_, moves_, score_);
+    Save();
+  }
+  animation_.Start();
   state_ = States::kMoving;
-  const std::vector<std::vector<Logic::TileInfo>>&
-      logic_matrix = logic_.GetMatrix();
-  animation_ = Animation(logic_matrix);
+  RequestAdvice();
+}
+
+void Engine::PrecomputeOutcomes() {
+  outcomes_.clear();
+  for (Keys key : kMoveKeys) {
+    std::unique_ptr<GameLogic> logic = logic_->Clone();
+    Move(*logic, key);
+    bool changed = logic->HasSomethingChanged();
+    outcomes_.emplace_back(std::move(logic), changed);
+  }
 }
 
 void Engine::Draw() {
@@ -72,6 +416,9 @@ void Engine::Draw() {
     }
     display_.DrawTile(current_row, current_column, tile.value, tile.opacity);
   }
+  Directions hint;
+  if (hinter_ && state_ == States::kTurn && hinter_->TryGetMove(&hint))
+    display_.DrawHint(GetKey(hint));
 }
 
 void Engine::UpdateMoving() {
@@ -85,11 +432,22 @@ void Engine::UpdateMoving() {
 void Engine::UpdateArising() {
   animation_.UpdateArising();
   if (animation_.IsArisingFinished()) {
-    if (logic_.IsGameOver()) {
-      state_ = (logic_.IsSuccess() ? States::kSuccess : States::kFail);
+    if (player_) {
+      state_ = States::kTurn;
+    } else if (logic_->IsGameOver()) {
+      state_ = (logic_->IsSuccess() ? States::kSuccess : States::kFail);
+      Finish();
     } else {
       state_ = States::kTurn;
-      logic_.ResetStates();
+      logic_->ResetStates();
+      PrecomputeOutcomes();
+      if (std::none_of(outcomes_.begin(), outcomes_.end(),
+                       [](const Outcome& outcome) {
+                         return outcome.changed;
+                       })) {
+        state_ = States::kFail;
+        Finish();
+      }
     }
   }
 }
@@ -119,4 +477,8 @@ void Engine::MainLoop() {
     Draw();
     display_.Render();
   }
+  if (recorder_) {
+    recorder_->Write(replay_);
+    recorder_->Close();
+  }
 }
@@ -1,22 +1,64 @@
 #ifndef _2048_ENGINE_ENGINE_H_
 #define _2048_ENGINE_ENGINE_H_
 
+#include "logic/game_logic.h"
 #include "logic/logic.h"
+#include "logic/snapshot.h"
+#include "logic/spawn_distribution.h"
 #include "display/display.h"
 #include "animation/animation.h"
+#include "ai/advisor.h"
+#include "ai/strategy.h"
+#include "replay/replay.h"
+#include "replay/replay_player.h"
+#include "replay/replay_writer.h"
+#include "save/autosaver.h"
+#include "scores/score_store.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 class Engine {
  public:
-  Engine(int32_t length)
-      : logic_(length)
-      , animation_(logic_.GetMatrix())
-      , state_(States::kArising)
-      , key_pressed_(Keys::kNoKey) {
-    Draw();
-  }
+  /* without a strategy the moves come from the keyboard */
+  Engine(int32_t length, std::unique_ptr<Strategy> autoplay = nullptr,
+         const SpawnDistribution& spawns = SpawnDistribution());
 
   void MainLoop();
 
+  /* for a human player: the strategy searches every settled board in the
+   * background and an arrow shows its move once it is found */
+  void ShowHints(std::unique_ptr<Strategy> strategy);
+
+  /* appends the game to the replay file at path when the window closes */
+  void Record(const std::string& path);
+
+  /* continues the game saved at path, false if there is none for the
+   * board */
+  bool Resume(const std::string& path);
+
+  /* keeps the game saved at path after every move and removes the save
+   * once the game is over; Z or backspace take back the last move */
+  void AutoSave(const std::string& path);
+
+  /* adds the result of the game to the scores of profile in directory
+   * once it is won or no move is left */
+  void KeepScores(const std::string& directory, const std::string& profile);
+
+  /* shows a recorded game instead: the right and left keys play it
+   * forward and backward, up and down double and halve the speed; slow
+   * forward moves are animated, the rest jumps through keyframes */
+  void PlayBack(Replay replay);
+
+  /* the state after the last turn, for readers on other threads */
+  const SnapshotPublisher& GetSnapshots() const {
+    return snapshots_;
+  }
+
  private:
   enum class States {
     kTurn,
@@ -26,18 +68,72 @@ class Engine {
     kArising,
   };
 
+  /* result of one move computed ahead of the key press, without the spawn */
+  struct Outcome {
+    Outcome(std::unique_ptr<GameLogic> a_logic, bool a_changed)
+        : logic(std::move(a_logic))
+        , animation(*logic)
+        , changed(a_changed) {}
+
+    std::unique_ptr<GameLogic> logic;
+    Animation animation;
+    bool changed;
+  };
+
+  static constexpr Keys kMoveKeys[] = {
+    Keys::kKeyUp, Keys::kKeyDown, Keys::kKeyLeft, Keys::kKeyRight,
+  };
+
+  /* playback speeds in moves per second */
+  static constexpr double kPlaybackSpeed = 2;
+  static constexpr double kMinPlaybackSpeed = 0.25;
+  static constexpr double kMaxPlaybackSpeed = 1 << 16;
+  static constexpr double kMaxAnimatedSpeed = 4;
+
   Keys GetPressedKey();
-  void Move();
+  Keys GetAutoplayKey();
+  static Keys GetKey(Directions direction);
+  void RequestAdvice();
+  static void Move(GameLogic& logic, Keys key);
+  static Directions GetDirection(Keys key);
+  void PrecomputeOutcomes();
   void Draw();
   void Turn();
+  void Undo();
+  void Save();
+  void Finish();
+  void PlayBackTurn();
+  void ShowPlayback();
   void UpdateArising();
   void UpdateMoving();
 
-  Logic logic_;
+  uint64_t seed_;
+  std::unique_ptr<GameLogic> logic_;
   Display display_;
   Animation animation_;
   States state_;
   Keys key_pressed_;
+  std::vector<Outcome> outcomes_;
+  std::unique_ptr<Advisor> advisor_;
+  std::unique_ptr<Advisor> hinter_;
+  uint64_t moves_;
+  uint64_t score_;
+  /* the display time the game would have started at without breaks */
+  double start_time_;
+  SnapshotPublisher snapshots_;
+  Replay replay_;
+  std::unique_ptr<ReplayWriter> recorder_;
+  std::unique_ptr<AutoSaver> saver_;
+  /* turns of replay_ the saver already has */
+  size_t saved_turns_;
+  std::unique_ptr<ScoreStore> scores_;
+  bool undo_held_;
+  std::unique_ptr<ReplayPlayer> player_;
+  /* moves per second, negative backward */
+  double playback_speed_;
+  double playback_position_;
+  double playback_time_;
+  Keys playback_key_;
 };
 
 #endif
@@ -0,0 +1,90 @@
+#include "enumerator/delta_file.h"
+
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+DeltaWriter::DeltaWriter(const std::string& path)
+    : path_(path)
+    , out_(path, std::ios::binary)
+    , previous_(0)
+    , bytes_(0)
+    , count_(0) {
+  if (!out_)
+    throw std::runtime_error("cannot create " + path);
+  buffer_.reserve(kBufferSize);
+}
+
+DeltaWriter::~DeltaWriter() {
+  if (out_.is_open()) {
+    try {
+      Close();
+    } catch (...) {}
+  }
+}
+
+void DeltaWriter::Write(uint64_t value) {
+  if (count_ && value < previous_)
+    throw std::runtime_error("values written to " + path_ + " are unsorted");
+  uint64_t delta = value - previous_;
+  previous_ = value;
+  count_++;
+  if (buffer_.size() + 10 > kBufferSize)
+    Flush();
+  while (delta >= 0x80) {
+    buffer_.push_back(static_cast<char>(delta | 0x80));
+    delta >>= 7;
+  }
+  buffer_.push_back(static_cast<char>(delta));
+}
+
+void DeltaWriter::Flush() {
+  out_.write(buffer_.data(), buffer_.size());
+  bytes_ += buffer_.size();
+  buffer_.clear();
+  if (!out_)
+    throw std::runtime_error("cannot write " + path_);
+}
+
+void DeltaWriter::Close() {
+  Flush();
+  out_.close();
+}
+
+DeltaReader::DeltaReader(const std::string& path)
+    : path_(path)
+    , in_(path, std::ios::binary)
+    , buffer_(kBufferSize)
+    , position_(0)
+    , size_(0)
+    , previous_(0) {
+  if (!in_)
+    throw std::runtime_error("cannot open " + path);
+}
+
+bool DeltaReader::Fill() {
+  in_.read(buffer_.data(), buffer_.size());
+  size_ = in_.gcount();
+  position_ = 0;
+  return size_ > 0;
+}
+
+bool DeltaReader::Read(uint64_t* value) {
+  uint64_t delta = 0;
+  for (int32_t shift = 0;; shift += 7) {
+    if (position_ == size_ && !Fill()) {
+      if (shift)
+        throw std::runtime_error(path_ + " is truncated");
+      return false;
+    }
+    uint8_t byte = buffer_[position_++];
+    delta |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+      break;
+  }
+  previous_ += delta;
+  *value = previous_;
+  return true;
+}
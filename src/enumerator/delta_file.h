@@ -0,0 +1,60 @@
+#ifndef _2048_ENUMERATOR_DELTA_FILE_H_
+#define _2048_ENUMERATOR_DELTA_FILE_H_
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/* Sorted sequence of 64-bit values stored as varint encoded deltas
+ * (7 bits per byte, high bit set on all bytes but the last). */
+class DeltaWriter {
+ public:
+  explicit DeltaWriter(const std::string& path);
+  ~DeltaWriter();
+
+  void Write(uint64_t value);
+
+  void Close();
+
+  int64_t GetBytes() const {
+    return bytes_;
+  }
+
+  int64_t GetCount() const {
+    return count_;
+  }
+
+ private:
+  static constexpr size_t kBufferSize = 1 << 20;
+
+  void Flush();
+
+  std::string path_;
+  std::ofstream out_;
+  std::vector<char> buffer_;
+  uint64_t previous_;
+  int64_t bytes_;
+  int64_t count_;
+};
+
+class DeltaReader {
+ public:
+  explicit DeltaReader(const std::string& path);
+
+  bool Read(uint64_t* value);
+
+ private:
+  static constexpr size_t kBufferSize = 1 << 20;
+
+  bool Fill();
+
+  std::string path_;
+  std::ifstream in_;
+  std::vector<char> buffer_;
+  size_t position_;
+  size_t size_;
+  uint64_t previous_;
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "enumerator/delta_file.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string GetPath() {
+  return ::testing::TempDir() + "2048_delta_file_test.bin";
+}
+
+std::vector<uint64_t> RoundTrip(const std::vector<uint64_t>& values,
+                                int64_t* bytes) {
+  std::string path = GetPath();
+  {
+    DeltaWriter writer(path);
+    for (uint64_t value : values)
+      writer.Write(value);
+    writer.Close();
+    EXPECT_EQ(static_cast<int64_t>(values.size()), writer.GetCount());
+    *bytes = writer.GetBytes();
+  }
+  std::vector<uint64_t> read;
+  DeltaReader reader(path);
+  uint64_t value = 0;
+  while (reader.Read(&value))
+    read.push_back(value);
+  std::remove(path.c_str());
+  return read;
+}
+
+}  // namespace
+
+TEST(DeltaFileTest, RoundTripsNothing) {
+  int64_t bytes = -1;
+  EXPECT_TRUE(RoundTrip({}, &bytes).empty());
+  EXPECT_EQ(0, bytes);
+}
+
+/* an equal value is a zero delta, one byte */
+TEST(DeltaFileTest, RoundTripsEqualValues) {
+  std::vector<uint64_t> values(100, 12345);
+  values.insert(values.begin(), 0);
+  int64_t bytes = 0;
+  EXPECT_EQ(values, RoundTrip(values, &bytes));
+  EXPECT_EQ(1 + 2 + 99, bytes);
+}
+
+/* the largest delta takes all ten bytes, the top bit alone in the last */
+TEST(DeltaFileTest, RoundTripsTheLargestDelta) {
+  constexpr uint64_t kMax = std::numeric_limits<uint64_t>::max();
+  int64_t bytes = 0;
+  EXPECT_EQ(std::vector<uint64_t>({kMax}), RoundTrip({kMax}, &bytes));
+  EXPECT_EQ(10, bytes);
+  std::vector<uint64_t> values = {0, kMax, kMax};
+  EXPECT_EQ(values, RoundTrip(values, &bytes));
+  EXPECT_EQ(1 + 10 + 1, bytes);
+}
+
+/* more values than one buffer holds, so the reads refill across varints */
+TEST(DeltaFileTest, RoundTripsManyValues) {
+  std::mt19937_64 rng(1);
+  std::vector<uint64_t> values(600000);
+  uint64_t value = 0;
+  for (uint64_t& v : values) {
+    value += rng() >> (24 + rng() % 40);
+    v = value;
+  }
+  int64_t bytes = 0;
+  EXPECT_EQ(values, RoundTrip(values, &bytes));
+}
+
+TEST(DeltaFileTest, RejectsUnsortedValues) {
+  std::string path = GetPath();
+  {
+    DeltaWriter writer(path);
+    writer.Write(5);
+    EXPECT_THROW(writer.Write(4), std::runtime_error);
+  }
+  std::remove(path.c_str());
+}
+
+TEST(DeltaFileTest, ReportsTruncation) {
+  std::string path = GetPath();
+  {
+    std::ofstream out(path, std::ios::binary);
+    out.put(static_cast<char>(0x81));
+  }
+  DeltaReader reader(path);
+  uint64_t value = 0;
+  EXPECT_THROW(reader.Read(&value), std::runtime_error);
+  std::remove(path.c_str());
+}
@@ -0,0 +1,178 @@
+#include "enumerator/enumerator.h"
+#include "enumerator/delta_file.h"
+#include "enumerator/radix_sort.h"
+#include "ai/board.h"
+#include "logic/logic.h"
+#include "parallel/parallel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr Directions kMoves[] = {
+  Directions::kLeft, Directions::kRight, Directions::kUp, Directions::kDown,
+};
+
+/* the radix sort needs a scratch copy of the children buffer */
+constexpr int64_t kBytesPerChild = 2 * sizeof(uint64_t);
+
+/* a position has at most 4 moves with at most 15 empty cells each */
+constexpr int64_t kMaxChildren = 4 * 15;
+
+}  // namespace
+
+std::string Enumerator::GetLayerPath(int32_t sum) const {
+  return options_.directory + "/layer_" + std::to_string(sum) + ".bin";
+}
+
+std::string Enumerator::GetRunPath(int32_t run) const {
+  return options_.directory + "/run_" + std::to_string(run) + ".tmp";
+}
+
+void Enumerator::WriteRun(std::vector<uint64_t>& children,
+                          std::vector<uint64_t>& scratch,
+                          LayerStatistics& statistics) const {
+  RadixSort(children, scratch, options_.threads);
+  DeltaWriter writer(GetRunPath(statistics.runs++));
+  for (size_t i = 0; i < children.size(); i++)
+    if (!i || children[i] != children[i - 1])
+      writer.Write(children[i]);
+  writer.Close();
+  children.clear();
+}
+
+void Enumerator::MergeRuns(LayerStatistics& statistics) const {
+  using Head = std::pair<uint64_t, int32_t>;
+  std::vector<std::unique_ptr<DeltaReader>> readers;
+  std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+  for (int32_t run = 0; run < statistics.runs; run++) {
+    readers.emplace_back(new DeltaReader(GetRunPath(run)));
+    uint64_t value;
+    if (readers.back()->Read(&value))
+      heads.emplace(value, run);
+  }
+
+  DeltaWriter writer(GetLayerPath(statistics.sum));
+  uint64_t last = 0;
+  while (!heads.empty()) {
+    Head head = heads.top();
+    heads.pop();
+    if (!writer.GetCount() || head.first != last) {
+      writer.Write(head.first);
+      last = head.first;
+    }
+    uint64_t value;
+    if (readers[head.second]->Read(&value))
+      heads.emplace(value, head.second);
+  }
+  writer.Close();
+  statistics.positions = writer.GetCount();
+  statistics.bytes = writer.GetBytes();
+  readers.clear();
+  for (int32_t run = 0; run < statistics.runs; run++)
+    std::remove(GetRunPath(run).c_str());
+}
+
+Enumerator::LayerStatistics Enumerator::ExpandLayer(int32_t sum) const {
+  auto start = std::chrono::steady_clock::now();
+  LayerStatistics statistics;
+  statistics.sum = sum + 2;
+
+  size_t capacity = std::max(kMaxChildren,
+                             options_.memory_bytes / kBytesPerChild);
+  size_t block_size = std::max<size_t>(1, capacity / (4 * kMaxChildren));
+  int32_t threads_number = GetThreadsNumber(options_.threads);
+  std::vector<uint64_t> children, scratch, block;
+  children.reserve(capacity);
+  std::vector<std::vector<uint64_t>> outputs(threads_number);
+
+  DeltaReader reader(GetLayerPath(sum));
+  bool has_more = true;
+  while (has_more) {
+    block.clear();
+    uint64_t position;
+    while (block.size() < block_size && (has_more = reader.Read(&position)))
+      block.push_back(position);
+    ParallelFor(block.size(), 1 << 10, threads_number,
+                [&block, &outputs](size_t begin, size_t end,
+                                   int32_t thread_idx) {
+      std::vector<uint64_t>& output = outputs[thread_idx];
+      for (size_t k = begin; k < end; k++) {
+        Board board(block[k]);
+        for (Directions direction : kMoves) {
+          Board moved = board.Move(direction);
+          if (moved == board || moved.GetMaxTile() == Tiles::kTile_2048)
+            continue;
+          for (int32_t i = 0; i < Board::kLength; i++) {
+            for (int32_t j = 0; j < Board::kLength; j++) {
+              if (moved.GetTile(i, j) != Tiles::kNoTile)
+                continue;
+              Board child = moved;
+              child.SetTile(i, j, Logic::kInitialTile);
+              output.push_back(child.GetCells());
+            }
+          }
+        }
+      }
+    });
+    for (auto& output : outputs) {
+      statistics.generated += output.size();
+      if (children.size() + output.size() > capacity)
+        WriteRun(children, scratch, statistics);
+      children.insert(children.end(), output.begin(), output.end());
+      output.clear();
+    }
+  }
+  if (!children.empty() || !statistics.runs)
+    WriteRun(children, scratch, statistics);
+  MergeRuns(statistics);
+  statistics.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  return statistics;
+}
+
+void Enumerator::Run(
+    const std::function<void(const LayerStatistics&)>& on_layer) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<uint64_t> positions;
+  for (int32_t a = 0; a < Board::kLength * Board::kLength; a++) {
+    for (int32_t b = a + 1; b < Board::kLength * Board::kLength; b++) {
+      Board board;
+      board.SetTile(a / Board::kLength, a % Board::kLength,
+                    Logic::kInitialTile);
+      board.SetTile(b / Board::kLength, b % Board::kLength,
+                    Logic::kInitialTile);
+      positions.push_back(board.GetCells());
+    }
+  }
+  std::sort(positions.begin(), positions.end());
+
+  LayerStatistics statistics;
+  statistics.sum = 2 * static_cast<int32_t>(Logic::kInitialTilesNumber);
+  statistics.generated = positions.size();
+  DeltaWriter writer(GetLayerPath(statistics.sum));
+  for (uint64_t position : positions)
+    writer.Write(position);
+  writer.Close();
+  statistics.positions = writer.GetCount();
+  statistics.bytes = writer.GetBytes();
+  statistics.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  on_layer(statistics);
+
+  for (int32_t sum = statistics.sum; sum + 2 <= options_.max_sum; sum += 2) {
+    statistics = ExpandLayer(sum);
+    on_layer(statistics);
+    if (!statistics.positions)
+      break;
+  }
+}
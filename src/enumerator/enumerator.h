@@ -0,0 +1,51 @@
+#ifndef _2048_ENUMERATOR_ENUMERATOR_H_
+#define _2048_ENUMERATOR_ENUMERATOR_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/* Breadth-first enumeration of reachable 4x4 positions (packed boards the
+ * player has to move on) layer by layer of tile sum, with memory bounded
+ * by Options::memory_bytes. Children of a layer are collected in memory,
+ * radix sorted, deduplicated and spilled to disk as sorted runs; the runs
+ * are then merged into the next layer file. Layers and runs are stored
+ * with DeltaWriter. */
+class Enumerator {
+ public:
+  struct Options {
+    int32_t max_sum = 64;
+    int64_t memory_bytes = 1LL << 30;
+    int32_t threads = 0;
+    std::string directory = ".";
+  };
+
+  struct LayerStatistics {
+    int32_t sum = 0;
+    int64_t positions = 0;
+    int64_t bytes = 0;
+    int64_t generated = 0;
+    int32_t runs = 0;
+    double seconds = 0;
+  };
+
+  explicit Enumerator(const Options& options)
+      : options_(options) {}
+
+  /* on_layer is called after every finished layer */
+  void Run(const std::function<void(const LayerStatistics&)>& on_layer);
+
+  std::string GetLayerPath(int32_t sum) const;
+
+ private:
+  std::string GetRunPath(int32_t run) const;
+  void WriteRun(std::vector<uint64_t>& children, std::vector<uint64_t>& scratch,
+                LayerStatistics& statistics) const;
+  void MergeRuns(LayerStatistics& statistics) const;
+  LayerStatistics ExpandLayer(int32_t sum) const;
+
+  Options options_;
+};
+
+#endif
@@ -0,0 +1,56 @@
+#include "enumerator/radix_sort.h"
+#include "parallel/parallel.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+void RadixSort(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch,
+               int32_t threads_number) {
+  constexpr int32_t kRadix = 256;
+  size_t count = keys.size();
+  threads_number = GetThreadsNumber(threads_number);
+  size_t chunk_size = std::max<size_t>(1, (count + threads_number - 1)
+                                              / threads_number);
+  size_t chunks_number = (count + chunk_size - 1) / chunk_size;
+  scratch.resize(count);
+  std::vector<std::vector<size_t>> offsets(chunks_number,
+                                           std::vector<size_t>(kRadix));
+
+  for (int32_t shift = 0; shift < 64; shift += 8) {
+    ParallelFor(count, chunk_size, threads_number,
+                [&](size_t begin, size_t end, int32_t) {
+      std::vector<size_t>& histogram = offsets[begin / chunk_size];
+      std::fill(histogram.begin(), histogram.end(), 0);
+      for (size_t i = begin; i < end; i++)
+        histogram[(keys[i] >> shift) & 0xFF]++;
+    });
+    /* skip the pass if every key has the same byte */
+    bool is_trivial = false;
+    for (int32_t digit = 0; digit < kRadix; digit++) {
+      size_t total = 0;
+      for (const auto& histogram : offsets)
+        total += histogram[digit];
+      if (total == count)
+        is_trivial = true;
+    }
+    if (is_trivial)
+      continue;
+
+    size_t position = 0;
+    for (int32_t digit = 0; digit < kRadix; digit++) {
+      for (auto& histogram : offsets) {
+        size_t number = histogram[digit];
+        histogram[digit] = position;
+        position += number;
+      }
+    }
+    ParallelFor(count, chunk_size, threads_number,
+                [&](size_t begin, size_t end, int32_t) {
+      std::vector<size_t>& offset = offsets[begin / chunk_size];
+      for (size_t i = begin; i < end; i++)
+        scratch[offset[(keys[i] >> shift) & 0xFF]++] = keys[i];
+    });
+    keys.swap(scratch);
+  }
+}
@@ -0,0 +1,12 @@
+#ifndef _2048_ENUMERATOR_RADIX_SORT_H_
+#define _2048_ENUMERATOR_RADIX_SORT_H_
+
+#include <cstdint>
+#include <vector>
+
+/* LSD radix sort by bytes; every pass counts and scatters per thread.
+ * scratch is resized to keys.size() and reused between calls. */
+void RadixSort(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch,
+               int32_t threads_number);
+
+#endif
@@ -0,0 +1,49 @@
+#include "enumerator/radix_sort.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+TEST(RadixSortTest, SortsLikeStdSort) {
+  std::mt19937_64 rng(1);
+  for (size_t count : {0, 1, 2, 7, 1000, 100000}) {
+    for (int32_t threads_number : {1, 4}) {
+      SCOPED_TRACE(count * 10 + threads_number);
+      std::vector<uint64_t> keys(count), scratch;
+      for (uint64_t& key : keys)
+        key = rng();
+      std::vector<uint64_t> expected = keys;
+      std::sort(expected.begin(), expected.end());
+      RadixSort(keys, scratch, threads_number);
+      EXPECT_EQ(expected, keys);
+    }
+  }
+}
+
+/* every pass is skipped when all the keys are equal */
+TEST(RadixSortTest, KeepsEqualKeys) {
+  std::vector<uint64_t> keys(1000, 0x0123456789ABCDEFull), scratch;
+  std::vector<uint64_t> expected = keys;
+  RadixSort(keys, scratch, 4);
+  EXPECT_EQ(expected, keys);
+
+  /* and the passes on the bytes they share */
+  std::mt19937_64 rng(2);
+  for (uint64_t& key : keys)
+    key = 0xFFFF000000000000ull | (rng() % 4) << 24;
+  expected = keys;
+  std::sort(expected.begin(), expected.end());
+  RadixSort(keys, scratch, 4);
+  EXPECT_EQ(expected, keys);
+}
+
+TEST(RadixSortTest, SortsTheExtremes) {
+  constexpr uint64_t kMax = std::numeric_limits<uint64_t>::max();
+  std::vector<uint64_t> keys = {kMax, 0, kMax - 1, 1, kMax, 0}, scratch;
+  RadixSort(keys, scratch, 2);
+  EXPECT_EQ(std::vector<uint64_t>({0, 0, 1, kMax - 1, kMax, kMax}), keys);
+}
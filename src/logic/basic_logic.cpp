@@ -0,0 +1,35 @@
+#include "logic/basic_logic.h"
+#include "logic/merge_rules.h"
+
+template class BasicLogic<3, 3, PowerOfTwoMerge>;
+template class BasicLogic<3, 4, PowerOfTwoMerge>;
+template class BasicLogic<3, 5, PowerOfTwoMerge>;
+template class BasicLogic<3, 6, PowerOfTwoMerge>;
+template class BasicLogic<4, 3, PowerOfTwoMerge>;
+template class BasicLogic<4, 4, PowerOfTwoMerge>;
+template class BasicLogic<4, 5, PowerOfTwoMerge>;
+template class BasicLogic<4, 6, PowerOfTwoMerge>;
+template class BasicLogic<5, 3, PowerOfTwoMerge>;
+template class BasicLogic<5, 4, PowerOfTwoMerge>;
+template class BasicLogic<5, 5, PowerOfTwoMerge>;
+template class BasicLogic<5, 6, PowerOfTwoMerge>;
+template class BasicLogic<6, 3, PowerOfTwoMerge>;
+template class BasicLogic<6, 4, PowerOfTwoMerge>;
+template class BasicLogic<6, 5, PowerOfTwoMerge>;
+template class BasicLogic<6, 6, PowerOfTwoMerge>;
+template class BasicLogic<3, 3, FibonacciMerge>;
+template class BasicLogic<3, 4, FibonacciMerge>;
+template class BasicLogic<3, 5, FibonacciMerge>;
+template class BasicLogic<3, 6, FibonacciMerge>;
+template class BasicLogic<4, 3, FibonacciMerge>;
+template class BasicLogic<4, 4, FibonacciMerge>;
+template class BasicLogic<4, 5, FibonacciMerge>;
+template class BasicLogic<4, 6, FibonacciMerge>;
+template class BasicLogic<5, 3, FibonacciMerge>;
+template class BasicLogic<5, 4, FibonacciMerge>;
+template class BasicLogic<5, 5, FibonacciMerge>;
+template class BasicLogic<5, 6, FibonacciMerge>;
+template class BasicLogic<6, 3, FibonacciMerge>;
+template class BasicLogic<6, 4, FibonacciMerge>;
+template class BasicLogic<6, 5, FibonacciMerge>;
+template class BasicLogic<6, 6, FibonacciMerge>;
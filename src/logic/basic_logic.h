@@ -0,0 +1,271 @@
+#ifndef _2048_LOGIC_BASIC_LOGIC_H_
+#define _2048_LOGIC_BASIC_LOGIC_H_
+
+#include "display/display.h"
+#include "logic/game_logic.h"
+#include "logic/merge_rules.h"
+#include "logic/spawn_distribution.h"
+#include "logic/spawn_rng.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+/* Game rules for a Rows x Columns board and a merge rule fixed at compile
+ * time. The cells of every line, in the order a move visits them, come
+ * from constexpr tables, so the line kernel runs over compile time bounds
+ * instead of transposing the board. Tile states, sources and spawns follow
+ * Logic exactly. */
+template <int32_t Rows, int32_t Columns, class MergeRule = PowerOfTwoMerge>
+class BasicLogic : public GameLogic {
+ public:
+  static constexpr int32_t kCellsNumber = Rows * Columns;
+
+  explicit BasicLogic(const SpawnDistribution& spawns = SpawnDistribution(),
+                      uint64_t seed = std::random_device()())
+      : free_(kCellsNumber)
+      , game_over_(false)
+      , success_(false)
+      , new_tile_row_(-1)
+      , new_tile_column_(-1)
+      , spawns_(spawns)
+      , rng_(seed) {
+    for (size_t i = 0; i < kInitialTilesNumber; i++)
+      NewTile();
+  }
+
+  std::unique_ptr<GameLogic> Clone() const override {
+    return std::unique_ptr<GameLogic>(new BasicLogic(*this));
+  }
+
+  int32_t GetRows() const override {
+    return Rows;
+  }
+
+  int32_t GetColumns() const override {
+    return Columns;
+  }
+
+  std::vector<std::vector<TileInfo>> GetMatrix() const override {
+    std::vector<std::vector<TileInfo>> matrix(Rows);
+    for (int32_t i = 0; i < Rows; i++)
+      matrix[i].assign(tiles_.begin() + i * Columns,
+                       tiles_.begin() + (i + 1) * Columns);
+    return matrix;
+  }
+
+  const TileInfo& GetTile(int32_t row, int32_t column) const override {
+    return tiles_[row * Columns + column];
+  }
+
+  void GetCells(uint64_t* words) const override {
+    std::fill(words, words + (kCellsNumber + 15) / 16, 0);
+    PackTiles(tiles_.data(), kCellsNumber, 0, words);
+  }
+
+  bool IsGameOver() const override {
+    return game_over_;
+  }
+
+  bool IsSuccess() const override {
+    return success_;
+  }
+
+  int32_t GetNewTileRow() const override {
+    return new_tile_row_;
+  }
+
+  int32_t GetNewTileColumn() const override {
+    return new_tile_column_;
+  }
+
+  const SpawnRng& GetRng() const override {
+    return rng_;
+  }
+
+  void SetRng(const SpawnRng& rng) override {
+    rng_ = rng;
+  }
+
+  void NewTile() override {
+    new_tile_row_ = new_tile_column_ = -1;
+    if (!free_) {
+      game_over_ = true;
+      return;
+    }
+    int32_t number = rng_() % free_;
+    for (int32_t cell = 0; cell < kCellsNumber; cell++) {
+      if (tiles_[cell].value != Tiles::kNoTile || number--)
+        continue;
+      new_tile_row_ = cell / Columns;
+      new_tile_column_ = cell % Columns;
+      spawned_.push_back(cell);
+      tiles_[cell] = TileInfo(spawns_.Sample(rng_), TileStates::kArising,
+                              Directions::kNone, new_tile_row_,
+                              new_tile_column_);
+      free_--;
+      return;
+    }
+  }
+
+  void SetTile(int32_t row, int32_t column, Tiles value) override {
+    TileInfo& tile = tiles_[row * Columns + column];
+    free_ += (value == Tiles::kNoTile) - (tile.value == Tiles::kNoTile);
+    tile = TileInfo(value);
+  }
+
+  void MoveLeft() override {
+    MoveLines(kLines.left, Directions::kLeft, false);
+  }
+
+  void MoveRight() override {
+    MoveLines(kLines.right, Directions::kRight, true);
+  }
+
+  void MoveUp() override {
+    MoveLines(kLines.up, Directions::kUp, false);
+  }
+
+  void MoveDown() override {
+    MoveLines(kLines.down, Directions::kDown, true);
+  }
+
+  /* states are left only on the targets of the last move and on the
+   * tiles spawned since the last call */
+  void ResetStates() override {
+    for (const MoveEvent& event : events_)
+      ResetTile(tiles_[event.to]);
+    for (int32_t cell : spawned_)
+      ResetTile(tiles_[cell]);
+    events_.clear();
+    spawned_.clear();
+  }
+
+ private:
+  /* cells of every row and column, starting from the side tiles move to */
+  struct Lines {
+    int32_t left[Rows][Columns];
+    int32_t right[Rows][Columns];
+    int32_t up[Columns][Rows];
+    int32_t down[Columns][Rows];
+  };
+
+  static constexpr Lines MakeLines() {
+    Lines lines{};
+    for (int32_t i = 0; i < Rows; i++) {
+      for (int32_t j = 0; j < Columns; j++) {
+        lines.left[i][j] = i * Columns + j;
+        lines.right[i][j] = i * Columns + Columns - 1 - j;
+        lines.up[j][i] = i * Columns + j;
+        lines.down[j][i] = (Rows - 1 - i) * Columns + j;
+      }
+    }
+    return lines;
+  }
+
+  static constexpr Lines kLines = MakeLines();
+
+  template <int32_t LinesNumber, int32_t Length>
+  void MoveLines(const int32_t (&lines)[LinesNumber][Length],
+                 Directions direction, bool reversed) {
+    events_.clear();
+    for (int32_t i = 0; i < LinesNumber; i++)
+      MoveLine(lines[i], direction, reversed);
+  }
+
+  /* one pass merging and compacting a line; sources are coordinates along
+   * the line as Logic reports them */
+  template <int32_t Length>
+  void MoveLine(const int32_t (&line)[Length], Directions direction,
+                bool reversed) {
+    int32_t written = 0, last_source = 0;
+    bool can_merge = false, last_moved = false;
+    for (int32_t k = 0; k < Length; k++) {
+      TileInfo tile = tiles_[line[k]];
+      if (tile.value == Tiles::kNoTile)
+        continue;
+      int32_t source = reversed ? Length - 1 - k : k;
+      tiles_[line[k]] = TileInfo(Tiles::kNoTile);
+      TileInfo& previous = tiles_[line[written ? written - 1 : 0]];
+      if (can_merge && MergeRule::CanMerge(previous.value, tile.value)) {
+        Tiles result = MergeRule::Merge(previous.value, tile.value);
+        if (result == MergeRule::kWinningTile)
+          game_over_ = success_ = true;
+        if (last_moved)
+          events_.back().merged = true;
+        else
+          events_.push_back(MoveEvent{line[written - 1], line[written - 1],
+                                      previous.value, true});
+        events_.push_back(MoveEvent{line[k], line[written - 1], tile.value,
+                                    true});
+        previous = TileInfo(result, TileStates::kMerging, direction, source,
+                            last_source);
+        free_++;
+        can_merge = false;
+        continue;
+      }
+      last_moved = written != k;
+      if (last_moved) {
+        tile = TileInfo(tile.value, TileStates::kMoving, direction, source);
+        events_.push_back(MoveEvent{line[k], line[written], tile.value,
+                                    false});
+      }
+      tiles_[line[written++]] = tile;
+      last_source = source;
+      can_merge = true;
+    }
+  }
+
+  std::array<TileInfo, kCellsNumber> tiles_;
+  int32_t free_;
+  bool game_over_;
+  bool success_;
+  int32_t new_tile_row_;
+  int32_t new_tile_column_;
+  /* cells NewTile filled since the last ResetStates */
+  std::vector<int32_t> spawned_;
+  SpawnDistribution spawns_;
+  SpawnRng rng_;
+};
+
+template <int32_t Rows, int32_t Columns, class MergeRule>
+constexpr typename BasicLogic<Rows, Columns, MergeRule>::Lines
+    BasicLogic<Rows, Columns, MergeRule>::kLines;
+
+extern template class BasicLogic<3, 3, PowerOfTwoMerge>;
+extern template class BasicLogic<3, 4, PowerOfTwoMerge>;
+extern template class BasicLogic<3, 5, PowerOfTwoMerge>;
+extern template class BasicLogic<3, 6, PowerOfTwoMerge>;
+extern template class BasicLogic<4, 3, PowerOfTwoMerge>;
+extern template class BasicLogic<4, 4, PowerOfTwoMerge>;
+extern template class BasicLogic<4, 5, PowerOfTwoMerge>;
+extern template class BasicLogic<4, 6, PowerOfTwoMerge>;
+extern template class BasicLogic<5, 3, PowerOfTwoMerge>;
+extern template class BasicLogic<5, 4, PowerOfTwoMerge>;
+extern template class BasicLogic<5, 5, PowerOfTwoMerge>;
+extern template class BasicLogic<5, 6, PowerOfTwoMerge>;
+extern template class BasicLogic<6, 3, PowerOfTwoMerge>;
+extern template class BasicLogic<6, 4, PowerOfTwoMerge>;
+extern template class BasicLogic<6, 5, PowerOfTwoMerge>;
+extern template class BasicLogic<6, 6, PowerOfTwoMerge>;
+extern template class BasicLogic<3, 3, FibonacciMerge>;
+extern template class BasicLogic<3, 4, FibonacciMerge>;
+extern template class BasicLogic<3, 5, FibonacciMerge>;
+extern template class BasicLogic<3, 6, FibonacciMerge>;
+extern template class BasicLogic<4, 3, FibonacciMerge>;
+extern template class BasicLogic<4, 4, FibonacciMerge>;
+extern template class BasicLogic<4, 5, FibonacciMerge>;
+extern template class BasicLogic<4, 6, FibonacciMerge>;
+extern template class BasicLogic<5, 3, FibonacciMerge>;
+extern template class BasicLogic<5, 4, FibonacciMerge>;
+extern template class BasicLogic<5, 5, FibonacciMerge>;
+extern template class BasicLogic<5, 6, FibonacciMerge>;
+extern template class BasicLogic<6, 3, FibonacciMerge>;
+extern template class BasicLogic<6, 4, FibonacciMerge>;
+extern template class BasicLogic<6, 5, FibonacciMerge>;
+extern template class BasicLogic<6, 6, FibonacciMerge>;
+
+#endif
@@ -0,0 +1,105 @@
+#include "logic/game_logic.h"
+#include "logic/basic_logic.h"
+#include "logic/large_logic.h"
+#include "logic/logic.h"
+#include "logic/merge_rules.h"
+#include "logic/spawn_distribution.h"
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+constexpr Tiles GameLogic::kInitialTile;
+constexpr size_t GameLogic::kInitialTilesNumber;
+
+namespace {
+
+template <int32_t Rows, class MergeRule>
+std::unique_ptr<GameLogic> CreateBasic(int32_t columns,
+                                       const SpawnDistribution& spawns,
+                                       uint64_t seed) {
+  switch (columns) {
+    case 3:
+      return std::unique_ptr<GameLogic>(
+          new BasicLogic<Rows, 3, MergeRule>(spawns, seed));
+    case 4:
+      return std::unique_ptr<GameLogic>(
+          new BasicLogic<Rows, 4, MergeRule>(spawns, seed));
+    case 5:
+      return std::unique_ptr<GameLogic>(
+          new BasicLogic<Rows, 5, MergeRule>(spawns, seed));
+    case 6:
+      return std::unique_ptr<GameLogic>(
+          new BasicLogic<Rows, 6, MergeRule>(spawns, seed));
+    default:
+      return nullptr;
+  }
+}
+
+template <class MergeRule>
+std::unique_ptr<GameLogic> CreateBasic(int32_t rows, int32_t columns,
+                                       const SpawnDistribution& spawns,
+                                       uint64_t seed) {
+  switch (rows) {
+    case 3:
+      return CreateBasic<3, MergeRule>(columns, spawns, seed);
+    case 4:
+      return CreateBasic<4, MergeRule>(columns, spawns, seed);
+    case 5:
+      return CreateBasic<5, MergeRule>(columns, spawns, seed);
+    case 6:
+      return CreateBasic<6, MergeRule>(columns, spawns, seed);
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace
+
+std::unique_ptr<GameLogic> GameLogic::Create(int32_t rows, int32_t columns,
+                                             MergeRules rule,
+                                             const SpawnDistribution& spawns,
+                                             uint64_t seed) {
+  std::unique_ptr<GameLogic> logic = rule == MergeRules::kFibonacci
+      ? CreateBasic<FibonacciMerge>(rows, columns, spawns, seed)
+      : CreateBasic<PowerOfTwoMerge>(rows, columns, spawns, seed);
+  if (logic)
+    return logic;
+  if (rule != MergeRules::kPowerOfTwo || rows != columns || rows < 2)
+    throw std::runtime_error("no logic for a " + std::to_string(rows) + "x"
+                             + std::to_string(columns) + " board");
+  if (rows >= LargeLogic::kMinLength)
+    return std::unique_ptr<GameLogic>(new LargeLogic(rows, spawns, seed));
+  return std::unique_ptr<GameLogic>(new Logic(rows, spawns, seed));
+}
+
+int64_t GameLogic::GetMoveScore() const {
+  int64_t score = 0;
+  for (size_t i = 0; i < events_.size(); i++) {
+    if (!events_[i].merged)
+      continue;
+    score += static_cast<int64_t>(1) << static_cast<int32_t>(events_[i].value);
+    i++;
+  }
+  return score;
+}
+
+void GameLogic::Move(Directions direction) {
+  switch (direction) {
+    case Directions::kLeft:
+      MoveLeft();
+      break;
+    case Directions::kRight:
+      MoveRight();
+      break;
+    case Directions::kUp:
+      MoveUp();
+      break;
+    case Directions::kDown:
+      MoveDown();
+      break;
+    default:
+      throw std::runtime_error("no direction => no moving");
+  }
+}
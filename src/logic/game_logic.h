@@ -0,0 +1,148 @@
+#ifndef _2048_LOGIC_GAME_LOGIC_H_
+#define _2048_LOGIC_GAME_LOGIC_H_
+
+#include "display/display.h"
+#include "logic/spawn_distribution.h"
+#include "logic/spawn_rng.h"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+enum class TileStates {
+  kDefault,
+  kMoving,
+  kMerging,
+  kArising,
+  kDying,
+};
+
+enum class Directions {
+  kLeft,
+  kRight,
+  kUp,
+  kDown,
+  kNone,
+};
+
+enum class MergeRules {
+  kPowerOfTwo,
+  kFibonacci,
+};
+
+/* Game rules as seen by the engine. Logic implements them for any square
+ * board at run time, BasicLogic for sizes and merge rules fixed at compile
+ * time; Create picks the specialized one when it is instantiated, which
+ * covers every board of 3 to 6 rows and 3 to 6 columns. Other rectangular
+ * boards and the Fibonacci rule outside that range are rejected. */
+class GameLogic {
+ public:
+  struct TileInfo {
+    TileInfo(Tiles a_value = Tiles::kNoTile,
+             TileStates a_state = TileStates::kDefault,
+             Directions a_direction = Directions::kNone,
+             int32_t a_source_1 = 0, int32_t a_source_2 = 0)
+        : value(a_value)
+        , state(a_state)
+        , direction(a_direction)
+        , source_1(a_source_1)
+        , source_2(a_source_2) {}
+
+    Tiles value;
+    TileStates state;
+    Directions direction;
+    int32_t source_1;
+    int32_t source_2;
+  };
+
+  /* a tile sliding from cell from to cell to in the last move, a cell being
+   * row * columns + column; both tiles of a merge get one, next to each
+   * other, the one already in place with from == to */
+  struct MoveEvent {
+    int32_t from;
+    int32_t to;
+    Tiles value;
+    bool merged;
+  };
+
+  static constexpr Tiles kInitialTile = Tiles::kTile_2;
+  static constexpr size_t kInitialTilesNumber = 2;
+
+  virtual ~GameLogic() {}
+
+  static std::unique_ptr<GameLogic> Create(
+      int32_t rows, int32_t columns,
+      MergeRules rule = MergeRules::kPowerOfTwo,
+      const SpawnDistribution& spawns = SpawnDistribution(),
+      uint64_t seed = std::random_device()());
+
+  virtual std::unique_ptr<GameLogic> Clone() const = 0;
+
+  virtual int32_t GetRows() const = 0;
+  virtual int32_t GetColumns() const = 0;
+
+  virtual std::vector<std::vector<TileInfo>> GetMatrix() const = 0;
+  virtual const TileInfo& GetTile(int32_t row, int32_t column) const = 0;
+  /* the tile values one nibble per cell in row-major order, 16 cells per
+   * word, read straight from the board storage; words has to hold
+   * (rows * columns + 15) / 16 of them */
+  virtual void GetCells(uint64_t* words) const = 0;
+
+  virtual bool IsGameOver() const = 0;
+  virtual bool IsSuccess() const = 0;
+
+  /* position of the tile placed by the last NewTile, -1 if none was placed */
+  virtual int32_t GetNewTileRow() const = 0;
+  virtual int32_t GetNewTileColumn() const = 0;
+
+  /* the spawn stream, to save a game and resume it */
+  virtual const SpawnRng& GetRng() const = 0;
+  virtual void SetRng(const SpawnRng& rng) = 0;
+
+  virtual void NewTile() = 0;
+  virtual void SetTile(int32_t row, int32_t column, Tiles value) = 0;
+  virtual void MoveLeft() = 0;
+  virtual void MoveRight() = 0;
+  virtual void MoveUp() = 0;
+  virtual void MoveDown() = 0;
+  /* clears the states, directions and sources the last move and the spawns
+   * since left behind; call it before every move, or the tiles that move
+   * does not touch keep the states of the moves before */
+  virtual void ResetStates() = 0;
+
+  void Move(Directions direction);
+
+  /* what the last move did, in O(changed tiles); every move reuses the
+   * buffer and ResetStates empties it */
+  const std::vector<MoveEvent>& GetMoveEvents() const {
+    return events_;
+  }
+
+  bool HasSomethingChanged() const {
+    return !events_.empty();
+  }
+
+  /* points of the last move under the power of two rule: each merge
+   * scores the value of the tile it makes */
+  int64_t GetMoveScore() const;
+
+ protected:
+  static void ResetTile(TileInfo& tile) {
+    tile.state = TileStates::kDefault;
+    tile.direction = Directions::kNone;
+    tile.source_1 = tile.source_2 = 0;
+  }
+
+  /* ORs the values of count tiles on the cells from cell on into words */
+  static void PackTiles(const TileInfo* tiles, int64_t count, int64_t cell,
+                        uint64_t* words) {
+    for (int64_t k = 0; k < count; k++, cell++)
+      words[cell / 16] |= static_cast<uint64_t>(tiles[k].value)
+          << (4 * (cell % 16));
+  }
+
+  std::vector<MoveEvent> events_;
+};
+
+#endif
@@ -0,0 +1,459 @@
+#include "logic/large_logic.h"
+#include "display/display.h"
+#include "logic/game_logic.h"
+#include "logic/spawn_distribution.h"
+#include "parallel/parallel.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+constexpr int32_t LargeLogic::kMinLength;
+constexpr double LargeLogic::kDenseFillRatio;
+constexpr double LargeLogic::kSparseFillRatio;
+constexpr int32_t LargeLogic::kParallelMinLength;
+constexpr int32_t LargeLogic::kBlockLines;
+
+namespace {
+
+/* whole cache lines per row, so that a block of columns starts on a cache
+ * line in every row and no two threads write one */
+int64_t GetStride(int32_t length) {
+  int64_t stride = length;
+  while (stride * sizeof(GameLogic::TileInfo) % kCacheLineSize)
+    stride++;
+  return stride;
+}
+
+}  // namespace
+
+LargeLogic::LargeLogic(int32_t length, const SpawnDistribution& spawns,
+                       uint64_t seed)
+    : length_(length)
+    , stride_(GetStride(length))
+    , sparse_(true)
+    , rows_(length)
+    , columns_(length)
+    , threads_number_(0)
+    , dirty_overflow_(false)
+    , free_(static_cast<int64_t>(length) * length)
+    , game_over_(false)
+    , success_(false)
+    , new_tile_row_(-1)
+    , new_tile_column_(-1)
+    , spawns_(spawns)
+    , rng_(seed) {
+  if (length < 2)
+    throw std::runtime_error("board length must be at least 2");
+  if (static_cast<int64_t>(length) * length
+      > std::numeric_limits<int32_t>::max())
+    throw std::runtime_error("board cells do not fit move events");
+  for (size_t i = 0; i < kInitialTilesNumber; i++)
+    NewTile();
+}
+
+std::vector<std::vector<GameLogic::TileInfo>> LargeLogic::GetMatrix() const {
+  std::vector<std::vector<TileInfo>> matrix(length_,
+                                            std::vector<TileInfo>(length_));
+  for (int32_t i = 0; i < length_; i++) {
+    if (!sparse_) {
+      std::copy(tiles_.begin() + GetIndex(i, 0),
+                tiles_.begin() + GetIndex(i, length_), matrix[i].begin());
+      continue;
+    }
+    for (const Cell& cell : rows_[i])
+      matrix[i][cell.position] = cell.tile;
+  }
+  return matrix;
+}
+
+const GameLogic::TileInfo& LargeLogic::GetTile(int32_t row,
+                                               int32_t column) const {
+  static const TileInfo kEmptyTile;
+  if (!sparse_)
+    return tiles_[GetIndex(row, column)];
+  const Line& line = rows_[row];
+  auto it = std::lower_bound(line.begin(), line.end(), column,
+                             [](const Cell& cell, int32_t position) {
+    return cell.position < position;
+  });
+  return it != line.end() && it->position == column ? it->tile : kEmptyTile;
+}
+
+/* row by row past the padding, or only the occupied cells of a sparse
+ * board */
+void LargeLogic::GetCells(uint64_t* words) const {
+  int64_t cells = static_cast<int64_t>(length_) * length_;
+  std::fill(words, words + (cells + 15) / 16, 0);
+  for (int32_t i = 0; i < length_; i++) {
+    int64_t first = static_cast<int64_t>(i) * length_;
+    if (!sparse_) {
+      PackTiles(&tiles_[GetIndex(i, 0)], length_, first, words);
+      continue;
+    }
+    for (const Cell& cell : rows_[i])
+      PackTiles(&cell.tile, 1, first + cell.position, words);
+  }
+}
+
+void LargeLogic::NewTile() {
+  new_tile_row_ = new_tile_column_ = -1;
+  if (!free_) {
+    game_over_ = true;
+    return;
+  }
+  int64_t number = rng_() % free_;
+  for (int32_t i = 0; i < length_ && new_tile_row_ < 0; i++) {
+    int64_t empty = sparse_ ? length_ - static_cast<int64_t>(rows_[i].size())
+        : std::count_if(tiles_.begin() + GetIndex(i, 0),
+                        tiles_.begin() + GetIndex(i, length_),
+                        [](const TileInfo& tile) {
+            return tile.value == Tiles::kNoTile;
+          });
+    if (number >= empty) {
+      number -= empty;
+      continue;
+    }
+    int32_t column = -1;
+    if (sparse_) {
+      /* every occupied cell before the found one shifts it right */
+      column = number;
+      for (const Cell& cell : rows_[i]) {
+        if (cell.position > column)
+          break;
+        column++;
+      }
+    } else {
+      for (int32_t j = 0; j < length_ && column < 0; j++)
+        if (GetTile(i, j).value == Tiles::kNoTile && !number--)
+          column = j;
+    }
+    new_tile_row_ = i;
+    new_tile_column_ = column;
+  }
+  TileInfo tile(spawns_.Sample(rng_), TileStates::kArising, Directions::kNone,
+                new_tile_row_, new_tile_column_);
+  if (sparse_) {
+    SetCell(rows_[new_tile_row_], new_tile_column_, tile);
+    SetCell(columns_[new_tile_column_], new_tile_row_, tile);
+  } else {
+    tiles_[GetIndex(new_tile_row_, new_tile_column_)] = tile;
+  }
+  free_--;
+  MarkDirty(new_tile_row_ * length_ + new_tile_column_);
+  UpdateMode();
+}
+
+void LargeLogic::SetTile(int32_t row, int32_t column, Tiles value) {
+  free_ += (value == Tiles::kNoTile)
+      - (GetTile(row, column).value == Tiles::kNoTile);
+  if (sparse_) {
+    SetCell(rows_[row], column, TileInfo(value));
+    SetCell(columns_[column], row, TileInfo(value));
+  } else {
+    tiles_[GetIndex(row, column)] = TileInfo(value);
+  }
+  UpdateMode();
+}
+
+void LargeLogic::SetCell(Line& line, int32_t position, const TileInfo& tile) {
+  auto it = std::lower_bound(line.begin(), line.end(), position,
+                             [](const Cell& cell, int32_t position) {
+    return cell.position < position;
+  });
+  bool found = it != line.end() && it->position == position;
+  if (tile.value == Tiles::kNoTile) {
+    if (found)
+      line.erase(it);
+  } else if (found) {
+    it->tile = tile;
+  } else {
+    line.insert(it, Cell{position, tile});
+  }
+}
+
+LargeLogic::Cell* LargeLogic::FindCell(Line& line, int32_t position) {
+  auto it = std::lower_bound(line.begin(), line.end(), position,
+                             [](const Cell& cell, int32_t position) {
+    return cell.position < position;
+  });
+  return it != line.end() && it->position == position ? &*it : nullptr;
+}
+
+void LargeLogic::MoveLeft() {
+  ApplyMove(Directions::kLeft);
+}
+
+void LargeLogic::MoveRight() {
+  ApplyMove(Directions::kRight);
+}
+
+void LargeLogic::MoveUp() {
+  ApplyMove(Directions::kUp);
+}
+
+void LargeLogic::MoveDown() {
+  ApplyMove(Directions::kDown);
+}
+
+void LargeLogic::ApplyMove(Directions direction) {
+  events_.clear();
+  if (sparse_)
+    MoveSparse(direction);
+  else
+    MoveDense(direction);
+  if (success_)
+    game_over_ = true;
+  for (const MoveEvent& event : events_)
+    MarkDirty(event.to);
+  UpdateMode();
+}
+
+/* line holds the occupied cells in the order the move visits them and gets
+ * the result in the same order; sources are positions as Logic reports */
+LargeLogic::MoveResult LargeLogic::MoveLine(
+    Line& line, Directions direction, bool reversed, int32_t line_idx,
+    std::vector<MoveEvent>* events) const {
+  bool horizontal = direction == Directions::kLeft
+      || direction == Directions::kRight;
+  auto get_cell = [&](int32_t position) {
+    return horizontal ? line_idx * length_ + position
+                      : position * length_ + line_idx;
+  };
+  MoveResult result = {0, false};
+  size_t written = 0;
+  int32_t last_source = 0;
+  bool can_merge = false, last_moved = false;
+  for (size_t k = 0; k < line.size(); k++) {
+    Cell cell = line[k];
+    if (can_merge && line[written - 1].tile.value == cell.tile.value) {
+      int32_t to = get_cell(line[written - 1].position);
+      if (last_moved)
+        events->back().merged = true;
+      else
+        events->push_back(MoveEvent{to, to, cell.tile.value, true});
+      events->push_back(MoveEvent{get_cell(cell.position), to,
+                                  cell.tile.value, true});
+      Tiles value = static_cast<Tiles>(
+          static_cast<int32_t>(cell.tile.value) + 1);
+      if (value == Tiles::kTile_2048)
+        result.success = true;
+      line[written - 1].tile = TileInfo(value, TileStates::kMerging,
+                                        direction, cell.position,
+                                        last_source);
+      result.merges++;
+      can_merge = false;
+      continue;
+    }
+    int32_t position = reversed ? length_ - 1 - written : written;
+    last_moved = position != cell.position;
+    if (last_moved) {
+      cell.tile = TileInfo(cell.tile.value, TileStates::kMoving, direction,
+                           cell.position);
+      events->push_back(MoveEvent{get_cell(cell.position),
+                                  get_cell(position), cell.tile.value,
+                                  false});
+    }
+    last_source = cell.position;
+    cell.position = position;
+    line[written++] = cell;
+    can_merge = true;
+  }
+  line.resize(written);
+  return result;
+}
+
+void LargeLogic::MoveSparse(Directions direction) {
+  bool horizontal = direction == Directions::kLeft
+      || direction == Directions::kRight;
+  bool reversed = direction == Directions::kRight
+      || direction == Directions::kDown;
+  std::vector<Line>& lines = horizontal ? rows_ : columns_;
+  for (int32_t i = 0; i < length_; i++) {
+    Line& line = lines[i];
+    if (line.empty())
+      continue;
+    if (reversed)
+      std::reverse(line.begin(), line.end());
+    MoveResult result = MoveLine(line, direction, reversed, i, &events_);
+    free_ += result.merges;
+    success_ = success_ || result.success;
+    if (reversed)
+      std::reverse(line.begin(), line.end());
+  }
+  RebuildCrossLines(lines, horizontal ? &columns_ : &rows_);
+}
+
+void LargeLogic::RebuildCrossLines(const std::vector<Line>& lines,
+                                   std::vector<Line>* cross_lines) {
+  for (Line& cross_line : *cross_lines)
+    cross_line.clear();
+  for (size_t i = 0; i < lines.size(); i++)
+    for (const Cell& cell : lines[i])
+      (*cross_lines)[cell.position].push_back(
+          Cell{static_cast<int32_t>(i), cell.tile});
+}
+
+/* rows are contiguous and read one by one, columns are read a row of the
+ * block at a time so the block is still walked in memory order */
+LargeLogic::MoveResult LargeLogic::MoveBlock(Directions direction,
+                                             int32_t begin, int32_t end,
+                                             std::vector<Line>* lines,
+                                             std::vector<MoveEvent>* events) {
+  bool horizontal = direction == Directions::kLeft
+      || direction == Directions::kRight;
+  bool reversed = direction == Directions::kRight
+      || direction == Directions::kDown;
+  int64_t line_step = horizontal ? stride_ : 1;
+  int64_t cell_step = horizontal ? 1 : stride_;
+  lines->resize(end - begin);
+  auto gather = [&](int32_t i, int32_t k) {
+    int32_t position = reversed ? length_ - 1 - k : k;
+    TileInfo& tile = tiles_[i * line_step + position * cell_step];
+    if (tile.value == Tiles::kNoTile)
+      return;
+    (*lines)[i - begin].push_back(Cell{position, tile});
+    tile = TileInfo();
+  };
+  if (horizontal) {
+    for (int32_t i = begin; i < end; i++)
+      for (int32_t k = 0; k < length_; k++)
+        gather(i, k);
+  } else {
+    for (int32_t k = 0; k < length_; k++)
+      for (int32_t i = begin; i < end; i++)
+        gather(i, k);
+  }
+
+  MoveResult result = {0, false};
+  size_t longest = 0;
+  for (int32_t i = begin; i < end; i++) {
+    Line& line = (*lines)[i - begin];
+    MoveResult line_result = MoveLine(line, direction, reversed, i, events);
+    result.merges += line_result.merges;
+    result.success = result.success || line_result.success;
+    longest = std::max(longest, line.size());
+  }
+
+  auto scatter = [&](int32_t i, size_t k) {
+    const Line& line = (*lines)[i - begin];
+    if (k < line.size())
+      tiles_[i * line_step + line[k].position * cell_step] = line[k].tile;
+  };
+  if (horizontal) {
+    for (int32_t i = begin; i < end; i++)
+      for (size_t k = 0; k < longest; k++)
+        scatter(i, k);
+  } else {
+    for (size_t k = 0; k < longest; k++)
+      for (int32_t i = begin; i < end; i++)
+        scatter(i, k);
+  }
+  /* emptied, so that cloning the logic copies no scratch cells */
+  for (Line& line : *lines)
+    line.clear();
+  return result;
+}
+
+void LargeLogic::MoveDense(Directions direction) {
+  int32_t blocks_number = (length_ + kBlockLines - 1) / kBlockLines;
+  int32_t threads_number = length_ < kParallelMinLength ? 1
+      : GetThreadsNumber(threads_number_);
+  std::vector<MoveResult> results(blocks_number);
+  std::vector<std::vector<MoveEvent>> events(blocks_number);
+  if (static_cast<int32_t>(blocks_.size()) < threads_number)
+    blocks_.resize(threads_number);
+  ParallelFor(length_, kBlockLines, threads_number,
+              [&](size_t begin, size_t end, int32_t thread_idx) {
+    int32_t block = begin / kBlockLines;
+    results[block] = MoveBlock(direction, begin, end, &blocks_[thread_idx],
+                               &events[block]);
+  });
+  for (int32_t block = 0; block < blocks_number; block++) {
+    free_ += results[block].merges;
+    success_ = success_ || results[block].success;
+    events_.insert(events_.end(), events[block].begin(),
+                   events[block].end());
+  }
+}
+
+/* only the cells moves and spawns touched since the last call carry
+ * states, unless there were too many of them to track */
+void LargeLogic::ResetStates() {
+  events_.clear();
+  if (!dirty_overflow_) {
+    for (int32_t cell : dirty_)
+      ResetCell(cell);
+  } else if (!sparse_) {
+    for (TileInfo& tile : tiles_)
+      ResetTile(tile);
+  } else {
+    for (std::vector<Line>* lines : {&rows_, &columns_})
+      for (Line& line : *lines)
+        for (Cell& cell : line)
+          ResetTile(cell.tile);
+  }
+  dirty_.clear();
+  dirty_overflow_ = false;
+}
+
+void LargeLogic::MarkDirty(int32_t cell) {
+  if (dirty_overflow_)
+    return;
+  if (static_cast<int64_t>(dirty_.size())
+      >= static_cast<int64_t>(length_) * length_ - free_) {
+    dirty_overflow_ = true;
+    dirty_.clear();
+    return;
+  }
+  dirty_.push_back(cell);
+}
+
+void LargeLogic::ResetCell(int32_t cell) {
+  int32_t row = cell / length_, column = cell % length_;
+  if (!sparse_) {
+    ResetTile(tiles_[GetIndex(row, column)]);
+    return;
+  }
+  if (Cell* found = FindCell(rows_[row], column))
+    ResetTile(found->tile);
+  if (Cell* found = FindCell(columns_[column], row))
+    ResetTile(found->tile);
+}
+
+void LargeLogic::UpdateMode() {
+  double cells = static_cast<double>(length_) * length_;
+  double occupied = cells - free_;
+  if (sparse_ && occupied > kDenseFillRatio * cells)
+    ToDense();
+  else if (!sparse_ && occupied < kSparseFillRatio * cells)
+    ToSparse();
+}
+
+void LargeLogic::ToDense() {
+  tiles_.assign(length_ * stride_, TileInfo());
+  for (int32_t i = 0; i < length_; i++)
+    for (const Cell& cell : rows_[i])
+      tiles_[GetIndex(i, cell.position)] = cell.tile;
+  rows_ = std::vector<Line>();
+  columns_ = std::vector<Line>();
+  sparse_ = false;
+}
+
+void LargeLogic::ToSparse() {
+  rows_.assign(length_, Line());
+  columns_.assign(length_, Line());
+  for (int32_t i = 0; i < length_; i++) {
+    for (int32_t j = 0; j < length_; j++) {
+      const TileInfo& tile = tiles_[GetIndex(i, j)];
+      if (tile.value == Tiles::kNoTile)
+        continue;
+      rows_[i].push_back(Cell{j, tile});
+      columns_[j].push_back(Cell{i, tile});
+    }
+  }
+  tiles_ = DenseTiles();
+  sparse_ = true;
+}
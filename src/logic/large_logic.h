@@ -0,0 +1,157 @@
+#ifndef _2048_LOGIC_LARGE_LOGIC_H_
+#define _2048_LOGIC_LARGE_LOGIC_H_
+
+#include "display/display.h"
+#include "logic/game_logic.h"
+#include "logic/spawn_distribution.h"
+#include "logic/spawn_rng.h"
+#include "parallel/parallel.h"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+/* Rules for large square boards. A mostly empty board is kept sparse: the
+ * occupied cells of every row and of every column, sorted by position, so
+ * moves, merges and spawns cost O(length + occupied) instead of
+ * O(length^2). Past kDenseFillRatio the board switches to contiguous dense
+ * storage, and back once the fill drops under kSparseFillRatio. Dense
+ * boards of kParallelMinLength and more move blocks of kBlockLines lines on
+ * separate threads. Tile states, sources and spawns follow Logic exactly. */
+class LargeLogic : public GameLogic {
+ public:
+  static constexpr int32_t kMinLength = 16;
+  static constexpr double kDenseFillRatio = 0.25;
+  static constexpr double kSparseFillRatio = 0.125;
+  static constexpr int32_t kParallelMinLength = 512;
+  static constexpr int32_t kBlockLines = 64;
+
+  LargeLogic(int32_t length,
+             const SpawnDistribution& spawns = SpawnDistribution(),
+             uint64_t seed = std::random_device()());
+
+  std::unique_ptr<GameLogic> Clone() const override {
+    return std::unique_ptr<GameLogic>(new LargeLogic(*this));
+  }
+
+  int32_t GetRows() const override {
+    return length_;
+  }
+
+  int32_t GetColumns() const override {
+    return length_;
+  }
+
+  std::vector<std::vector<TileInfo>> GetMatrix() const override;
+  const TileInfo& GetTile(int32_t row, int32_t column) const override;
+  void GetCells(uint64_t* words) const override;
+
+  bool IsGameOver() const override {
+    return game_over_;
+  }
+
+  bool IsSuccess() const override {
+    return success_;
+  }
+
+  int32_t GetNewTileRow() const override {
+    return new_tile_row_;
+  }
+
+  int32_t GetNewTileColumn() const override {
+    return new_tile_column_;
+  }
+
+  const SpawnRng& GetRng() const override {
+    return rng_;
+  }
+
+  void SetRng(const SpawnRng& rng) override {
+    rng_ = rng;
+  }
+
+  bool IsSparse() const {
+    return sparse_;
+  }
+
+  /* zero means one thread per hardware thread */
+  void SetThreadsNumber(int32_t threads_number) {
+    threads_number_ = threads_number;
+  }
+
+  void NewTile() override;
+  void SetTile(int32_t row, int32_t column, Tiles value) override;
+  void MoveLeft() override;
+  void MoveRight() override;
+  void MoveUp() override;
+  void MoveDown() override;
+  void ResetStates() override;
+
+ private:
+  /* position is the column in a row line and the row in a column line */
+  struct Cell {
+    int32_t position;
+    TileInfo tile;
+  };
+
+  using Line = std::vector<Cell>;
+  using DenseTiles = std::vector<TileInfo, CacheAlignedAllocator<TileInfo>>;
+
+  /* reduced per block of lines and merged in block order */
+  struct MoveResult {
+    int64_t merges;
+    bool success;
+  };
+
+  /* blocks start on a cache line whichever direction the lines run: rows
+   * are padded to whole cache lines and so are kBlockLines columns */
+  static_assert(kBlockLines * sizeof(TileInfo) % kCacheLineSize == 0,
+                "blocks must cover whole cache lines");
+
+  int64_t GetIndex(int32_t row, int32_t column) const {
+    return row * stride_ + column;
+  }
+
+  void ApplyMove(Directions direction);
+  MoveResult MoveLine(Line& line, Directions direction, bool reversed,
+                      int32_t line_idx,
+                      std::vector<MoveEvent>* events) const;
+  MoveResult MoveBlock(Directions direction, int32_t begin, int32_t end,
+                       std::vector<Line>* lines,
+                       std::vector<MoveEvent>* events);
+  void MoveDense(Directions direction);
+  void MoveSparse(Directions direction);
+  static void RebuildCrossLines(const std::vector<Line>& lines,
+                                std::vector<Line>* cross_lines);
+  static void SetCell(Line& line, int32_t position, const TileInfo& tile);
+  static Cell* FindCell(Line& line, int32_t position);
+  void MarkDirty(int32_t cell);
+  void ResetCell(int32_t cell);
+  void UpdateMode();
+  void ToDense();
+  void ToSparse();
+
+  int32_t length_;
+  /* dense row length, padded to whole cache lines */
+  int64_t stride_;
+  bool sparse_;
+  DenseTiles tiles_;
+  std::vector<Line> rows_;
+  std::vector<Line> columns_;
+  std::vector<std::vector<Line>> blocks_;
+  int32_t threads_number_;
+  /* cells whose states ResetStates has to clear, unless there were more
+   * of them than tiles */
+  std::vector<int32_t> dirty_;
+  bool dirty_overflow_;
+  int64_t free_;
+  bool game_over_;
+  bool success_;
+  int32_t new_tile_row_;
+  int32_t new_tile_column_;
+  SpawnDistribution spawns_;
+  SpawnRng rng_;
+};
+
+#endif
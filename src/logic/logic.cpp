@@ -1,26 +1,34 @@
 #include "logic/logic.h"
 #include "display/display.h"
+#include "logic/spawn_distribution.h"
 
 #include <stdexcept>
 #include <cstdint>
 #include <vector>
-#include <cstdlib>
 #include <iostream>
-#include <ctime>
 #include <algorithm>
 
-Logic::Logic(int32_t length)
+Logic::Logic(int32_t length, const SpawnDistribution& spawns, uint64_t seed)
     : length_(length)
-    , tile_matrix_(length, std::vector<TileInfo>(length,
-                                              TileInfo(Tiles::kNoTile)))
+    , tiles_(length * length, TileInfo(Tiles::kNoTile))
     , free_(length_ * length_)
     , game_over_(false)
-    , success_(false) {
-  srand(time(NULL));
+    , success_(false)
+    , new_tile_row_(-1)
+    , new_tile_column_(-1)
+    , spawns_(spawns)
+    , rng_(seed) {
   for (size_t i = 0; i < kInitialTilesNumber; i++)
     NewTile();
 }
 
+std::vector<std::vector<GameLogic::TileInfo>> Logic::GetMatrix() const {
+  std::vector<std::vector<TileInfo>> matrix;
+  for (auto row = tiles_.begin(); row != tiles_.end(); row += length_)
+    matrix.emplace_back(row, row + length_);
+  return matrix;
+}
+
 static Tiles GetNextTile(Tiles tile) {
   if (tile == Tiles::kTile_2048)
     throw std::runtime_error("next tile for 2048 is undefined");
@@ -31,26 +39,37 @@ static Tiles GetNextTile(Tiles tile) {
 }
 
 void Logic::NewTile() {
+  new_tile_row_ = new_tile_column_ = -1;
   if (!free_) {
     game_over_ = true;
     return;
   }
-  int32_t number = rand() % free_, count = -1;
+  int32_t number = rng_() % free_, count = -1;
   for (int32_t i = 0; i < length_; i++)
     for (int32_t j = 0; j < length_; j++) {
-      if (tile_matrix_[i][j].value == Tiles::kNoTile)
+      if (tiles_[i * length_ + j].value == Tiles::kNoTile)
         count++;
       if (count == number) {
-        tile_matrix_[i][j] = TileInfo(kInitialTile, TileStates::kArising,
-        Directions::kNone, i , j);
+        tiles_[i * length_ + j] = TileInfo(spawns_.Sample(rng_),
+                                           TileStates::kArising,
+                                           Directions::kNone, i, j);
+        new_tile_row_ = i;
+        new_tile_column_ = j;
+        spawned_.push_back(i * length_ + j);
         free_--;
         return;
       }
     }
 }
 
+void Logic::SetTile(int32_t row, int32_t column, Tiles value) {
+  TileInfo& tile = tiles_[row * length_ + column];
+  free_ += (value == Tiles::kNoTile) - (tile.value == Tiles::kNoTile);
+  tile = TileInfo(value);
+}
+
 void Logic::MergeLeft(int32_t row_idx) {
-  std::vector<TileInfo>& row = tile_matrix_[row_idx];
+  TileInfo* row = &tiles_[row_idx * length_];
   for (int32_t from = 1, to = 0; from < length_; from++) {
     if (row[from].value == Tiles::kNoTile)
       continue;
@@ -61,6 +80,7 @@ void Logic::MergeLeft(int32_t row_idx) {
     Tiles result = GetNextTile(row[to].value);
     if (result == Tiles::kTile_2048)
       game_over_ = success_ = true;
+    AddMergeEvents(row_idx, from, to);
     row[to] = TileInfo(result, TileStates::kMerging,
                        Directions::kLeft, from, to);
     row[from] = TileInfo(Tiles::kNoTile);
@@ -69,38 +89,50 @@ void Logic::MergeLeft(int32_t row_idx) {
   }
 }
 
-void Logic::ShiftLeft(int32_t row_idx) {
-  std::vector<TileInfo>& row = tile_matrix_[row_idx];
-  int32_t from = 1, to = 0;
-  while (from < length_) {
-    if (row[from].value != Tiles::kNoTile) {
-      if (row[to].value == Tiles::kNoTile) {
-        if (row[from].state == TileStates::kMerging) {
-          row[to] = row[from];
-        } else {
-          row[to] = TileInfo(row[from].value, TileStates::kMoving,
-                             Directions::kLeft, from);
-        }
-        row[from] = TileInfo(Tiles::kNoTile);
-      }
-      if (to < from - 1) {
-        to++;
-        continue;
+/* compacts the row; merged tiles keep their states and carry their two
+ * events along, which MergeLeft added in the same order from
+ * merge_events on. A tile merged by this move is told by those events,
+ * since a state left from an earlier move without ResetStates may still
+ * say kMerging */
+void Logic::ShiftLeft(int32_t row_idx, size_t merge_events) {
+  TileInfo* row = &tiles_[row_idx * length_];
+  int32_t base = row_idx * length_;
+  size_t merge_end = events_.size();
+  for (int32_t from = 0, to = 0; from < length_; from++) {
+    if (row[from].value == Tiles::kNoTile)
+      continue;
+    bool merged = merge_events < merge_end
+        && events_[merge_events].to == base + from;
+    if (from != to) {
+      if (merged) {
+        row[to] = row[from];
+      } else {
+        row[to] = TileInfo(row[from].value, TileStates::kMoving,
+                           Directions::kLeft, from);
+        events_.push_back(MoveEvent{base + from, base + to, row[to].value,
+                                    false});
       }
+      row[from] = TileInfo(Tiles::kNoTile);
+    }
+    if (merged) {
+      events_[merge_events].to = events_[merge_events + 1].to = base + to;
+      merge_events += 2;
     }
-    from++;
+    to++;
   }
 }
 
 void Logic::MoveLeft() {
-  for (size_t i = 0; i < tile_matrix_.size(); i++) {
+  events_.clear();
+  for (int32_t i = 0; i < length_; i++) {
+    size_t merge_events = events_.size();
     MergeLeft(i);
-    ShiftLeft(i);
+    ShiftLeft(i, merge_events);
   }
 }
 
 void Logic::MergeRight(int32_t row_idx) {
-  std::vector<TileInfo>& row = tile_matrix_[row_idx];
+  TileInfo* row = &tiles_[row_idx * length_];
   for (int32_t from = length_ - 2, to = length_ - 1; from >= 0; from--) {
     if (row[from].value == Tiles::kNoTile)
       continue;
@@ -111,6 +143,7 @@ void Logic::MergeRight(int32_t row_idx) {
     Tiles result = GetNextTile(row[to].value);
     if (result == Tiles::kTile_2048)
       game_over_ = success_ = true;
+    AddMergeEvents(row_idx, from, to);
     row[to] = TileInfo(result, TileStates::kMerging,
                        Directions::kRight, from, to);
     row[from] = TileInfo(Tiles::kNoTile);
@@ -119,42 +152,64 @@ void Logic::MergeRight(int32_t row_idx) {
   }
 }
 
-void Logic::ShiftRight(int32_t row_idx) {
-  std::vector<TileInfo>& row = tile_matrix_[row_idx];
-  int32_t from = length_ - 2, to = length_ - 1;
-  while (from >= 0) {
-    if (row[from].value != Tiles::kNoTile) {
-      if (row[to].value == Tiles::kNoTile) {
+void Logic::ShiftRight(int32_t row_idx, size_t merge_events) {
+  TileInfo* row = &tiles_[row_idx * length_];
+  int32_t base = row_idx * length_;
+  size_t merge_end = events_.size();
+  for (int32_t from = length_ - 1, to = length_ - 1; from >= 0; from--) {
+    if (row[from].value == Tiles::kNoTile)
+      continue;
+    bool merged = merge_events < merge_end
+        && events_[merge_events].to == base + from;
+    if (from != to) {
+      if (merged) {
         row[to] = row[from];
-        if (row[from].state == TileStates::kMerging) {
-          row[to] = row[from];
-        } else {
-          row[to] = TileInfo(row[from].value, TileStates::kMoving,
-                             Directions::kRight, from);
-        }
-        row[from] = TileInfo(Tiles::kNoTile);
-      }
-      if (to > from + 1) {
-        to--;
-        continue;
+      } else {
+        row[to] = TileInfo(row[from].value, TileStates::kMoving,
+                           Directions::kRight, from);
+        events_.push_back(MoveEvent{base + from, base + to, row[to].value,
+                                    false});
       }
+      row[from] = TileInfo(Tiles::kNoTile);
+    }
+    if (merged) {
+      events_[merge_events].to = events_[merge_events + 1].to = base + to;
+      merge_events += 2;
     }
-    from--;
+    to--;
   }
 }
 
 void Logic::MoveRight() {
-  for (size_t i = 0; i < tile_matrix_.size(); i++) {
+  events_.clear();
+  for (int32_t i = 0; i < length_; i++) {
+    size_t merge_events = events_.size();
     MergeRight(i);
-    ShiftRight(i);
+    ShiftRight(i, merge_events);
+  }
+}
+
+/* the tile already in place first, both to where the pair is now; the
+ * shift moves them on with the merged tile */
+void Logic::AddMergeEvents(int32_t row_idx, int32_t from, int32_t to) {
+  int32_t base = row_idx * length_;
+  Tiles value = tiles_[base + to].value;
+  events_.push_back(MoveEvent{base + to, base + to, value, true});
+  events_.push_back(MoveEvent{base + from, base + to, value, true});
+}
+
+void Logic::TransposeEvents() {
+  for (MoveEvent& event : events_) {
+    event.from = event.from % length_ * length_ + event.from / length_;
+    event.to = event.to % length_ * length_ + event.to / length_;
   }
 }
 
 void Logic::Transpose() {
   for (int32_t i = 0; i < length_; i++) {
     for (int32_t j = i + 1; j < length_; j++) {
-      TileInfo& tile_i_j = tile_matrix_[i][j];
-      TileInfo& tile_j_i = tile_matrix_[j][i];
+      TileInfo& tile_i_j = tiles_[i * length_ + j];
+      TileInfo& tile_j_i = tiles_[j * length_ + i];
       if (tile_i_j.value == Tiles::kNoTile && tile_j_i.value == Tiles::kNoTile)
         continue;
       std::swap(tile_i_j, tile_j_i);
@@ -162,19 +217,19 @@ void Logic::Transpose() {
   }
 }
 
+/* only tiles that moved have a direction, each is the target of an event */
 void Logic::ChangeDirections() {
-  for (auto& row : tile_matrix_) {
-    for (auto& tile : row) {
-      switch (tile.direction) {
-        case Directions::kLeft:
-          tile.direction = Directions::kUp;
-          break;
-        case Directions::kRight:
-          tile.direction = Directions::kDown;
-          break;
-        default:
-          break;
-      }
+  for (const MoveEvent& event : events_) {
+    TileInfo& tile = tiles_[event.to];
+    switch (tile.direction) {
+      case Directions::kLeft:
+        tile.direction = Directions::kUp;
+        break;
+      case Directions::kRight:
+        tile.direction = Directions::kDown;
+        break;
+      default:
+        break;
     }
   }
 }
@@ -183,6 +238,7 @@ void Logic::MoveUp() {
   Transpose();
   MoveLeft();
   Transpose();
+  TransposeEvents();
   ChangeDirections();
 }
 
@@ -190,27 +246,17 @@ void Logic::MoveDown() {
   Transpose();
   MoveRight();
   Transpose();
+  TransposeEvents();
   ChangeDirections();
 }
 
+/* states are left only on the targets of the last move and on the tiles
+ * spawned since the last call */
 void Logic::ResetStates() {
-  for (int32_t i = 0; i < length_; i++) {
-    for (int32_t j = 0; j < length_; j++) {
-      TileInfo& tile = tile_matrix_[i][j];
-      tile.state = TileStates::kDefault;
-      tile.direction = Directions::kNone;
-      tile.source_1 = tile.source_2 = 0;
-    }
-  }
-}
-
-bool Logic::HasSomethingChanged() const {
-  for (const auto& row : tile_matrix_) {
-    for (const auto& tile : row) {
-      if (tile.state == TileStates::kMoving
-          || tile.state == TileStates::kMerging)
-        return true;
-    }
-  }
-  return false;
+  for (const MoveEvent& event : events_)
+    ResetTile(tiles_[event.to]);
+  for (int32_t cell : spawned_)
+    ResetTile(tiles_[cell]);
+  events_.clear();
+  spawned_.clear();
 }
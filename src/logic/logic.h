@@ -2,83 +2,101 @@
 #define _2048_LOGIC_LOGIC_H_
 
 #include "display/display.h"
+#include "logic/game_logic.h"
+#include "logic/spawn_distribution.h"
+#include "logic/spawn_rng.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <memory>
+#include <random>
 #include <vector>
 
-enum class TileStates {
-  kDefault,
-  kMoving,
-  kMerging,
-  kArising,
-  kDying,
-};
+/* Rules for a square board of any length, the reference implementation
+ * for the sizes BasicLogic is not instantiated for */
+class Logic : public GameLogic {
+ public:
+  Logic(int32_t length,
+        const SpawnDistribution& spawns = SpawnDistribution(),
+        uint64_t seed = std::random_device()());
 
-enum class Directions {
-  kLeft,
-  kRight,
-  kUp,
-  kDown,
-  kNone,
-};
+  std::unique_ptr<GameLogic> Clone() const override {
+    return std::unique_ptr<GameLogic>(new Logic(*this));
+  }
 
-class Logic {
- public:
-  struct TileInfo {
-    TileInfo(Tiles a_value, TileStates a_state = TileStates::kDefault,
-             Directions a_direction = Directions::kNone,
-             int32_t a_source_1 = 0, int32_t a_source_2 = 0)
-        : value(a_value)
-        , state(a_state)
-        , direction(a_direction)
-        , source_1(a_source_1)
-        , source_2(a_source_2) {}
-
-    Tiles value;
-    TileStates state;
-    Directions direction;
-    int32_t source_1;
-    int32_t source_2;
-  };
-
-  static constexpr Tiles kInitialTile = Tiles::kTile_2;
-  static constexpr size_t kInitialTilesNumber = 2;
-
-  Logic(int32_t length);
-
-  std::vector<std::vector<TileInfo>> GetMatrix() const {
-    return tile_matrix_;
+  int32_t GetRows() const override {
+    return length_;
   }
 
-  bool IsGameOver() const {
+  int32_t GetColumns() const override {
+    return length_;
+  }
+
+  std::vector<std::vector<TileInfo>> GetMatrix() const override;
+
+  bool IsGameOver() const override {
     return game_over_;
   }
 
-  int32_t IsSuccess() const {
+  bool IsSuccess() const override {
     return success_;
   }
 
-  void NewTile();
-  void MoveLeft();
-  void MoveRight();
-  void MoveUp();
-  void MoveDown();
-  void ResetStates();
-  bool HasSomethingChanged() const;
+  const TileInfo& GetTile(int32_t row, int32_t column) const override {
+    return tiles_[row * length_ + column];
+  }
+
+  void GetCells(uint64_t* words) const override {
+    std::fill(words, words + (tiles_.size() + 15) / 16, 0);
+    PackTiles(tiles_.data(), tiles_.size(), 0, words);
+  }
+
+  int32_t GetNewTileRow() const override {
+    return new_tile_row_;
+  }
+
+  int32_t GetNewTileColumn() const override {
+    return new_tile_column_;
+  }
+
+  const SpawnRng& GetRng() const override {
+    return rng_;
+  }
+
+  void SetRng(const SpawnRng& rng) override {
+    rng_ = rng;
+  }
+
+  void NewTile() override;
+  void SetTile(int32_t row, int32_t column, Tiles value) override;
+  void MoveLeft() override;
+  void MoveRight() override;
+  void MoveUp() override;
+  void MoveDown() override;
+  void ResetStates() override;
 
  private:
   void Transpose();
   void ChangeDirections();
+  void AddMergeEvents(int32_t row_idx, int32_t from, int32_t to);
+  void TransposeEvents();
   void MergeLeft(int32_t row_idx);
-  void ShiftLeft(int32_t row_idx);
+  void ShiftLeft(int32_t row_idx, size_t merge_events);
   void MergeRight(int32_t row_idx);
-  void ShiftRight(int32_t row_idx);
+  void ShiftRight(int32_t row_idx, size_t merge_events);
 
   int32_t length_;
-  std::vector<std::vector<TileInfo>> tile_matrix_;
+  /* row-major */
+  std::vector<TileInfo> tiles_;
   int32_t free_;
   bool game_over_;
   bool success_;
+  int32_t new_tile_row_;
+  int32_t new_tile_column_;
+  /* cells NewTile filled since the last ResetStates */
+  std::vector<int32_t> spawned_;
+  SpawnDistribution spawns_;
+  SpawnRng rng_;
 };
 
 #endif
@@ -0,0 +1,356 @@
+#include "logic/game_logic.h"
+#include "logic/large_logic.h"
+#include "logic/logic.h"
+#include "logic/merge_rules.h"
+#include "logic/spawn_distribution.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr Directions kDirections[] = {Directions::kLeft, Directions::kRight,
+                                      Directions::kUp, Directions::kDown};
+
+void ExpectSameTile(const GameLogic::TileInfo& expected,
+                    const GameLogic::TileInfo& actual) {
+  EXPECT_EQ(expected.value, actual.value);
+  EXPECT_EQ(expected.state, actual.state);
+  EXPECT_EQ(expected.direction, actual.direction);
+  EXPECT_EQ(expected.source_1, actual.source_1);
+  EXPECT_EQ(expected.source_2, actual.source_2);
+}
+
+/* the order of events is not part of the contract beyond the two tiles of
+ * a merge being next to each other, which GetMoveScore depends on */
+void ExpectSameEvents(std::vector<GameLogic::MoveEvent> expected,
+                      std::vector<GameLogic::MoveEvent> actual) {
+  auto order = [](const GameLogic::MoveEvent& a,
+                  const GameLogic::MoveEvent& b) {
+    return a.to != b.to ? a.to < b.to : a.from < b.from;
+  };
+  std::sort(expected.begin(), expected.end(), order);
+  std::sort(actual.begin(), actual.end(), order);
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(expected[i].from, actual[i].from);
+    EXPECT_EQ(expected[i].to, actual[i].to);
+    EXPECT_EQ(expected[i].value, actual[i].value);
+    EXPECT_EQ(expected[i].merged, actual[i].merged);
+  }
+}
+
+/* GetCells has to pack what GetTile reads and clear the words it does not
+ * set */
+void ExpectPackedCells(const GameLogic& logic) {
+  int64_t cells = static_cast<int64_t>(logic.GetRows()) * logic.GetColumns();
+  std::vector<uint64_t> words((cells + 15) / 16, ~0ULL);
+  logic.GetCells(words.data());
+  for (int64_t cell = 0; cell < cells; cell++) {
+    Tiles value = static_cast<Tiles>((words[cell / 16] >> (4 * (cell % 16)))
+                                     & 0xF);
+    ASSERT_EQ(logic.GetTile(cell / logic.GetColumns(),
+                            cell % logic.GetColumns()).value, value);
+  }
+  if (cells % 16) {
+    EXPECT_EQ(0u, words.back() >> (4 * (cells % 16)));
+  }
+}
+
+/* plays the same random moves on both, the way the engine does, and checks
+ * that tiles, events, spawns and the end of the game agree after each one */
+void ExpectSameGames(GameLogic& expected, GameLogic& actual, uint64_t seed,
+                     int32_t moves) {
+  std::mt19937_64 rng(seed);
+  for (int32_t k = 0; k < moves && !expected.IsGameOver(); k++) {
+    SCOPED_TRACE(k);
+    Directions direction = kDirections[rng() % 4];
+    for (GameLogic* logic : {&expected, &actual}) {
+      logic->ResetStates();
+      logic->Move(direction);
+      if (logic->HasSomethingChanged())
+        logic->NewTile();
+    }
+    ExpectSameEvents(expected.GetMoveEvents(), actual.GetMoveEvents());
+    EXPECT_EQ(expected.GetMoveScore(), actual.GetMoveScore());
+    EXPECT_EQ(expected.GetNewTileRow(), actual.GetNewTileRow());
+    EXPECT_EQ(expected.GetNewTileColumn(), actual.GetNewTileColumn());
+    ASSERT_EQ(expected.IsGameOver(), actual.IsGameOver());
+    ASSERT_EQ(expected.IsSuccess(), actual.IsSuccess());
+    for (int32_t i = 0; i < expected.GetRows(); i++)
+      for (int32_t j = 0; j < expected.GetColumns(); j++)
+        ExpectSameTile(expected.GetTile(i, j), actual.GetTile(i, j));
+    ExpectPackedCells(expected);
+    ExpectPackedCells(actual);
+    if (::testing::Test::HasFailure())
+      return;
+  }
+}
+
+std::vector<std::unique_ptr<GameLogic>> MakeLogics() {
+  std::vector<std::unique_ptr<GameLogic>> logics;
+  for (int32_t length : {3, 4, 6})
+    logics.push_back(GameLogic::Create(length, length));
+  logics.push_back(std::unique_ptr<GameLogic>(new Logic(4)));
+  logics.push_back(std::unique_ptr<GameLogic>(new Logic(7)));
+  logics.push_back(
+      std::unique_ptr<GameLogic>(new LargeLogic(LargeLogic::kMinLength)));
+  return logics;
+}
+
+}  // namespace
+
+/* a board filled through SetTile has to spawn into the one cell left free
+ * and end with the spawn after it, so SetTile has to keep count of the
+ * free cells both ways */
+TEST(LogicTest, SetTileKeepsFreeCells) {
+  for (auto& logic : MakeLogics()) {
+    int32_t rows = logic->GetRows(), columns = logic->GetColumns();
+    SCOPED_TRACE(rows);
+    for (int32_t i = 0; i < rows; i++)
+      for (int32_t j = 0; j < columns; j++)
+        logic->SetTile(i, j, Tiles::kTile_4);
+    logic->SetTile(rows - 1, 0, Tiles::kNoTile);
+    logic->SetTile(rows - 1, 0, Tiles::kNoTile);
+    logic->SetTile(0, columns - 1, Tiles::kTile_8);
+
+    logic->NewTile();
+    EXPECT_FALSE(logic->IsGameOver());
+    EXPECT_EQ(rows - 1, logic->GetNewTileRow());
+    EXPECT_EQ(0, logic->GetNewTileColumn());
+    EXPECT_EQ(GameLogic::kInitialTile, logic->GetTile(rows - 1, 0).value);
+
+    logic->NewTile();
+    EXPECT_TRUE(logic->IsGameOver());
+    EXPECT_EQ(-1, logic->GetNewTileRow());
+  }
+}
+
+TEST(LogicTest, BasicLogicPlaysLikeLogic) {
+  SpawnDistribution spawns = SpawnDistribution::Standard();
+  for (int32_t length = 3; length <= 6; length++) {
+    for (uint64_t seed = 0; seed < 20; seed++) {
+      SCOPED_TRACE(length * 100 + seed);
+      Logic expected(length, spawns, seed);
+      std::unique_ptr<GameLogic> actual =
+          GameLogic::Create(length, length, MergeRules::kPowerOfTwo, spawns,
+                            seed);
+      ExpectSameGames(expected, *actual, seed, 2000);
+    }
+  }
+}
+
+/* a move on a rectangular board is the transposed move on the transposed
+ * board */
+TEST(LogicTest, RectangularBoardsMoveLikeTransposed) {
+  const Directions transposed[] = {Directions::kUp, Directions::kDown,
+                                   Directions::kLeft, Directions::kRight};
+  for (int32_t rows = 3; rows <= 6; rows++) {
+    for (int32_t columns = 3; columns <= 6; columns++) {
+      SCOPED_TRACE(rows * 10 + columns);
+      std::unique_ptr<GameLogic> logic = GameLogic::Create(rows, columns);
+      std::unique_ptr<GameLogic> other = GameLogic::Create(columns, rows);
+      ASSERT_EQ(rows, logic->GetRows());
+      ASSERT_EQ(columns, logic->GetColumns());
+      for (int32_t i = 0; i < rows; i++) {
+        for (int32_t j = 0; j < columns; j++) {
+          logic->SetTile(i, j, Tiles::kNoTile);
+          other->SetTile(j, i, Tiles::kNoTile);
+        }
+      }
+      std::mt19937_64 rng(rows * 10 + columns);
+      for (int32_t k = 0; k < 500; k++) {
+        int32_t free = 0;
+        for (int32_t i = 0; i < rows; i++)
+          for (int32_t j = 0; j < columns; j++)
+            free += logic->GetTile(i, j).value == Tiles::kNoTile;
+        if (!free)
+          break;
+        /* the same spawn on both boards, in a free cell picked here */
+        int32_t number = rng() % free;
+        Tiles tile = rng() % 10 ? Tiles::kTile_2 : Tiles::kTile_4;
+        for (int32_t cell = 0; cell < rows * columns; cell++) {
+          int32_t i = cell / columns, j = cell % columns;
+          if (logic->GetTile(i, j).value != Tiles::kNoTile || number--)
+            continue;
+          logic->SetTile(i, j, tile);
+          other->SetTile(j, i, tile);
+          break;
+        }
+        int32_t direction = rng() % 4;
+        logic->ResetStates();
+        other->ResetStates();
+        logic->Move(kDirections[direction]);
+        other->Move(transposed[direction]);
+        ASSERT_EQ(logic->GetMoveEvents().size(),
+                  other->GetMoveEvents().size());
+        ASSERT_EQ(logic->GetMoveScore(), other->GetMoveScore());
+        for (int32_t i = 0; i < rows; i++)
+          for (int32_t j = 0; j < columns; j++)
+            ASSERT_EQ(logic->GetTile(i, j).value,
+                      other->GetTile(j, i).value);
+      }
+    }
+  }
+}
+
+/* the same random tiles on both boards, on about fill of the cells */
+void FillRandomly(GameLogic& expected, GameLogic& actual, uint64_t seed,
+                  double fill) {
+  std::mt19937_64 rng(seed);
+  std::bernoulli_distribution occupied(fill);
+  for (int32_t i = 0; i < expected.GetRows(); i++) {
+    for (int32_t j = 0; j < expected.GetColumns(); j++) {
+      Tiles tile = occupied(rng) ? static_cast<Tiles>(1 + rng() % 4)
+                                 : Tiles::kNoTile;
+      expected.SetTile(i, j, tile);
+      actual.SetTile(i, j, tile);
+    }
+  }
+  expected.ResetStates();
+  actual.ResetStates();
+}
+
+/* random games from boards filled on both sides of kDenseFillRatio, so
+ * that LargeLogic moves sparse and dense boards and switches between them */
+TEST(LogicTest, LargeLogicPlaysLikeLogic) {
+  SpawnDistribution spawns = SpawnDistribution::Standard();
+  int32_t length = LargeLogic::kMinLength;
+  int32_t switches = 0;
+  bool was_dense = false;
+  for (uint64_t seed = 0; seed < 6; seed++) {
+    SCOPED_TRACE(seed);
+    Logic expected(length, spawns, seed);
+    LargeLogic actual(length, spawns, seed);
+    if (seed)
+      FillRandomly(expected, actual, seed, 0.1 * seed);
+    for (int32_t k = 0; k < 2000 && !expected.IsGameOver(); k++) {
+      bool sparse = actual.IsSparse();
+      ExpectSameGames(expected, actual, seed * 10000 + k, 1);
+      if (::testing::Test::HasFailure())
+        return;
+      switches += sparse != actual.IsSparse();
+      was_dense |= !actual.IsSparse();
+    }
+  }
+  EXPECT_TRUE(was_dense);
+  EXPECT_GT(switches, 0);
+}
+
+/* dense boards of kParallelMinLength and more move their blocks on several
+ * threads and have to end up as the single threaded Logic, rows padded to
+ * cache lines or not */
+TEST(LogicTest, ParallelLargeLogicPlaysLikeLogic) {
+  for (int32_t length : {LargeLogic::kParallelMinLength,
+                         LargeLogic::kParallelMinLength + 5}) {
+    SCOPED_TRACE(length);
+    Logic expected(length, SpawnDistribution(), length);
+    LargeLogic actual(length, SpawnDistribution(), length);
+    actual.SetThreadsNumber(4);
+    FillRandomly(expected, actual, length, 0.5);
+    ASSERT_FALSE(actual.IsSparse());
+    ExpectSameGames(expected, actual, length, 8);
+  }
+}
+
+/* ResetStates only visits the cells the last move and the spawns since
+ * touched, which has to be enough to clear every tile */
+TEST(LogicTest, ResetStatesClearsEveryTile) {
+  for (auto& logic : MakeLogics()) {
+    SCOPED_TRACE(logic->GetRows());
+    std::mt19937_64 rng(logic->GetRows());
+    for (int32_t k = 0; k < 500 && !logic->IsGameOver(); k++) {
+      logic->ResetStates();
+      for (int32_t i = 0; i < logic->GetRows(); i++) {
+        for (int32_t j = 0; j < logic->GetColumns(); j++) {
+          const GameLogic::TileInfo& tile = logic->GetTile(i, j);
+          ASSERT_EQ(TileStates::kDefault, tile.state);
+          ASSERT_EQ(Directions::kNone, tile.direction);
+          ASSERT_EQ(0, tile.source_1);
+          ASSERT_EQ(0, tile.source_2);
+        }
+      }
+      logic->Move(kDirections[rng() % 4]);
+      if (logic->HasSomethingChanged())
+        logic->NewTile();
+    }
+  }
+}
+
+/* a move right after another one without ResetStates still has to tell
+ * its own merges from the kMerging states the first one left */
+TEST(LogicTest, MovesWithoutResetStatesReportTheirOwnEvents) {
+  for (auto& logic : MakeLogics()) {
+    int32_t rows = logic->GetRows(), columns = logic->GetColumns();
+    SCOPED_TRACE(rows);
+    for (int32_t i = 0; i < rows; i++)
+      for (int32_t j = 0; j < columns; j++)
+        logic->SetTile(i, j, Tiles::kNoTile);
+    logic->SetTile(0, 0, Tiles::kTile_2);
+    logic->SetTile(0, 1, Tiles::kTile_2);
+    logic->SetTile(1, 0, Tiles::kTile_4);
+    logic->SetTile(1, 1, Tiles::kTile_4);
+    logic->SetTile(2, 0, Tiles::kTile_2);
+    logic->SetTile(2, 1, Tiles::kTile_2);
+    logic->SetTile(2, 2, Tiles::kTile_4);
+    logic->ResetStates();
+    logic->MoveLeft();
+    ASSERT_TRUE(logic->HasSomethingChanged());
+
+    logic->MoveRight();
+    int32_t last = columns - 1, second = columns, third = 2 * columns;
+    ASSERT_TRUE(logic->HasSomethingChanged());
+    ExpectSameEvents({{0, last, Tiles::kTile_4, false},
+                      {second, second + last, Tiles::kTile_8, false},
+                      {third + 1, third + last, Tiles::kTile_4, true},
+                      {third, third + last, Tiles::kTile_4, true}},
+                     logic->GetMoveEvents());
+    EXPECT_EQ(8, logic->GetMoveScore());
+    EXPECT_EQ(Tiles::kTile_4, logic->GetTile(0, last).value);
+    EXPECT_EQ(TileStates::kMoving, logic->GetTile(0, last).state);
+    EXPECT_EQ(Tiles::kTile_8, logic->GetTile(1, last).value);
+    EXPECT_EQ(TileStates::kMoving, logic->GetTile(1, last).state);
+    EXPECT_EQ(Tiles::kTile_8, logic->GetTile(2, last).value);
+    EXPECT_EQ(TileStates::kMerging, logic->GetTile(2, last).state);
+    for (int32_t j = 0; j < last; j++)
+      for (int32_t i = 0; i < 3; i++)
+        EXPECT_EQ(Tiles::kNoTile, logic->GetTile(i, j).value);
+  }
+}
+
+/* under the Fibonacci rule neighbours in the sequence merge, and 89 with
+ * 144 makes the last tile, 233, which wins */
+TEST(LogicTest, FibonacciMergesNeighboursUpTo233) {
+  std::unique_ptr<GameLogic> logic =
+      GameLogic::Create(4, 4, MergeRules::kFibonacci);
+  for (int32_t i = 0; i < 4; i++)
+    for (int32_t j = 0; j < 4; j++)
+      logic->SetTile(i, j, Tiles::kNoTile);
+  logic->SetTile(0, 0, Tiles::kTile_1);
+  logic->SetTile(0, 1, Tiles::kTile_1);
+  logic->SetTile(1, 0, Tiles::kTile_4);
+  logic->SetTile(1, 1, Tiles::kTile_8);
+  logic->SetTile(2, 0, Tiles::kTile_4);
+  logic->SetTile(2, 1, Tiles::kTile_4);
+  logic->ResetStates();
+  logic->MoveLeft();
+  EXPECT_EQ(Tiles::kTile_2, logic->GetTile(0, 0).value);
+  EXPECT_EQ(Tiles::kTile_16, logic->GetTile(1, 0).value);
+  EXPECT_EQ(Tiles::kTile_4, logic->GetTile(2, 0).value);
+  EXPECT_EQ(Tiles::kTile_4, logic->GetTile(2, 1).value);
+  EXPECT_FALSE(logic->IsSuccess());
+
+  logic->SetTile(3, 0, Tiles::kTile_512);
+  logic->SetTile(3, 1, Tiles::kTile_1024);
+  logic->ResetStates();
+  logic->MoveRight();
+  Tiles winning = FibonacciMerge::kWinningTile;
+  EXPECT_EQ(winning, logic->GetTile(3, 3).value);
+  EXPECT_TRUE(logic->IsSuccess());
+  EXPECT_TRUE(logic->IsGameOver());
+}
@@ -0,0 +1,42 @@
+#ifndef _2048_LOGIC_MERGE_RULES_H_
+#define _2048_LOGIC_MERGE_RULES_H_
+
+#include "display/display.h"
+
+#include <cstdint>
+
+/* Merge rules for BasicLogic: which neighbouring tiles merge, into what,
+ * and which tile wins the game. */
+struct PowerOfTwoMerge {
+  static constexpr Tiles kWinningTile = Tiles::kTile_2048;
+
+  static constexpr bool CanMerge(Tiles first, Tiles second) {
+    return first == second;
+  }
+
+  static constexpr Tiles Merge(Tiles first, Tiles second) {
+    return static_cast<Tiles>(static_cast<int32_t>(first) + 1);
+  }
+};
+
+/* tile n stands for the n-th number of 1, 2, 3, 5, 8, ...; two ones or two
+ * neighbours in the sequence merge into the next number after them */
+struct FibonacciMerge {
+  /* 233, the twelfth number, in the last tile the board holds */
+  static constexpr Tiles kTile_233 = Tiles::kTile_2048;
+  static constexpr Tiles kWinningTile = kTile_233;
+
+  static constexpr bool CanMerge(Tiles first, Tiles second) {
+    return (first == Tiles::kTile_1 && second == Tiles::kTile_1)
+        || static_cast<int32_t>(first) - static_cast<int32_t>(second) == 1
+        || static_cast<int32_t>(second) - static_cast<int32_t>(first) == 1;
+  }
+
+  static constexpr Tiles Merge(Tiles first, Tiles second) {
+    return static_cast<Tiles>(
+        (first > second ? static_cast<int32_t>(first)
+                        : static_cast<int32_t>(second)) + 1);
+  }
+};
+
+#endif
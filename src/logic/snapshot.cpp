@@ -0,0 +1,52 @@
+#include "logic/snapshot.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+constexpr int32_t SnapshotPublisher::kMovesWord;
+constexpr int32_t SnapshotPublisher::kScoreWord;
+constexpr int32_t SnapshotPublisher::kGameOverWord;
+constexpr int32_t SnapshotPublisher::kCountersNumber;
+
+static int32_t GetCellWords(int32_t rows, int32_t columns) {
+  if (rows <= 0 || columns <= 0)
+    throw std::runtime_error("snapshot of an empty board");
+  return (static_cast<int64_t>(rows) * columns + 15) / 16;
+}
+
+SnapshotPublisher::SnapshotPublisher(int32_t rows, int32_t columns)
+    : rows_(rows)
+    , columns_(columns)
+    , cell_words_(GetCellWords(rows, columns))
+    , buffer_(cell_words_ + kCountersNumber)
+    , lock_(buffer_.size()) {}
+
+void SnapshotPublisher::Publish(const GameLogic& logic, uint64_t moves,
+                                uint64_t score) {
+  if (logic.GetRows() != rows_ || logic.GetColumns() != columns_)
+    throw std::runtime_error("snapshot size differs from the board");
+  logic.GetCells(buffer_.data());
+  buffer_[cell_words_ + kMovesWord] = moves;
+  buffer_[cell_words_ + kScoreWord] = score;
+  buffer_[cell_words_ + kGameOverWord] = logic.IsGameOver();
+  lock_.Write(buffer_.data());
+}
+
+void SnapshotPublisher::Read(GameSnapshot* snapshot) const {
+  std::vector<uint64_t>& words = snapshot->cells;
+  words.resize(buffer_.size());
+  snapshot->version = lock_.Read(words.data());
+  snapshot->rows = rows_;
+  snapshot->columns = columns_;
+  snapshot->moves = words[cell_words_ + kMovesWord];
+  snapshot->score = words[cell_words_ + kScoreWord];
+  snapshot->game_over = words[cell_words_ + kGameOverWord] != 0;
+  words.resize(cell_words_);
+}
+
+GameSnapshot SnapshotPublisher::Read() const {
+  GameSnapshot snapshot;
+  Read(&snapshot);
+  return snapshot;
+}
@@ -0,0 +1,63 @@
+#ifndef _2048_LOGIC_SNAPSHOT_H_
+#define _2048_LOGIC_SNAPSHOT_H_
+
+#include "display/display.h"
+#include "logic/game_logic.h"
+#include "parallel/seqlock.h"
+
+#include <cstdint>
+#include <vector>
+
+/* Game state as published after a turn: the board packed one nibble per
+ * cell in row-major order, 16 cells per word (for a 4x4 board the word is
+ * laid out as Board::GetCells), plus the turn counters. */
+struct GameSnapshot {
+  Tiles GetTile(int32_t row, int32_t column) const {
+    int32_t cell = row * columns + column;
+    return static_cast<Tiles>((cells[cell / 16] >> (4 * (cell % 16))) & 0xF);
+  }
+
+  int32_t rows = 0;
+  int32_t columns = 0;
+  /* number of states published up to this one, 0 before the first */
+  uint64_t version = 0;
+  uint64_t moves = 0;
+  uint64_t score = 0;
+  bool game_over = false;
+  std::vector<uint64_t> cells;
+};
+
+/* Single writer, many readers: the game thread publishes the state after
+ * every turn, bots, the renderer or exporters read it from any thread
+ * without locking and never see a half written board. */
+class SnapshotPublisher {
+ public:
+  SnapshotPublisher(int32_t rows, int32_t columns);
+
+  void Publish(const GameLogic& logic, uint64_t moves, uint64_t score);
+
+  /* reuses snapshot->cells, so polling does not allocate */
+  void Read(GameSnapshot* snapshot) const;
+
+  GameSnapshot Read() const;
+
+  /* cheap check for a new state before a full Read */
+  uint64_t GetVersion() const {
+    return lock_.GetVersion();
+  }
+
+ private:
+  /* the words after the cells */
+  static constexpr int32_t kMovesWord = 0;
+  static constexpr int32_t kScoreWord = 1;
+  static constexpr int32_t kGameOverWord = 2;
+  static constexpr int32_t kCountersNumber = 3;
+
+  int32_t rows_;
+  int32_t columns_;
+  int32_t cell_words_;
+  std::vector<uint64_t> buffer_;
+  SeqLock lock_;
+};
+
+#endif
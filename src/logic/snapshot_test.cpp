@@ -0,0 +1,100 @@
+#include "logic/snapshot.h"
+#include "logic/game_logic.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int32_t kLength = 16;
+
+void Fill(GameLogic& logic, uint64_t moves) {
+  for (int32_t i = 0; i < logic.GetRows(); i++)
+    for (int32_t j = 0; j < logic.GetColumns(); j++)
+      logic.SetTile(i, j, static_cast<Tiles>(moves % 12 + 1));
+}
+
+/* every published board is filled with one tile derived from the move
+ * counter, so a torn read shows up as mixed tiles or counters */
+bool IsConsistent(const GameSnapshot& snapshot) {
+  Tiles expected = static_cast<Tiles>(snapshot.moves % 12 + 1);
+  if (snapshot.score != 3 * snapshot.moves
+      || snapshot.version != snapshot.moves + 1)
+    return false;
+  for (int32_t i = 0; i < snapshot.rows; i++)
+    for (int32_t j = 0; j < snapshot.columns; j++)
+      if (snapshot.GetTile(i, j) != expected)
+        return false;
+  return true;
+}
+
+}  // namespace
+
+TEST(SnapshotTest, ReadsPublishedState) {
+  std::unique_ptr<GameLogic> logic = GameLogic::Create(3, 5);
+  SnapshotPublisher publisher(3, 5);
+  EXPECT_EQ(0u, publisher.GetVersion());
+  for (int32_t i = 0; i < 3; i++)
+    for (int32_t j = 0; j < 5; j++)
+      logic->SetTile(i, j, static_cast<Tiles>((i * 5 + j) % 13));
+  publisher.Publish(*logic, 7, 42);
+
+  GameSnapshot snapshot = publisher.Read();
+  EXPECT_EQ(1u, snapshot.version);
+  EXPECT_EQ(3, snapshot.rows);
+  EXPECT_EQ(5, snapshot.columns);
+  EXPECT_EQ(7u, snapshot.moves);
+  EXPECT_EQ(42u, snapshot.score);
+  EXPECT_EQ(logic->IsGameOver(), snapshot.game_over);
+  for (int32_t i = 0; i < 3; i++)
+    for (int32_t j = 0; j < 5; j++)
+      EXPECT_EQ(logic->GetTile(i, j).value, snapshot.GetTile(i, j));
+}
+
+/* timed like SeqLockTest, so that readers get preempted mid-copy even on a
+ * single core */
+TEST(SnapshotTest, ReadersNeverSeeTornOrOlderStates) {
+  constexpr int32_t kReadersNumber = 3;
+  constexpr double kSeconds = 0.3;
+  std::unique_ptr<GameLogic> logic = GameLogic::Create(kLength, kLength);
+  SnapshotPublisher publisher(kLength, kLength);
+  Fill(*logic, 0);
+  publisher.Publish(*logic, 0, 0);
+
+  std::atomic<bool> stop(false);
+  std::atomic<int64_t> reads(0), torn(0), stale(0);
+  auto reader = [&] {
+    GameSnapshot snapshot;
+    uint64_t last_version = 0;
+    do {
+      publisher.Read(&snapshot);
+      reads++;
+      torn += !IsConsistent(snapshot);
+      stale += snapshot.version < last_version;
+      last_version = snapshot.version;
+    } while (!stop.load(std::memory_order_relaxed));
+  };
+  std::vector<std::thread> readers;
+  for (int32_t i = 0; i < kReadersNumber; i++)
+    readers.emplace_back(reader);
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t moves = 1;
+       std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                     - start).count() < kSeconds;
+       moves++) {
+    Fill(*logic, moves);
+    publisher.Publish(*logic, moves, 3 * moves);
+  }
+  stop = true;
+  for (auto& thread : readers)
+    thread.join();
+  EXPECT_GE(reads, kReadersNumber);
+  EXPECT_EQ(0, torn);
+  EXPECT_EQ(0, stale);
+}
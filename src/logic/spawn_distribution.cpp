@@ -0,0 +1,82 @@
+#include "logic/spawn_distribution.h"
+#include "display/display.h"
+#include "logic/game_logic.h"
+
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+SpawnDistribution::SpawnDistribution()
+    : SpawnDistribution({{GameLogic::kInitialTile, 1}}) {}
+
+SpawnDistribution::SpawnDistribution(const std::vector<Outcome>& outcomes)
+    : outcomes_(outcomes) {
+  if (outcomes_.empty())
+    throw std::runtime_error("spawn distribution has no outcomes");
+  double sum = 0;
+  for (const Outcome& outcome : outcomes_) {
+    if (outcome.tile == Tiles::kNoTile || outcome.tile == Tiles::kTile_2048)
+      throw std::runtime_error("spawned tile must be between 1 and 1024");
+    if (!(outcome.probability > 0))
+      throw std::runtime_error("spawn probability must be positive");
+    sum += outcome.probability;
+  }
+  for (Outcome& outcome : outcomes_)
+    outcome.probability /= sum;
+  BuildAliasTable();
+}
+
+SpawnDistribution SpawnDistribution::Standard() {
+  return SpawnDistribution({{Tiles::kTile_2, 0.9}, {Tiles::kTile_4, 0.1}});
+}
+
+SpawnDistribution SpawnDistribution::Parse(const std::string& spec) {
+  std::vector<Outcome> outcomes;
+  std::istringstream in(spec);
+  std::string item;
+  while (std::getline(in, item, ',')) {
+    size_t colon = item.find(':');
+    if (colon == std::string::npos)
+      throw std::runtime_error("spawn outcome must be value:weight, got "
+                               + item);
+    int32_t value = std::stoi(item.substr(0, colon));
+    int32_t tile = 1;
+    while (tile < static_cast<int32_t>(Tiles::kTile_2048)
+           && (1 << (tile - 1)) < value)
+      tile++;
+    if (value <= 0 || (1 << (tile - 1)) != value)
+      throw std::runtime_error("spawned value must be a power of two, got "
+                               + item);
+    outcomes.push_back({static_cast<Tiles>(tile),
+                        std::stod(item.substr(colon + 1))});
+  }
+  return SpawnDistribution(outcomes);
+}
+
+/* Vose's method: columns scaled to the mean either keep their own outcome
+ * below threshold or borrow the rest of the column from a larger one */
+void SpawnDistribution::BuildAliasTable() {
+  size_t size = outcomes_.size();
+  threshold_.assign(size, 1);
+  alias_.resize(size);
+  std::vector<double> scaled(size);
+  std::vector<size_t> small, large;
+  for (size_t i = 0; i < size; i++) {
+    alias_[i] = i;
+    scaled[i] = outcomes_[i].probability * size;
+    (scaled[i] < 1 ? small : large).push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    size_t less = small.back(), more = large.back();
+    small.pop_back();
+    threshold_[less] = scaled[less];
+    alias_[less] = more;
+    scaled[more] -= 1 - scaled[less];
+    if (scaled[more] < 1) {
+      large.pop_back();
+      small.push_back(more);
+    }
+  }
+}
@@ -0,0 +1,58 @@
+#ifndef _2048_LOGIC_SPAWN_DISTRIBUTION_H_
+#define _2048_LOGIC_SPAWN_DISTRIBUTION_H_
+
+#include "display/display.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Distribution of the value of a newly spawned tile. Sample draws in O(1)
+ * from an alias table; search enumerates GetOutcomes as chance node
+ * weights. The default one always spawns Logic::kInitialTile. */
+class SpawnDistribution {
+ public:
+  struct Outcome {
+    Tiles tile;
+    double probability;
+  };
+
+  SpawnDistribution();
+
+  /* probabilities are normalized, they only have to be positive */
+  explicit SpawnDistribution(const std::vector<Outcome>& outcomes);
+
+  /* a 2 with probability 0.9 and a 4 with probability 0.1 */
+  static SpawnDistribution Standard();
+
+  /* comma separated value:weight pairs, e.g. "2:0.9,4:0.1" */
+  static SpawnDistribution Parse(const std::string& spec);
+
+  const std::vector<Outcome>& GetOutcomes() const {
+    return outcomes_;
+  }
+
+  /* numbers Sample takes from the rng, always the same */
+  int32_t GetSampleDraws() const {
+    return outcomes_.size() == 1 ? 0 : 2;
+  }
+
+  template <class Rng>
+  Tiles Sample(Rng& rng) const {
+    if (outcomes_.size() == 1)
+      return outcomes_[0].tile;
+    size_t column = rng() % outcomes_.size();
+    double uniform = (rng() >> 11) * (1.0 / (1ULL << 53));
+    return outcomes_[uniform < threshold_[column] ? column
+                                                  : alias_[column]].tile;
+  }
+
+ private:
+  void BuildAliasTable();
+
+  std::vector<Outcome> outcomes_;
+  std::vector<double> threshold_;
+  std::vector<size_t> alias_;
+};
+
+#endif
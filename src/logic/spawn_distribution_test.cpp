@@ -0,0 +1,88 @@
+#include "logic/spawn_distribution.h"
+#include "display/display.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+/* an rng that counts the numbers taken from it */
+struct CountingRng {
+  uint64_t operator()() {
+    draws++;
+    return engine();
+  }
+
+  std::mt19937_64 engine;
+  int32_t draws = 0;
+};
+
+}  // namespace
+
+/* the alias table has to sample each outcome as often as its weight says,
+ * also when some weights are far below the mean */
+TEST(SpawnDistributionTest, SamplesTheWeights) {
+  constexpr int32_t kSamples = 1000000;
+  for (const char* spec : {"2:0.9,4:0.1", "1:1,2:2,4:3,8:4",
+                           "2:100,4:1,8:1,16:0.5,32:97.5"}) {
+    SCOPED_TRACE(spec);
+    SpawnDistribution spawns = SpawnDistribution::Parse(spec);
+    const std::vector<SpawnDistribution::Outcome>& outcomes =
+        spawns.GetOutcomes();
+    double sum = 0;
+    for (const SpawnDistribution::Outcome& outcome : outcomes)
+      sum += outcome.probability;
+    EXPECT_NEAR(1, sum, 1e-12);
+
+    std::vector<int32_t> counts(static_cast<size_t>(Tiles::kTile_2048));
+    CountingRng rng;
+    for (int32_t i = 0; i < kSamples; i++)
+      counts[static_cast<size_t>(spawns.Sample(rng))]++;
+    EXPECT_EQ(kSamples * spawns.GetSampleDraws(), rng.draws);
+    int32_t sampled = 0;
+    for (const SpawnDistribution::Outcome& outcome : outcomes) {
+      double expected = outcome.probability * kSamples;
+      /* five standard deviations */
+      double tolerance = 5 * std::sqrt(expected * (1 - outcome.probability));
+      EXPECT_NEAR(expected, counts[static_cast<size_t>(outcome.tile)],
+                  tolerance);
+      sampled += counts[static_cast<size_t>(outcome.tile)];
+    }
+    EXPECT_EQ(kSamples, sampled);
+  }
+}
+
+TEST(SpawnDistributionTest, SamplesASingleOutcomeWithoutDraws) {
+  for (SpawnDistribution spawns : {SpawnDistribution(),
+                                   SpawnDistribution::Parse("4:0.3")}) {
+    ASSERT_EQ(1u, spawns.GetOutcomes().size());
+    EXPECT_EQ(1, spawns.GetOutcomes()[0].probability);
+    EXPECT_EQ(0, spawns.GetSampleDraws());
+    CountingRng rng;
+    for (int32_t i = 0; i < 10; i++)
+      EXPECT_EQ(spawns.GetOutcomes()[0].tile, spawns.Sample(rng));
+    EXPECT_EQ(0, rng.draws);
+  }
+}
+
+TEST(SpawnDistributionTest, RejectsBadSpecs) {
+  for (const char* spec : {"", "2", "2:0.9,4", "3:1", "0:1", "-2:1",
+                           "2048:1", "2:0", "2:-1", "2:1,4:0"}) {
+    SCOPED_TRACE(spec);
+    EXPECT_THROW(SpawnDistribution::Parse(spec), std::runtime_error);
+  }
+  /* numbers that do not parse at all */
+  for (const char* spec : {"x:1", "2:y", ":"}) {
+    SCOPED_TRACE(spec);
+    EXPECT_THROW(SpawnDistribution::Parse(spec), std::exception);
+  }
+  EXPECT_THROW(SpawnDistribution(std::vector<SpawnDistribution::Outcome>()),
+               std::runtime_error);
+  EXPECT_THROW(SpawnDistribution({{Tiles::kNoTile, 1}}), std::runtime_error);
+}
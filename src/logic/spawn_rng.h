@@ -0,0 +1,72 @@
+#ifndef _2048_LOGIC_SPAWN_RNG_H_
+#define _2048_LOGIC_SPAWN_RNG_H_
+
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+/* The spawn RNG of the logics: mt19937_64 counting its draws, so that its
+ * state is the seed and the count. Restoring that is a discard, linear in
+ * the draws; GetState and SetState carry the whole engine state instead. */
+class SpawnRng {
+ public:
+  using result_type = std::mt19937_64::result_type;
+
+  explicit SpawnRng(uint64_t seed = std::mt19937_64::default_seed)
+      : engine_(seed)
+      , seed_(seed)
+      , draws_(0) {}
+
+  static constexpr result_type min() {
+    return std::mt19937_64::min();
+  }
+
+  static constexpr result_type max() {
+    return std::mt19937_64::max();
+  }
+
+  result_type operator()() {
+    draws_++;
+    return engine_();
+  }
+
+  uint64_t GetSeed() const {
+    return seed_;
+  }
+
+  uint64_t GetDraws() const {
+    return draws_;
+  }
+
+  void Restore(uint64_t seed, uint64_t draws) {
+    engine_.seed(seed);
+    engine_.discard(draws);
+    seed_ = seed;
+    draws_ = draws;
+  }
+
+  /* the engine in the text form of the standard */
+  std::string GetState() const {
+    std::ostringstream out;
+    out << engine_;
+    return out.str();
+  }
+
+  void SetState(uint64_t seed, uint64_t draws, const std::string& state) {
+    std::istringstream in(state);
+    in >> engine_;
+    if (!in)
+      throw std::runtime_error("malformed rng state");
+    seed_ = seed;
+    draws_ = draws;
+  }
+
+ private:
+  std::mt19937_64 engine_;
+  uint64_t seed_;
+  uint64_t draws_;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef _2048_LOGIC_TRANSPOSE_H_
+#define _2048_LOGIC_TRANSPOSE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+/* In-place transposes of square row-major matrices on contiguous storage.
+ * The matrix is halved recursively until the blocks are kTransposeLeaf
+ * cells wide, so a block and its mirror stay in cache together whatever
+ * the cache sizes are, instead of every column access missing once the
+ * length exceeds a few dozen cells. */
+constexpr int32_t kTransposeLeaf = 16;
+
+namespace transpose_internal {
+
+/* swaps the rows x columns block at (row, column) with the transpose of
+ * its mirror block at (column, row); the two must not overlap */
+template <class T>
+void SwapMirrored(T* cells, int32_t length, int32_t row, int32_t column,
+                  int32_t rows, int32_t columns) {
+  if (rows <= kTransposeLeaf && columns <= kTransposeLeaf) {
+    for (int32_t i = row; i < row + rows; i++)
+      for (int32_t j = column; j < column + columns; j++)
+        std::swap(cells[static_cast<int64_t>(i) * length + j],
+                  cells[static_cast<int64_t>(j) * length + i]);
+    return;
+  }
+  if (rows >= columns) {
+    int32_t half = rows / 2;
+    SwapMirrored(cells, length, row, column, half, columns);
+    SwapMirrored(cells, length, row + half, column, rows - half, columns);
+  } else {
+    int32_t half = columns / 2;
+    SwapMirrored(cells, length, row, column, rows, half);
+    SwapMirrored(cells, length, row, column + half, rows, columns - half);
+  }
+}
+
+/* transposes the size x size block on the diagonal starting at begin */
+template <class T>
+void TransposeDiagonal(T* cells, int32_t length, int32_t begin,
+                       int32_t size) {
+  if (size <= kTransposeLeaf) {
+    for (int32_t i = begin; i < begin + size; i++)
+      for (int32_t j = i + 1; j < begin + size; j++)
+        std::swap(cells[static_cast<int64_t>(i) * length + j],
+                  cells[static_cast<int64_t>(j) * length + i]);
+    return;
+  }
+  int32_t half = size / 2;
+  TransposeDiagonal(cells, length, begin, half);
+  TransposeDiagonal(cells, length, begin + half, size - half);
+  SwapMirrored(cells, length, begin + half, begin, size - half, half);
+}
+
+}  // namespace transpose_internal
+
+template <class T>
+void TransposeSquare(T* cells, int32_t length) {
+  transpose_internal::TransposeDiagonal(cells, length, 0, length);
+}
+
+#endif
@@ -0,0 +1,29 @@
+#include "logic/transpose.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/* lengths that are and are not multiples of kTransposeLeaf, below and
+ * above it */
+TEST(TransposeTest, MatchesCellByCellTranspose) {
+  std::mt19937_64 rng(1);
+  std::vector<int32_t> lengths;
+  for (int32_t length = 1; length <= 70; length++)
+    lengths.push_back(length);
+  for (int32_t length : {96, 100, 128, 255, 256, 520})
+    lengths.push_back(length);
+  for (int32_t length : lengths) {
+    SCOPED_TRACE(length);
+    std::vector<uint32_t> cells(static_cast<size_t>(length) * length);
+    for (uint32_t& cell : cells)
+      cell = rng();
+    std::vector<uint32_t> words = cells;
+    TransposeSquare(words.data(), length);
+    for (int32_t i = 0; i < length; i++)
+      for (int32_t j = 0; j < length; j++)
+        ASSERT_EQ(cells[j * length + i], words[i * length + j]);
+  }
+}
@@ -0,0 +1,145 @@
+#include "parallel/parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+int32_t GetThreadsNumber(int32_t requested) {
+  if (requested > 0)
+    return requested;
+  return std::max(1U, std::thread::hardware_concurrency());
+}
+
+namespace {
+
+/* one ParallelFor call, living on the stack of its caller */
+struct Job {
+  size_t count;
+  size_t chunk_size;
+  size_t chunks_number;
+  const std::function<void(size_t, size_t, int32_t)>* body;
+  std::atomic<size_t> next_chunk;
+  /* thread indices still to hand out to workers, and workers inside */
+  int32_t free_indices;
+  int32_t running;
+  std::exception_ptr error;
+  std::condition_variable done;
+
+  void Work(int32_t thread_idx, std::mutex& mutex) {
+    try {
+      for (size_t chunk = next_chunk++; chunk < chunks_number;
+           chunk = next_chunk++) {
+        size_t begin = chunk * chunk_size;
+        (*body)(begin, std::min(count, begin + chunk_size), thread_idx);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!error)
+        error = std::current_exception();
+      next_chunk = chunks_number;
+    }
+  }
+};
+
+/* Workers started on first use and kept for the whole process, so that a
+ * ParallelFor per move costs a wake-up instead of thread creation. The
+ * caller always works on its own job too: a job whose workers are all busy,
+ * e.g. a ParallelFor nested in another one, still completes. */
+class WorkerPool {
+ public:
+  static WorkerPool& Get() {
+    static WorkerPool pool;
+    return pool;
+  }
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_)
+      thread.join();
+  }
+
+  void Run(Job& job, int32_t threads_number) {
+    job.free_indices = threads_number - 1;
+    job.running = 0;
+    if (job.free_indices) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      while (static_cast<int32_t>(threads_.size()) < job.free_indices)
+        threads_.emplace_back(&WorkerPool::Loop, this);
+      jobs_.push_back(&job);
+    }
+    wake_.notify_all();
+    job.Work(0, mutex_);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    /* the chunks are all taken, late workers have nothing to join for */
+    auto it = std::find(jobs_.begin(), jobs_.end(), &job);
+    if (it != jobs_.end())
+      jobs_.erase(it);
+    job.done.wait(lock, [&job] { return !job.running; });
+    if (job.error)
+      std::rethrow_exception(job.error);
+  }
+
+ private:
+  WorkerPool() : stopped_(false) {}
+
+  void Loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      wake_.wait(lock, [this] { return stopped_ || !jobs_.empty(); });
+      if (stopped_)
+        return;
+      Job& job = *jobs_.front();
+      int32_t thread_idx = job.free_indices--;
+      if (!job.free_indices)
+        jobs_.pop_front();
+      job.running++;
+      lock.unlock();
+      job.Work(thread_idx, mutex_);
+      lock.lock();
+      if (!--job.running)
+        job.done.notify_all();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::deque<Job*> jobs_;
+  std::vector<std::thread> threads_;
+  bool stopped_;
+};
+
+}  // namespace
+
+void ParallelFor(size_t count, size_t chunk_size, int32_t threads_number,
+                 const std::function<void(size_t begin, size_t end,
+                                          int32_t thread_idx)>& body) {
+  if (!count)
+    return;
+  Job job;
+  job.count = count;
+  job.chunk_size = std::max<size_t>(chunk_size, 1);
+  job.chunks_number = (count + job.chunk_size - 1) / job.chunk_size;
+  job.body = &body;
+  job.next_chunk = 0;
+  threads_number = std::min<size_t>(GetThreadsNumber(threads_number),
+                                    job.chunks_number);
+  if (threads_number == 1) {
+    for (size_t begin = 0; begin < count; begin += job.chunk_size)
+      body(begin, std::min(count, begin + job.chunk_size), 0);
+    return;
+  }
+  WorkerPool::Get().Run(job, threads_number);
+}
@@ -0,0 +1,59 @@
+#ifndef _2048_PARALLEL_PARALLEL_H_
+#define _2048_PARALLEL_PARALLEL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+
+constexpr size_t kCacheLineSize = 64;
+
+/* zero or negative requested number means one thread per hardware thread */
+int32_t GetThreadsNumber(int32_t requested);
+
+/* Splits [0, count) into chunks of chunk_size items and hands them out to
+ * threads_number threads (the calling thread included) as they get free.
+ * body receives the chunk bounds and the index of the running thread. The
+ * other threads come from a pool kept for the whole process, and calls may
+ * nest or run concurrently. */
+void ParallelFor(size_t count, size_t chunk_size, int32_t threads_number,
+                 const std::function<void(size_t begin, size_t end,
+                                          int32_t thread_idx)>& body);
+
+/* Starts every allocation on a cache line, so that blocks of whole cache
+ * lines handed to different threads never share one. */
+template <class T>
+struct CacheAlignedAllocator {
+  using value_type = T;
+
+  CacheAlignedAllocator() = default;
+
+  template <class U>
+  CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+  T* allocate(size_t n) {
+    void* pointer = nullptr;
+    if (posix_memalign(&pointer, kCacheLineSize, n * sizeof(T)))
+      throw std::bad_alloc();
+    return static_cast<T*>(pointer);
+  }
+
+  void deallocate(T* pointer, size_t) {
+    free(pointer);
+  }
+};
+
+template <class T, class U>
+bool operator==(const CacheAlignedAllocator<T>&,
+                const CacheAlignedAllocator<U>&) {
+  return true;
+}
+
+template <class T, class U>
+bool operator!=(const CacheAlignedAllocator<T>&,
+                const CacheAlignedAllocator<U>&) {
+  return false;
+}
+
+#endif
@@ -0,0 +1,73 @@
+#include "parallel/parallel.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/* every item visited once, by a thread index below threads_number */
+void ExpectCovered(size_t count, size_t chunk_size, int32_t threads_number) {
+  std::vector<std::atomic<int32_t>> visits(count);
+  std::atomic<bool> bad_index(false);
+  ParallelFor(count, chunk_size, threads_number,
+              [&](size_t begin, size_t end, int32_t thread_idx) {
+    if (thread_idx < 0 || thread_idx >= threads_number)
+      bad_index = true;
+    for (size_t i = begin; i < end; i++)
+      visits[i]++;
+  });
+  EXPECT_FALSE(bad_index);
+  for (size_t i = 0; i < count; i++)
+    ASSERT_EQ(1, visits[i]) << i;
+}
+
+}  // namespace
+
+TEST(ParallelTest, CoversEveryItemOnce) {
+  for (int32_t threads_number : {1, 2, 4, 8})
+    for (size_t count : {0, 1, 7, 64, 1000})
+      for (size_t chunk_size : {0, 1, 3, 64})
+        ExpectCovered(count, chunk_size, threads_number);
+}
+
+TEST(ParallelTest, RethrowsErrors) {
+  for (int32_t k = 0; k < 100; k++) {
+    EXPECT_THROW(ParallelFor(100, 1, 4, [](size_t begin, size_t, int32_t) {
+      if (begin == 50)
+        throw std::runtime_error("fail");
+    }), std::runtime_error);
+  }
+  ExpectCovered(100, 1, 4);
+}
+
+TEST(ParallelTest, NestedCallsComplete) {
+  std::atomic<int64_t> sum(0);
+  ParallelFor(16, 1, 4, [&](size_t, size_t, int32_t) {
+    ParallelFor(16, 1, 4, [&](size_t begin, size_t end, int32_t) {
+      sum += end - begin;
+    });
+  });
+  EXPECT_EQ(256, sum);
+}
+
+TEST(ParallelTest, ConcurrentCallersComplete) {
+  std::vector<std::thread> callers;
+  std::atomic<int64_t> sum(0);
+  for (int32_t i = 0; i < 4; i++) {
+    callers.emplace_back([&sum] {
+      for (int32_t k = 0; k < 500; k++)
+        ParallelFor(8, 1, 3, [&sum](size_t begin, size_t end, int32_t) {
+          sum += end - begin;
+        });
+    });
+  }
+  for (auto& caller : callers)
+    caller.join();
+  EXPECT_EQ(4 * 500 * 8, sum);
+}
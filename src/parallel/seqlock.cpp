@@ -0,0 +1,47 @@
+#include "parallel/seqlock.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+SeqLock::SeqLock(size_t words_number)
+    : words_number_(words_number)
+    , version_(0) {
+  for (Slot& slot : slots_) {
+    slot.sequence.store(0, std::memory_order_relaxed);
+    slot.version.store(0, std::memory_order_relaxed);
+    slot.words.reset(new std::atomic<uint64_t>[words_number]());
+  }
+}
+
+void SeqLock::Write(const uint64_t* words) {
+  uint64_t version = version_.load(std::memory_order_relaxed) + 1;
+  Slot& slot = slots_[version & 1];
+  /* an odd sequence tells readers that the slot is being written */
+  uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.version.store(version, std::memory_order_relaxed);
+  for (size_t i = 0; i < words_number_; i++)
+    slot.words[i].store(words[i], std::memory_order_relaxed);
+  slot.sequence.store(sequence + 2, std::memory_order_release);
+  version_.store(version, std::memory_order_release);
+}
+
+uint64_t SeqLock::Read(uint64_t* words) const {
+  while (true) {
+    uint64_t version = version_.load(std::memory_order_acquire);
+    const Slot& slot = slots_[version & 1];
+    uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    /* a slot holding another version has been lapped by the writer,
+     * dropping it keeps the versions seen by a reader increasing */
+    if (sequence & 1
+        || slot.version.load(std::memory_order_relaxed) != version)
+      continue;
+    for (size_t i = 0; i < words_number_; i++)
+      words[i] = slot.words[i].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+      return version;
+  }
+}
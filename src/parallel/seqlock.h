@@ -0,0 +1,50 @@
+#ifndef _2048_PARALLEL_SEQLOCK_H_
+#define _2048_PARALLEL_SEQLOCK_H_
+
+#include "parallel/parallel.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/* Publishes a fixed number of 64-bit words from one writer to any number of
+ * readers without locks. Writes alternate between two slots guarded by
+ * their own sequence numbers, so a reader copies the last published slot
+ * while the writer fills the other one; it retries only when the writer
+ * publishes twice during a single read. */
+class SeqLock {
+ public:
+  explicit SeqLock(size_t words_number);
+
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+
+  size_t GetWordsNumber() const {
+    return words_number_;
+  }
+
+  /* number of Write calls so far */
+  uint64_t GetVersion() const {
+    return version_.load(std::memory_order_acquire);
+  }
+
+  /* must not be called concurrently with another Write */
+  void Write(const uint64_t* words);
+
+  /* copies a consistent set of words and returns its version */
+  uint64_t Read(uint64_t* words) const;
+
+ private:
+  struct alignas(kCacheLineSize) Slot {
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> version;
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+  };
+
+  size_t words_number_;
+  Slot slots_[2];
+  alignas(kCacheLineSize) std::atomic<uint64_t> version_;
+};
+
+#endif
@@ -0,0 +1,69 @@
+#include "parallel/seqlock.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+TEST(SeqLockTest, ReadsLastWrite) {
+  SeqLock lock(3);
+  std::vector<uint64_t> words(3);
+  EXPECT_EQ(0u, lock.Read(words.data()));
+  for (uint64_t version = 1; version <= 5; version++) {
+    std::vector<uint64_t> written = {version, 2 * version, 3 * version};
+    lock.Write(written.data());
+    EXPECT_EQ(version, lock.GetVersion());
+    EXPECT_EQ(version, lock.Read(words.data()));
+    EXPECT_EQ(written, words);
+  }
+}
+
+/* every write fills all words with its version, so a torn read shows up as
+ * mixed words and a lapped slot as a version going back; the writer runs
+ * for a while rather than a number of writes so that readers get
+ * preempted mid-copy even on a single core */
+TEST(SeqLockTest, ReadersNeverSeeTornOrOlderWrites) {
+  constexpr size_t kWordsNumber = 256;
+  constexpr int32_t kReadersNumber = 3;
+  constexpr double kSeconds = 0.3;
+  SeqLock lock(kWordsNumber);
+  std::atomic<bool> stop(false);
+  std::atomic<int64_t> reads(0), torn(0), stale(0);
+  auto reader = [&] {
+    std::vector<uint64_t> words(kWordsNumber);
+    uint64_t last_version = 0;
+    do {
+      uint64_t version = lock.Read(words.data());
+      reads++;
+      for (uint64_t word : words)
+        if (word != version) {
+          torn++;
+          break;
+        }
+      stale += version < last_version;
+      last_version = version;
+    } while (!stop.load(std::memory_order_relaxed));
+  };
+  std::vector<std::thread> readers;
+  for (int32_t i = 0; i < kReadersNumber; i++)
+    readers.emplace_back(reader);
+  std::vector<uint64_t> words(kWordsNumber);
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t version = 1;
+       std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                     - start).count() < kSeconds;
+       version++) {
+    words.assign(kWordsNumber, version);
+    lock.Write(words.data());
+  }
+  stop = true;
+  for (auto& thread : readers)
+    thread.join();
+  EXPECT_GE(reads, kReadersNumber);
+  EXPECT_EQ(0, torn);
+  EXPECT_EQ(0, stale);
+}
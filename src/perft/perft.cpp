@@ -0,0 +1,142 @@
+#include "perft/perft.h"
+#include "ai/board.h"
+#include "ai/wide_board.h"
+#include "logic/game_logic.h"
+#include "logic/logic.h"
+#include "parallel/parallel.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+constexpr Tiles Perft::kSpawnTiles[];
+
+namespace {
+
+constexpr int64_t kSpawnTilesNumber =
+    sizeof(Perft::kSpawnTiles) / sizeof(Perft::kSpawnTiles[0]);
+
+constexpr Directions kMoves[] = {
+  Directions::kLeft, Directions::kRight, Directions::kUp, Directions::kDown,
+};
+
+}  // namespace
+
+template <class BoardType>
+std::unique_ptr<GameLogic> Perft::ToLogic(BoardType board,
+                                          bool runtime_sized) {
+  constexpr int32_t kLength = BoardType::kLength;
+  std::unique_ptr<GameLogic> logic;
+  if (runtime_sized)
+    logic.reset(new Logic(kLength));
+  else
+    logic = GameLogic::Create(kLength, kLength);
+  for (int32_t i = 0; i < kLength; i++)
+    for (int32_t j = 0; j < kLength; j++)
+      logic->SetTile(i, j, board.GetTile(i, j));
+  return logic;
+}
+
+int64_t Perft::CountLogic(const GameLogic& logic, int32_t depth) {
+  if (!depth)
+    return 1;
+  int64_t count = 0;
+  for (Directions direction : kMoves) {
+    std::unique_ptr<GameLogic> moved = logic.Clone();
+    moved->Move(direction);
+    if (!moved->HasSomethingChanged())
+      continue;
+    moved->ResetStates();
+    std::vector<std::vector<GameLogic::TileInfo>> matrix = moved->GetMatrix();
+    for (size_t i = 0; i < matrix.size(); i++) {
+      for (size_t j = 0; j < matrix[i].size(); j++) {
+        if (matrix[i][j].value != Tiles::kNoTile)
+          continue;
+        for (Tiles tile : kSpawnTiles) {
+          std::unique_ptr<GameLogic> child = moved->Clone();
+          child->SetTile(i, j, tile);
+          count += CountLogic(*child, depth - 1);
+        }
+      }
+    }
+  }
+  return count;
+}
+
+template <class BoardType>
+int64_t Perft::CountBoard(BoardType board, int32_t depth) {
+  if (!depth)
+    return 1;
+  int64_t count = 0;
+  for (Directions direction : kMoves) {
+    BoardType moved = board.Move(direction);
+    if (moved == board)
+      continue;
+    if (depth == 1) {
+      count += moved.CountEmpty() * kSpawnTilesNumber;
+      continue;
+    }
+    for (int32_t i = 0; i < BoardType::kLength; i++) {
+      for (int32_t j = 0; j < BoardType::kLength; j++) {
+        if (moved.GetTile(i, j) != Tiles::kNoTile)
+          continue;
+        for (Tiles tile : kSpawnTiles) {
+          BoardType child = moved;
+          child.SetTile(i, j, tile);
+          count += CountBoard(child, depth - 1);
+        }
+      }
+    }
+  }
+  return count;
+}
+
+template <class BoardType>
+int64_t Perft::CountBoardParallel(BoardType board, int32_t depth,
+                                  int32_t threads_number) {
+  if (depth < 2)
+    return CountBoard(board, depth);
+  std::vector<BoardType> roots;
+  for (Directions direction : kMoves) {
+    BoardType moved = board.Move(direction);
+    if (moved == board)
+      continue;
+    for (int32_t i = 0; i < BoardType::kLength; i++) {
+      for (int32_t j = 0; j < BoardType::kLength; j++) {
+        if (moved.GetTile(i, j) != Tiles::kNoTile)
+          continue;
+        for (Tiles tile : kSpawnTiles) {
+          BoardType child = moved;
+          child.SetTile(i, j, tile);
+          roots.push_back(child);
+        }
+      }
+    }
+  }
+  std::atomic<int64_t> count(0);
+  ParallelFor(roots.size(), 1, threads_number,
+              [&roots, &count, depth](size_t begin, size_t end, int32_t) {
+    int64_t local = 0;
+    for (size_t k = begin; k < end; k++)
+      local += CountBoard(roots[k], depth - 1);
+    count += local;
+  });
+  return count;
+}
+
+template std::unique_ptr<GameLogic> Perft::ToLogic(Board board,
+                                                   bool runtime_sized);
+template std::unique_ptr<GameLogic> Perft::ToLogic(WideBoard<5> board,
+                                                   bool runtime_sized);
+template std::unique_ptr<GameLogic> Perft::ToLogic(WideBoard<6> board,
+                                                   bool runtime_sized);
+template int64_t Perft::CountBoard(Board board, int32_t depth);
+template int64_t Perft::CountBoard(WideBoard<5> board, int32_t depth);
+template int64_t Perft::CountBoard(WideBoard<6> board, int32_t depth);
+template int64_t Perft::CountBoardParallel(Board board, int32_t depth,
+                                           int32_t threads_number);
+template int64_t Perft::CountBoardParallel(WideBoard<5> board, int32_t depth,
+                                           int32_t threads_number);
+template int64_t Perft::CountBoardParallel(WideBoard<6> board, int32_t depth,
+                                           int32_t threads_number);
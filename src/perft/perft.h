@@ -0,0 +1,38 @@
+#ifndef _2048_PERFT_PERFT_H_
+#define _2048_PERFT_PERFT_H_
+
+#include "ai/board.h"
+#include "ai/wide_board.h"
+#include "logic/game_logic.h"
+#include "logic/logic.h"
+
+#include <cstdint>
+#include <memory>
+
+/* Number of positions reached after depth turns, a turn being a move that
+ * changes the board followed by a 2 or a 4 in any empty cell. Positions
+ * without moves before the last turn contribute nothing. */
+class Perft {
+ public:
+  static constexpr Tiles kSpawnTiles[] = {Tiles::kTile_2, Tiles::kTile_4};
+
+  /* reference count driven by the tile matrix rules */
+  static int64_t CountLogic(const GameLogic& logic, int32_t depth);
+
+  /* count driven by the packed Board move kernel, or the WideBoard one for
+   * 5x5 and 6x6 */
+  template <class BoardType>
+  static int64_t CountBoard(BoardType board, int32_t depth);
+
+  /* CountBoard with the root moves and spawns split across threads */
+  template <class BoardType>
+  static int64_t CountBoardParallel(BoardType board, int32_t depth,
+                                    int32_t threads_number);
+
+  /* the runtime sized Logic or the BasicLogic instantiated for the board */
+  template <class BoardType>
+  static std::unique_ptr<GameLogic> ToLogic(BoardType board,
+                                            bool runtime_sized);
+};
+
+#endif
@@ -0,0 +1,272 @@
+#include "replay/replay.h"
+#include "logic/game_logic.h"
+#include "replay/replay_player.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+constexpr int32_t Replay::kKeyframeInterval;
+
+Replay::Keyframe Replay::MakeKeyframe(const GameLogic& logic, int64_t score) {
+  int32_t rows = logic.GetRows(), columns = logic.GetColumns();
+  Keyframe keyframe = {score, std::vector<uint64_t>(
+      replay_format::GetCellWords(rows, columns))};
+  for (int32_t i = 0; i < rows; i++) {
+    for (int32_t j = 0; j < columns; j++) {
+      int32_t cell = i * columns + j;
+      uint64_t value = static_cast<uint64_t>(logic.GetTile(i, j).value);
+      keyframe.cells[cell / 16] |= value << (4 * (cell % 16));
+    }
+  }
+  return keyframe;
+}
+
+namespace replay_format {
+
+int32_t GetBitsNumber(size_t number) {
+  int32_t bits = 0;
+  while (number > (static_cast<size_t>(1) << bits))
+    bits++;
+  return bits;
+}
+
+size_t GetCellWords(int32_t rows, int32_t columns) {
+  return (static_cast<size_t>(rows) * columns + 15) / 16;
+}
+
+size_t GetRecordSize(const char* data, size_t size) {
+  if (size < sizeof(GameHeader))
+    return 0;
+  GameHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  return header.size <= size ? header.size : 0;
+}
+
+}  // namespace replay_format
+
+namespace {
+
+using namespace replay_format;
+
+class BitWriter {
+ public:
+  explicit BitWriter(std::vector<char>* out)
+      : out_(out)
+      , bits_(0)
+      , used_(0) {}
+
+  void Write(uint32_t value, int32_t bits) {
+    bits_ |= static_cast<uint64_t>(value) << used_;
+    used_ += bits;
+    while (used_ >= 8) {
+      out_->push_back(static_cast<char>(bits_));
+      bits_ >>= 8;
+      used_ -= 8;
+    }
+  }
+
+  void Finish() {
+    if (used_)
+      out_->push_back(static_cast<char>(bits_));
+    bits_ = used_ = 0;
+  }
+
+ private:
+  std::vector<char>* out_;
+  uint64_t bits_;
+  int32_t used_;
+};
+
+class BitReader {
+ public:
+  BitReader(const char* data, size_t size)
+      : data_(reinterpret_cast<const uint8_t*>(data))
+      , end_(data_ + size)
+      , bits_(0)
+      , available_(0) {}
+
+  uint32_t Read(int32_t bits) {
+    while (available_ < bits) {
+      if (data_ == end_)
+        throw std::runtime_error("replay bit stream is truncated");
+      bits_ |= static_cast<uint64_t>(*data_++) << available_;
+      available_ += 8;
+    }
+    uint32_t value = bits_ & ((static_cast<uint64_t>(1) << bits) - 1);
+    bits_ >>= bits;
+    available_ -= bits;
+    return value;
+  }
+
+ private:
+  const uint8_t* data_;
+  const uint8_t* end_;
+  uint64_t bits_;
+  int32_t available_;
+};
+
+int32_t GetOutcomeIndex(const std::vector<SpawnDistribution::Outcome>& spawns,
+                        Tiles tile) {
+  for (size_t i = 0; i < spawns.size(); i++)
+    if (spawns[i].tile == tile)
+      return i;
+  throw std::runtime_error("spawned tile is not in the spawn distribution");
+}
+
+}  // namespace
+
+void Replay::Encode(std::vector<char>* out) const {
+  int32_t cells_number = rows * columns;
+  if (rows <= 0 || columns <= 0 || rows > 255 || columns > 255)
+    throw std::runtime_error("replay board size is out of range");
+  if (spawns.empty() || spawns.size() > 255 || initial_tiles.size() > 255)
+    throw std::runtime_error("replay spawns are out of range");
+  if (keyframe_interval < 0 || keyframe_interval > 65535)
+    throw std::runtime_error("replay keyframe interval is out of range");
+  for (size_t i = 0; i + 1 < turns.size(); i++)
+    if (turns[i].spawn.cell < 0)
+      throw std::runtime_error("only the last replay turn may not spawn");
+
+  GameHeader header = {};
+  header.turns_number = turns.size();
+  header.seed = seed;
+  header.score = score;
+  header.rows = rows;
+  header.columns = columns;
+  header.rule = static_cast<uint8_t>(rule);
+  header.outcomes_number = spawns.size();
+  header.initial_tiles_number = initial_tiles.size();
+  header.keyframe_interval = keyframe_interval;
+  if (!turns.empty() && turns.back().spawn.cell < 0)
+    header.flags |= kLastTurnWithoutSpawn;
+
+  size_t begin = out->size();
+  out->resize(begin + sizeof(header));
+  for (const auto& spawn : spawns) {
+    Outcome outcome = {};
+    outcome.tile = static_cast<uint8_t>(spawn.tile);
+    outcome.probability = spawn.probability;
+    const char* bytes = reinterpret_cast<const char*>(&outcome);
+    out->insert(out->end(), bytes, bytes + sizeof(outcome));
+  }
+
+  size_t cell_words = GetCellWords(rows, columns);
+  size_t keyframes_number = keyframe_interval
+      ? turns.size() / keyframe_interval : 0;
+  const std::vector<Keyframe>* written = &keyframes;
+  std::vector<Keyframe> made;
+  if (keyframes.size() != keyframes_number) {
+    made = ReplayPlayer::MakeKeyframes(*this);
+    written = &made;
+  }
+  for (const Keyframe& keyframe : *written) {
+    if (keyframe.cells.size() != cell_words)
+      throw std::runtime_error("replay keyframe size differs from board");
+    const char* bytes = reinterpret_cast<const char*>(&keyframe.score);
+    out->insert(out->end(), bytes, bytes + sizeof(keyframe.score));
+    bytes = reinterpret_cast<const char*>(keyframe.cells.data());
+    out->insert(out->end(), bytes, bytes + cell_words * sizeof(uint64_t));
+  }
+
+  int32_t cell_bits = GetBitsNumber(cells_number);
+  int32_t outcome_bits = GetBitsNumber(spawns.size());
+  BitWriter bits(out);
+  auto write_spawn = [&](const Spawn& spawn) {
+    if (spawn.cell < 0 || spawn.cell >= cells_number)
+      throw std::runtime_error("replay spawn is off the board");
+    bits.Write(spawn.cell, cell_bits);
+    bits.Write(GetOutcomeIndex(spawns, spawn.tile), outcome_bits);
+  };
+  for (const Spawn& spawn : initial_tiles)
+    write_spawn(spawn);
+  for (const Turn& turn : turns) {
+    if (turn.direction == Directions::kNone)
+      throw std::runtime_error("replay turn has no direction");
+    bits.Write(static_cast<uint32_t>(turn.direction), 2);
+    if (turn.spawn.cell >= 0)
+      write_spawn(turn.spawn);
+  }
+  bits.Finish();
+  out->resize((out->size() - begin + kAlignment - 1) / kAlignment
+              * kAlignment + begin);
+
+  header.size = out->size() - begin;
+  std::memcpy(out->data() + begin, &header, sizeof(header));
+}
+
+Replay Replay::Decode(const char* data, size_t size) {
+  size_t record_size = GetRecordSize(data, size);
+  if (!record_size)
+    throw std::runtime_error("replay record is truncated");
+  GameHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  size_t outcomes_end = sizeof(header)
+      + header.outcomes_number * sizeof(Outcome);
+  size_t cell_words = GetCellWords(header.rows, header.columns);
+  size_t keyframes_number = header.keyframe_interval
+      ? header.turns_number / header.keyframe_interval : 0;
+  size_t bits_begin = outcomes_end
+      + keyframes_number * (cell_words + 1) * sizeof(uint64_t);
+  if (!header.rows || !header.columns || !header.outcomes_number
+      || header.rule > static_cast<uint8_t>(MergeRules::kFibonacci)
+      || bits_begin > record_size
+      || header.turns_number / 4 > record_size - bits_begin)
+    throw std::runtime_error("replay record is malformed");
+
+  Replay replay;
+  replay.seed = header.seed;
+  replay.rows = header.rows;
+  replay.columns = header.columns;
+  replay.rule = static_cast<MergeRules>(header.rule);
+  replay.score = header.score;
+  replay.keyframe_interval = header.keyframe_interval;
+  for (int32_t i = 0; i < header.outcomes_number; i++) {
+    Outcome outcome;
+    std::memcpy(&outcome, data + sizeof(header) + i * sizeof(Outcome),
+                sizeof(outcome));
+    if (outcome.tile > static_cast<uint8_t>(Tiles::kTile_2048))
+      throw std::runtime_error("replay spawn outcome is malformed");
+    replay.spawns.push_back({static_cast<Tiles>(outcome.tile),
+                             outcome.probability});
+  }
+
+  replay.keyframes.resize(keyframes_number);
+  const char* keyframe_data = data + outcomes_end;
+  for (Keyframe& keyframe : replay.keyframes) {
+    std::memcpy(&keyframe.score, keyframe_data, sizeof(keyframe.score));
+    keyframe.cells.resize(cell_words);
+    std::memcpy(keyframe.cells.data(), keyframe_data + sizeof(uint64_t),
+                cell_words * sizeof(uint64_t));
+    keyframe_data += (cell_words + 1) * sizeof(uint64_t);
+  }
+
+  int32_t cells_number = replay.rows * replay.columns;
+  int32_t cell_bits = GetBitsNumber(cells_number);
+  int32_t outcome_bits = GetBitsNumber(replay.spawns.size());
+  BitReader bits(data + bits_begin, record_size - bits_begin);
+  auto read_spawn = [&]() {
+    Spawn spawn;
+    spawn.cell = bits.Read(cell_bits);
+    uint32_t outcome = bits.Read(outcome_bits);
+    if (spawn.cell >= cells_number || outcome >= replay.spawns.size())
+      throw std::runtime_error("replay spawn is malformed");
+    spawn.tile = replay.spawns[outcome].tile;
+    return spawn;
+  };
+  for (int32_t i = 0; i < header.initial_tiles_number; i++)
+    replay.initial_tiles.push_back(read_spawn());
+  replay.turns.resize(header.turns_number);
+  for (uint32_t i = 0; i < header.turns_number; i++) {
+    Turn& turn = replay.turns[i];
+    turn.direction = static_cast<Directions>(bits.Read(2));
+    bool last = i + 1 == header.turns_number;
+    if (last && (header.flags & kLastTurnWithoutSpawn))
+      turn.spawn = {-1, Tiles::kNoTile};
+    else
+      turn.spawn = read_spawn();
+  }
+  return replay;
+}
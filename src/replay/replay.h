@@ -0,0 +1,118 @@
+#ifndef _2048_REPLAY_REPLAY_H_
+#define _2048_REPLAY_REPLAY_H_
+
+#include "display/display.h"
+#include "logic/game_logic.h"
+#include "logic/spawn_distribution.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* A recorded game: the rules it was played with, the initial tiles and
+ * every move with the tile spawned after it. A cell is
+ * row * columns + column; only the last move may have no spawn (cell -1),
+ * e.g. when the game stopped on reaching 2048. */
+struct Replay {
+  static constexpr int32_t kKeyframeInterval = 128;
+
+  struct Spawn {
+    int32_t cell;
+    Tiles tile;
+  };
+
+  struct Turn {
+    Directions direction;
+    Spawn spawn;
+  };
+
+  /* the board packed one nibble per cell, 16 cells per word, and the score
+   * after a multiple of keyframe_interval moves */
+  struct Keyframe {
+    int64_t score;
+    std::vector<uint64_t> cells;
+  };
+
+  /* the keyframe of the board of logic */
+  static Keyframe MakeKeyframe(const GameLogic& logic, int64_t score);
+
+  /* appends the record of the game to out, with keyframes made by
+   * ReplayPlayer::MakeKeyframes unless keyframes already holds one for
+   * every keyframe_interval moves */
+  void Encode(std::vector<char>* out) const;
+
+  /* record at the start of data, throws if it is malformed or truncated */
+  static Replay Decode(const char* data, size_t size);
+
+  uint64_t seed = 0;
+  int32_t rows = 0;
+  int32_t columns = 0;
+  MergeRules rule = MergeRules::kPowerOfTwo;
+  std::vector<SpawnDistribution::Outcome> spawns;
+  std::vector<Spawn> initial_tiles;
+  std::vector<Turn> turns;
+  int64_t score = 0;
+  /* moves between keyframes, 0 for a record without them */
+  int32_t keyframe_interval = kKeyframeInterval;
+  /* keyframe k is the state after (k + 1) * keyframe_interval moves */
+  std::vector<Keyframe> keyframes;
+};
+
+/* A replay file is a FileHeader followed by game records. A record is a
+ * GameHeader, its spawn outcomes, its keyframes (score, then cell words),
+ * then a bit stream, least significant bit first: for every initial tile
+ * its cell and spawn outcome index, for every turn a 2-bit direction, the
+ * spawn cell and outcome index. Cells take just enough bits for the board
+ * and outcomes for their number, so a 4x4 game with 2s and 4s costs 7 bits
+ * a move plus 16 bytes a keyframe. Records are padded to 8 bytes, so that
+ * the headers of a mapped file are aligned. */
+namespace replay_format {
+
+constexpr char kMagic[8] = "2048RPL";
+constexpr uint32_t kVersion = 1;
+constexpr size_t kAlignment = 8;
+
+/* GameHeader::flags */
+constexpr uint8_t kLastTurnWithoutSpawn = 1;
+
+struct FileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+};
+
+struct GameHeader {
+  /* the whole record, padding included */
+  uint32_t size;
+  uint32_t turns_number;
+  uint64_t seed;
+  int64_t score;
+  uint8_t rows;
+  uint8_t columns;
+  uint8_t rule;
+  uint8_t outcomes_number;
+  uint8_t initial_tiles_number;
+  uint8_t flags;
+  uint16_t keyframe_interval;
+};
+
+/* the probability is kept exact, so that re-simulation rebuilds the
+ * sampling table of the game bit for bit */
+struct Outcome {
+  uint8_t tile;
+  uint8_t reserved[7];
+  double probability;
+};
+
+/* bits taking any of number values, 0 for a single one */
+int32_t GetBitsNumber(size_t number);
+
+/* size of the record starting at data if it is complete, 0 otherwise */
+size_t GetRecordSize(const char* data, size_t size);
+
+/* words of Keyframe::cells for the board */
+size_t GetCellWords(int32_t rows, int32_t columns);
+
+}  // namespace replay_format
+
+#endif
@@ -0,0 +1,67 @@
+#include "replay/replay_file.h"
+#include "replay/replay.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+ReplayFile::ReplayFile(const std::string& path)
+    : data_(nullptr)
+    , size_(0)
+    , trailing_bytes_(0) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("cannot open replay file " + path);
+  struct stat info;
+  if (fstat(fd, &info) || info.st_size < static_cast<off_t>(
+          sizeof(replay_format::FileHeader))) {
+    close(fd);
+    throw std::runtime_error("replay file is truncated: " + path);
+  }
+  size_ = info.st_size;
+  void* data = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+    throw std::runtime_error("cannot map replay file " + path);
+  data_ = static_cast<const char*>(data);
+
+  replay_format::FileHeader header;
+  std::memcpy(&header, data_, sizeof(header));
+  if (std::memcmp(header.magic, replay_format::kMagic, sizeof(header.magic))
+      || header.version != replay_format::kVersion) {
+    munmap(data, size_);
+    throw std::runtime_error("not a replay file: " + path);
+  }
+
+  size_t offset = sizeof(header);
+  while (offset < size_) {
+    size_t record_size = replay_format::GetRecordSize(data_ + offset,
+                                                      size_ - offset);
+    if (record_size < sizeof(replay_format::GameHeader))
+      break;
+    offsets_.push_back(offset);
+    offset += record_size;
+  }
+  trailing_bytes_ = size_ - offset;
+}
+
+ReplayFile::~ReplayFile() {
+  munmap(const_cast<char*>(data_), size_);
+}
+
+Replay ReplayFile::GetGame(size_t game_idx) const {
+  uint64_t offset = offsets_[game_idx];
+  return Replay::Decode(data_ + offset, size_ - offset);
+}
+
+size_t ReplayFile::GetRecordSize(size_t game_idx) const {
+  uint64_t offset = offsets_[game_idx];
+  return replay_format::GetRecordSize(data_ + offset, size_ - offset);
+}
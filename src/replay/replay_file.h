@@ -0,0 +1,50 @@
+#ifndef _2048_REPLAY_REPLAY_FILE_H_
+#define _2048_REPLAY_REPLAY_FILE_H_
+
+#include "replay/replay.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Read-only view of a mapped replay file with the offsets of its games.
+ * A record cut short by a crash of the writer ends the index and is
+ * reported by GetTrailingBytes. */
+class ReplayFile {
+ public:
+  explicit ReplayFile(const std::string& path);
+  ~ReplayFile();
+
+  ReplayFile(const ReplayFile&) = delete;
+  ReplayFile& operator=(const ReplayFile&) = delete;
+
+  size_t GetGamesNumber() const {
+    return offsets_.size();
+  }
+
+  /* throws if the record is malformed */
+  Replay GetGame(size_t game_idx) const;
+
+  const char* GetRecord(size_t game_idx) const {
+    return data_ + offsets_[game_idx];
+  }
+
+  size_t GetRecordSize(size_t game_idx) const;
+
+  size_t GetSize() const {
+    return size_;
+  }
+
+  size_t GetTrailingBytes() const {
+    return trailing_bytes_;
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+  std::vector<uint64_t> offsets_;
+  size_t trailing_bytes_;
+};
+
+#endif
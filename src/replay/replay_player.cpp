@@ -0,0 +1,110 @@
+#include "replay/replay_player.h"
+#include "logic/game_logic.h"
+#include "logic/spawn_distribution.h"
+#include "replay/replay.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+ReplayPlayer::ReplayPlayer(Replay replay)
+    : replay_(std::move(replay))
+    , move_(0)
+    , score_(0) {
+  /* a record without keyframes gets them at the default interval */
+  if (!replay_.keyframe_interval)
+    replay_.keyframe_interval = Replay::kKeyframeInterval;
+  if (replay_.keyframe_interval < 0)
+    throw std::runtime_error("replay keyframe interval is out of range");
+  if (replay_.keyframes.size()
+      != replay_.turns.size() / replay_.keyframe_interval)
+    replay_.keyframes = MakeKeyframes(replay_);
+  LoadInitialTiles();
+}
+
+std::vector<Replay::Keyframe> ReplayPlayer::MakeKeyframes(
+    const Replay& replay) {
+  if (replay.keyframe_interval <= 0)
+    return {};
+  Replay moves = replay;
+  moves.keyframes.clear();
+  /* an interval longer than the game needs no keyframes, which keeps the
+   * constructor from coming back here */
+  moves.keyframe_interval = replay.turns.size() + 1;
+  ReplayPlayer player(std::move(moves));
+  std::vector<Replay::Keyframe> keyframes;
+  for (int32_t k = replay.keyframe_interval; k <= player.GetMovesNumber();
+       k += replay.keyframe_interval) {
+    while (player.GetMove() < k)
+      player.Step();
+    keyframes.push_back(Replay::MakeKeyframe(player.GetLogic(),
+                                             player.GetScore()));
+  }
+  return keyframes;
+}
+
+void ReplayPlayer::Step() {
+  if (move_ >= GetMovesNumber())
+    return;
+  const Replay::Turn& turn = replay_.turns[move_];
+  logic_->ResetStates();
+  logic_->Move(turn.direction);
+  score_ += logic_->GetMoveScore();
+  if (turn.spawn.cell >= 0)
+    logic_->SetTile(turn.spawn.cell / replay_.columns,
+                    turn.spawn.cell % replay_.columns, turn.spawn.tile);
+  move_++;
+}
+
+void ReplayPlayer::Seek(int32_t move) {
+  move = std::max(0, std::min(move, GetMovesNumber()));
+  int32_t interval = replay_.keyframe_interval;
+  /* the last move is played rather than loaded, a keyframe does not keep
+   * the win that may end the game on it */
+  int32_t keyframe = std::max(0, std::min(move, GetMovesNumber() - 1))
+      / interval;
+  /* stepping on is cheaper while no keyframe lies in between */
+  if (move < move_ || keyframe > move_ / interval) {
+    if (keyframe)
+      LoadKeyframe(replay_.keyframes[keyframe - 1]);
+    else
+      LoadInitialTiles();
+    move_ = keyframe * interval;
+  }
+  while (move_ < move)
+    Step();
+}
+
+/* a fresh logic, since SetTile does not take back the end of a game played
+ * past the state loaded */
+void ReplayPlayer::ResetLogic() {
+  logic_ = GameLogic::Create(replay_.rows, replay_.columns, replay_.rule,
+                             SpawnDistribution(replay_.spawns), replay_.seed);
+  logic_->ResetStates();
+}
+
+void ReplayPlayer::LoadInitialTiles() {
+  ResetLogic();
+  for (int32_t i = 0; i < replay_.rows; i++)
+    for (int32_t j = 0; j < replay_.columns; j++)
+      logic_->SetTile(i, j, Tiles::kNoTile);
+  for (const Replay::Spawn& spawn : replay_.initial_tiles)
+    logic_->SetTile(spawn.cell / replay_.columns,
+                    spawn.cell % replay_.columns, spawn.tile);
+  move_ = 0;
+  score_ = 0;
+}
+
+void ReplayPlayer::LoadKeyframe(const Replay::Keyframe& keyframe) {
+  ResetLogic();
+  for (int32_t i = 0; i < replay_.rows; i++) {
+    for (int32_t j = 0; j < replay_.columns; j++) {
+      int32_t cell = i * replay_.columns + j;
+      logic_->SetTile(i, j, static_cast<Tiles>(
+          (keyframe.cells[cell / 16] >> (4 * (cell % 16))) & 0xF));
+    }
+  }
+  score_ = keyframe.score;
+}
@@ -0,0 +1,62 @@
+#ifndef _2048_REPLAY_REPLAY_PLAYER_H_
+#define _2048_REPLAY_REPLAY_PLAYER_H_
+
+#include "logic/game_logic.h"
+#include "replay/replay.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/* Plays a recorded game on a GameLogic, placing the recorded spawns. Seek
+ * starts from the last keyframe at or before the move (before it for the
+ * last move of the game), so it replays at most keyframe_interval moves
+ * wherever it jumps. Moves are not checked,
+ * ReplayVerifier does that. */
+class ReplayPlayer {
+ public:
+  /* makes the keyframes if the replay does not have them */
+  explicit ReplayPlayer(Replay replay);
+
+  static std::vector<Replay::Keyframe> MakeKeyframes(const Replay& replay);
+
+  const Replay& GetReplay() const {
+    return replay_;
+  }
+
+  const GameLogic& GetLogic() const {
+    return *logic_;
+  }
+
+  /* moves played so far */
+  int32_t GetMove() const {
+    return move_;
+  }
+
+  int32_t GetMovesNumber() const {
+    return replay_.turns.size();
+  }
+
+  int64_t GetScore() const {
+    return score_;
+  }
+
+  /* plays the next move and its spawn, the move events stay in the logic
+   * until the next Step or Seek */
+  void Step();
+
+  /* clamped to the moves of the game */
+  void Seek(int32_t move);
+
+ private:
+  void ResetLogic();
+  void LoadInitialTiles();
+  void LoadKeyframe(const Replay::Keyframe& keyframe);
+
+  Replay replay_;
+  std::unique_ptr<GameLogic> logic_;
+  int32_t move_;
+  int64_t score_;
+};
+
+#endif
@@ -0,0 +1,114 @@
+#include "replay/replay_player.h"
+#include "logic/game_logic.h"
+#include "logic/spawn_distribution.h"
+#include "replay/replay.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr Directions kDirections[] = {Directions::kLeft, Directions::kRight,
+                                      Directions::kUp, Directions::kDown};
+
+/* a random game recorded the way the engine does, states[k] holding the
+ * board and score after k moves */
+Replay RecordGame(int32_t length, uint64_t seed, int32_t keyframe_interval,
+                  std::vector<Replay::Keyframe>* states) {
+  SpawnDistribution spawns = SpawnDistribution::Standard();
+  std::unique_ptr<GameLogic> logic = GameLogic::Create(
+      length, length, MergeRules::kPowerOfTwo, spawns, seed);
+  Replay replay;
+  replay.seed = seed;
+  replay.rows = replay.columns = length;
+  replay.spawns = spawns.GetOutcomes();
+  replay.keyframe_interval = keyframe_interval;
+  for (int32_t cell = 0; cell < length * length; cell++) {
+    Tiles value = logic->GetTile(cell / length, cell % length).value;
+    if (value != Tiles::kNoTile)
+      replay.initial_tiles.push_back({cell, value});
+  }
+  int64_t score = 0;
+  states->assign(1, Replay::MakeKeyframe(*logic, score));
+  std::mt19937_64 rng(seed);
+  /* a stuck board changes on no move, the tries run out on it */
+  for (int32_t k = 0; k < 4000 && !logic->IsGameOver()
+       && replay.turns.size() < 1000; k++) {
+    Directions direction = kDirections[rng() % 4];
+    logic->ResetStates();
+    logic->Move(direction);
+    if (!logic->HasSomethingChanged())
+      continue;
+    score += logic->GetMoveScore();
+    logic->NewTile();
+    Replay::Spawn spawn = {-1, Tiles::kNoTile};
+    int32_t row = logic->GetNewTileRow(), column = logic->GetNewTileColumn();
+    if (row >= 0)
+      spawn = {row * length + column, logic->GetTile(row, column).value};
+    replay.turns.push_back({direction, spawn});
+    states->push_back(Replay::MakeKeyframe(*logic, score));
+  }
+  replay.score = score;
+  return replay;
+}
+
+void ExpectState(const Replay::Keyframe& expected,
+                 const ReplayPlayer& player) {
+  Replay::Keyframe actual = Replay::MakeKeyframe(player.GetLogic(),
+                                                 player.GetScore());
+  EXPECT_EQ(expected.score, actual.score);
+  EXPECT_EQ(expected.cells, actual.cells);
+}
+
+}  // namespace
+
+/* random jumps, backwards and across keyframes, land on the state reached
+ * by playing the game from the start */
+TEST(ReplayPlayerTest, SeekMatchesStepping) {
+  for (int32_t length : {3, 4, 5}) {
+    for (uint64_t seed = 0; seed < 4; seed++) {
+      SCOPED_TRACE(length * 100 + seed);
+      std::vector<Replay::Keyframe> states;
+      Replay replay = RecordGame(length, seed, 1 + seed * 5, &states);
+      ReplayPlayer player(replay);
+      ASSERT_EQ(replay.turns.size() / replay.keyframe_interval,
+                player.GetReplay().keyframes.size());
+      ExpectState(states[0], player);
+
+      std::mt19937_64 rng(seed);
+      for (int32_t k = 0; k < 200; k++) {
+        int32_t move = rng() % (states.size() + 2) - 1;
+        player.Seek(move);
+        move = std::max(0, std::min<int32_t>(move, states.size() - 1));
+        ASSERT_EQ(move, player.GetMove());
+        ExpectState(states[move], player);
+        if (::testing::Test::HasFailure())
+          return;
+      }
+    }
+  }
+}
+
+/* the win ends the game, seeking back before it has to take that back
+ * whether it starts from a keyframe or from the initial tiles */
+TEST(ReplayPlayerTest, SeekBackResetsGameOver) {
+  Replay replay;
+  replay.rows = replay.columns = 4;
+  replay.spawns = SpawnDistribution::Standard().GetOutcomes();
+  replay.keyframe_interval = 1;
+  replay.initial_tiles = {{0, Tiles::kTile_1024}, {1, Tiles::kTile_1024}};
+  replay.turns = {{Directions::kDown, {0, Tiles::kTile_2}},
+                  {Directions::kLeft, {1, Tiles::kTile_2}}};
+  ReplayPlayer player(replay);
+  for (int32_t move : {2, 1, 2, 0}) {
+    SCOPED_TRACE(move);
+    player.Seek(move);
+    EXPECT_EQ(move == 2, player.GetLogic().IsGameOver());
+    EXPECT_EQ(move == 2, player.GetLogic().IsSuccess());
+  }
+}
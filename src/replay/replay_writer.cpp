@@ -0,0 +1,126 @@
+#include "replay/replay_writer.h"
+#include "replay/replay.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+constexpr size_t ReplayWriter::kBufferSize;
+
+/* a new or empty file gets the header, an existing one must have it */
+static bool NeedsHeader(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in || in.peek() == std::ifstream::traits_type::eof())
+    return true;
+  replay_format::FileHeader header;
+  in.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!in || std::memcmp(header.magic, replay_format::kMagic,
+                         sizeof(header.magic))
+      || header.version != replay_format::kVersion)
+    throw std::runtime_error("not a replay file: " + path);
+  return false;
+}
+
+ReplayWriter::ReplayWriter(const std::string& path)
+    : path_(path)
+    , closing_(false)
+    , games_number_(0) {
+  bool needs_header = NeedsHeader(path);
+  out_.open(path, std::ios::binary | std::ios::app);
+  if (!out_)
+    throw std::runtime_error("cannot open " + path);
+  buffer_.reserve(kBufferSize);
+  if (needs_header) {
+    replay_format::FileHeader header = {};
+    std::memcpy(header.magic, replay_format::kMagic, sizeof(header.magic));
+    header.version = replay_format::kVersion;
+    const char* bytes = reinterpret_cast<const char*>(&header);
+    buffer_.insert(buffer_.end(), bytes, bytes + sizeof(header));
+  }
+  writer_ = std::thread(&ReplayWriter::WriteLoop, this);
+}
+
+ReplayWriter::~ReplayWriter() {
+  if (writer_.joinable()) {
+    try {
+      Close();
+    } catch (...) {}
+  }
+}
+
+void ReplayWriter::Write(const Replay& replay) {
+  std::vector<char> record;
+  replay.Encode(&record);
+  std::unique_lock<std::mutex> lock(mutex_);
+  CheckError();
+  buffer_.insert(buffer_.end(), record.begin(), record.end());
+  games_number_++;
+  if (buffer_.size() >= kBufferSize)
+    HandOver(lock);
+}
+
+void ReplayWriter::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  CheckError();
+  if (!buffer_.empty())
+    HandOver(lock);
+}
+
+void ReplayWriter::Close() {
+  if (!writer_.joinable())
+    return;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!buffer_.empty())
+      HandOver(lock);
+    closing_ = true;
+  }
+  has_pending_.notify_one();
+  writer_.join();
+  out_.close();
+  CheckError();
+}
+
+int64_t ReplayWriter::GetGamesNumber() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return games_number_;
+}
+
+void ReplayWriter::HandOver(std::unique_lock<std::mutex>& lock) {
+  pending_.push_back(std::move(buffer_));
+  buffer_ = std::vector<char>();
+  buffer_.reserve(kBufferSize);
+  lock.unlock();
+  has_pending_.notify_one();
+  lock.lock();
+}
+
+void ReplayWriter::CheckError() {
+  if (error_)
+    std::rethrow_exception(error_);
+}
+
+void ReplayWriter::WriteLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    has_pending_.wait(lock, [this] { return closing_ || !pending_.empty(); });
+    if (pending_.empty())
+      return;
+    std::vector<char> buffer = std::move(pending_.front());
+    pending_.pop_front();
+    lock.unlock();
+    out_.write(buffer.data(), buffer.size());
+    out_.flush();
+    lock.lock();
+    if (!out_ && !error_)
+      error_ = std::make_exception_ptr(
+          std::runtime_error("cannot write " + path_));
+  }
+}
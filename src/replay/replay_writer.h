@@ -0,0 +1,59 @@
+#ifndef _2048_REPLAY_REPLAY_WRITER_H_
+#define _2048_REPLAY_REPLAY_WRITER_H_
+
+#include "replay/replay.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Appends games to a replay file, creating it if needed. Write only
+ * encodes the game into a memory buffer; full buffers go to a background
+ * thread that writes them to disk, so recording never waits for the disk.
+ * Write may be called from several threads; errors of the background
+ * thread are thrown by the next Write, Flush or Close. */
+class ReplayWriter {
+ public:
+  explicit ReplayWriter(const std::string& path);
+  ~ReplayWriter();
+
+  ReplayWriter(const ReplayWriter&) = delete;
+  ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+  void Write(const Replay& replay);
+
+  /* hands the buffered games to the background thread without waiting */
+  void Flush();
+
+  /* waits until every game is on disk */
+  void Close();
+
+  int64_t GetGamesNumber() const;
+
+ private:
+  static constexpr size_t kBufferSize = 1 << 20;
+
+  void HandOver(std::unique_lock<std::mutex>& lock);
+  void CheckError();
+  void WriteLoop();
+
+  std::string path_;
+  std::ofstream out_;
+  mutable std::mutex mutex_;
+  std::condition_variable has_pending_;
+  std::vector<char> buffer_;
+  std::deque<std::vector<char>> pending_;
+  bool closing_;
+  std::exception_ptr error_;
+  int64_t games_number_;
+  std::thread writer_;
+};
+
+#endif
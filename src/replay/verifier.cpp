@@ -0,0 +1,171 @@
+#include "replay/verifier.h"
+#include "ai/board.h"
+#include "logic/game_logic.h"
+#include "logic/spawn_distribution.h"
+#include "parallel/parallel.h"
+#include "replay/replay.h"
+#include "replay/replay_file.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+constexpr size_t ReplayVerifier::kMaxFailures;
+constexpr size_t ReplayVerifier::kChunkSize;
+
+namespace {
+
+using Problems = ReplayVerifier::Problems;
+using Failure = ReplayVerifier::Failure;
+
+bool IsSameSpawn(const Replay::Spawn& a, const Replay::Spawn& b) {
+  return a.cell == b.cell && a.tile == b.tile;
+}
+
+/* the fast path, with the spawn stream of Simulator::NewTile */
+Failure VerifyPacked(const Replay& replay,
+                     const SpawnDistribution& spawns, int64_t* moves) {
+  std::mt19937_64 rng(replay.seed);
+  Board board;
+  auto spawn = [&](const Replay::Spawn& recorded) {
+    int32_t free = board.CountEmpty();
+    if (!free)
+      return false;
+    int32_t cell = board.GetEmptyCell(rng() % free);
+    Tiles tile = spawns.Sample(rng);
+    board.SetTile(cell / Board::kLength, cell % Board::kLength, tile);
+    return IsSameSpawn({cell, tile}, recorded);
+  };
+  for (const Replay::Spawn& recorded : replay.initial_tiles)
+    if (!spawn(recorded))
+      return {0, -1, Problems::kSpawnMismatch};
+
+  int64_t score = 0;
+  for (size_t i = 0; i < replay.turns.size(); i++) {
+    const Replay::Turn& turn = replay.turns[i];
+    int32_t move_score = 0;
+    Board moved = board.Move(turn.direction, &move_score);
+    if (moved == board)
+      return {0, static_cast<int32_t>(i), Problems::kInvalidMove};
+    (*moves)++;
+    board = moved;
+    score += move_score;
+    if (turn.spawn.cell >= 0 && !spawn(turn.spawn))
+      return {0, static_cast<int32_t>(i), Problems::kSpawnMismatch};
+  }
+  if (score != replay.score)
+    return {0, -1, Problems::kScoreMismatch};
+  return {0, 0, Problems::kNone};
+}
+
+/* the spawn stream of the seeded logic itself */
+Failure VerifyLogic(const Replay& replay, const SpawnDistribution& spawns,
+                    int64_t* moves) {
+  std::unique_ptr<GameLogic> logic = GameLogic::Create(
+      replay.rows, replay.columns, replay.rule, spawns, replay.seed);
+  std::vector<Tiles> initial(replay.rows * replay.columns, Tiles::kNoTile);
+  for (const Replay::Spawn& recorded : replay.initial_tiles)
+    initial[recorded.cell] = recorded.tile;
+  for (int32_t i = 0; i < replay.rows; i++)
+    for (int32_t j = 0; j < replay.columns; j++)
+      if (logic->GetTile(i, j).value != initial[i * replay.columns + j])
+        return {0, -1, Problems::kSpawnMismatch};
+
+  int64_t score = 0;
+  for (size_t i = 0; i < replay.turns.size(); i++) {
+    const Replay::Turn& turn = replay.turns[i];
+    logic->ResetStates();
+    logic->Move(turn.direction);
+    if (!logic->HasSomethingChanged())
+      return {0, static_cast<int32_t>(i), Problems::kInvalidMove};
+    (*moves)++;
+    score += logic->GetMoveScore();
+    if (turn.spawn.cell < 0)
+      continue;
+    logic->NewTile();
+    int32_t row = logic->GetNewTileRow(), column = logic->GetNewTileColumn();
+    if (row < 0 || !IsSameSpawn({row * replay.columns + column,
+                                 logic->GetTile(row, column).value},
+                                turn.spawn))
+      return {0, static_cast<int32_t>(i), Problems::kSpawnMismatch};
+  }
+  if (replay.rule == MergeRules::kPowerOfTwo && score != replay.score)
+    return {0, -1, Problems::kScoreMismatch};
+  return {0, 0, Problems::kNone};
+}
+
+}  // namespace
+
+ReplayVerifier::Failure ReplayVerifier::VerifyGame(const Replay& replay,
+                                                   int64_t* moves) {
+  if (replay.initial_tiles.size() != GameLogic::kInitialTilesNumber)
+    return {0, -1, Problems::kSpawnMismatch};
+  SpawnDistribution spawns(replay.spawns);
+  if (replay.rows == Board::kLength && replay.columns == Board::kLength
+      && replay.rule == MergeRules::kPowerOfTwo)
+    return VerifyPacked(replay, spawns, moves);
+  return VerifyLogic(replay, spawns, moves);
+}
+
+ReplayVerifier::Report ReplayVerifier::Verify(const ReplayFile& file,
+                                              int32_t threads_number) {
+  auto start = std::chrono::steady_clock::now();
+  Report report;
+  report.games = file.GetGamesNumber();
+  report.problems.assign(static_cast<size_t>(Problems::kScoreMismatch) + 1,
+                         0);
+  std::mutex mutex;
+  ParallelFor(file.GetGamesNumber(), kChunkSize,
+              GetThreadsNumber(threads_number),
+              [&](size_t begin, size_t end, int32_t) {
+    int64_t moves = 0;
+    std::vector<Failure> failures;
+    for (size_t k = begin; k < end; k++) {
+      Failure failure = {k, -1, Problems::kMalformed};
+      try {
+        failure = VerifyGame(file.GetGame(k), &moves);
+        failure.game_idx = k;
+      } catch (const std::runtime_error&) {}
+      if (failure.problem != Problems::kNone)
+        failures.push_back(failure);
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    report.moves += moves;
+    for (const Failure& failure : failures)
+      report.problems[static_cast<size_t>(failure.problem)]++;
+    report.failures.insert(report.failures.end(), failures.begin(),
+                           failures.end());
+  });
+  std::sort(report.failures.begin(), report.failures.end(),
+            [](const Failure& a, const Failure& b) {
+    return a.game_idx < b.game_idx;
+  });
+  if (report.failures.size() > kMaxFailures)
+    report.failures.resize(kMaxFailures);
+  report.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  return report;
+}
+
+const char* ReplayVerifier::GetProblemName(Problems problem) {
+  switch (problem) {
+    case Problems::kNone:
+      return "none";
+    case Problems::kMalformed:
+      return "malformed record";
+    case Problems::kInvalidMove:
+      return "invalid move";
+    case Problems::kSpawnMismatch:
+      return "mismatching spawn";
+    case Problems::kScoreMismatch:
+      return "mismatching score";
+    default:
+      return "unknown";
+  }
+}
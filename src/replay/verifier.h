@@ -0,0 +1,58 @@
+#ifndef _2048_REPLAY_VERIFIER_H_
+#define _2048_REPLAY_VERIFIER_H_
+
+#include "replay/replay.h"
+#include "replay/replay_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* Re-simulates recorded games: every move must change the board, every
+ * spawn must be the one the seed of the game draws (the spawn stream of
+ * Logic and Simulator) and the recorded score must be the one of the
+ * moves. 4x4 power of two games run on packed boards, the others on
+ * GameLogic. A game is checked up to its first problem. */
+class ReplayVerifier {
+ public:
+  enum class Problems {
+    kNone,
+    kMalformed,
+    kInvalidMove,
+    kSpawnMismatch,
+    kScoreMismatch,
+  };
+
+  struct Failure {
+    size_t game_idx;
+    /* -1 for the initial tiles and for the score */
+    int32_t turn;
+    Problems problem;
+  };
+
+  struct Report {
+    int64_t games = 0;
+    int64_t moves = 0;
+    /* games per problem, indexed by Problems */
+    std::vector<int64_t> problems;
+    /* the first kMaxFailures failed games in file order */
+    std::vector<Failure> failures;
+    double seconds = 0;
+  };
+
+  static constexpr size_t kMaxFailures = 100;
+
+  /* zero or negative threads number means one per hardware thread */
+  static Report Verify(const ReplayFile& file, int32_t threads_number = 0);
+
+  /* turn and problem of the first failure, moves gets the number of
+   * re-simulated moves */
+  static Failure VerifyGame(const Replay& replay, int64_t* moves);
+
+  static const char* GetProblemName(Problems problem);
+
+ private:
+  static constexpr size_t kChunkSize = 64;
+};
+
+#endif
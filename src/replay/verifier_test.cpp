@@ -0,0 +1,288 @@
+#include "replay/verifier.h"
+#include "logic/game_logic.h"
+#include "logic/spawn_distribution.h"
+#include "replay/replay.h"
+#include "replay/replay_file.h"
+#include "replay/replay_player.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Problems = ReplayVerifier::Problems;
+
+constexpr Directions kDirections[] = {Directions::kLeft, Directions::kRight,
+                                      Directions::kUp, Directions::kDown};
+
+/* a random game recorded the way the engine does, the initial tiles in
+ * the order they were spawned */
+Replay RecordGame(int32_t length, uint64_t seed) {
+  SpawnDistribution spawns = SpawnDistribution::Standard();
+  std::unique_ptr<GameLogic> logic = GameLogic::Create(
+      length, length, MergeRules::kPowerOfTwo, spawns, seed);
+  Replay replay;
+  replay.seed = seed;
+  replay.rows = replay.columns = length;
+  replay.spawns = spawns.GetOutcomes();
+  int32_t last = logic->GetNewTileRow() * length + logic->GetNewTileColumn();
+  for (int32_t cell = 0; cell < length * length; cell++) {
+    Tiles value = logic->GetTile(cell / length, cell % length).value;
+    if (value != Tiles::kNoTile && cell != last)
+      replay.initial_tiles.push_back({cell, value});
+  }
+  replay.initial_tiles.push_back(
+      {last, logic->GetTile(last / length, last % length).value});
+  std::mt19937_64 rng(seed);
+  /* a stuck board changes on no move, the tries run out on it */
+  for (int32_t k = 0; k < 4000 && !logic->IsGameOver()
+       && replay.turns.size() < 300; k++) {
+    Directions direction = kDirections[rng() % 4];
+    logic->ResetStates();
+    logic->Move(direction);
+    if (!logic->HasSomethingChanged())
+      continue;
+    replay.score += logic->GetMoveScore();
+    logic->NewTile();
+    Replay::Spawn spawn = {-1, Tiles::kNoTile};
+    int32_t row = logic->GetNewTileRow(), column = logic->GetNewTileColumn();
+    if (row >= 0)
+      spawn = {row * length + column, logic->GetTile(row, column).value};
+    replay.turns.push_back({direction, spawn});
+  }
+  return replay;
+}
+
+/* what re-simulating the game on GameLogic finds first, the reference for
+ * the packed boards */
+ReplayVerifier::Failure VerifyOnLogic(const Replay& replay, int64_t* moves) {
+  std::unique_ptr<GameLogic> logic = GameLogic::Create(
+      replay.rows, replay.columns, replay.rule,
+      SpawnDistribution(replay.spawns), replay.seed);
+  int32_t score = 0;
+  for (size_t i = 0; i < replay.turns.size(); i++) {
+    const Replay::Turn& turn = replay.turns[i];
+    logic->ResetStates();
+    logic->Move(turn.direction);
+    if (!logic->HasSomethingChanged())
+      return {0, static_cast<int32_t>(i), Problems::kInvalidMove};
+    (*moves)++;
+    score += logic->GetMoveScore();
+    if (turn.spawn.cell < 0)
+      continue;
+    logic->NewTile();
+    int32_t row = logic->GetNewTileRow(), column = logic->GetNewTileColumn();
+    if (row * replay.columns + column != turn.spawn.cell
+        || logic->GetTile(row, column).value != turn.spawn.tile)
+      return {0, static_cast<int32_t>(i), Problems::kSpawnMismatch};
+  }
+  if (score != replay.score)
+    return {0, -1, Problems::kScoreMismatch};
+  return {0, 0, Problems::kNone};
+}
+
+/* the first turn from the middle of the game on that some direction does
+ * not change the board before, with that direction */
+int32_t FindInvalidMove(const Replay& replay, Directions* direction) {
+  ReplayPlayer player(replay);
+  for (int32_t k = player.GetMovesNumber() / 2; k < player.GetMovesNumber();
+       k++) {
+    player.Seek(k);
+    for (Directions candidate : kDirections) {
+      std::unique_ptr<GameLogic> logic = player.GetLogic().Clone();
+      logic->ResetStates();
+      logic->Move(candidate);
+      if (!logic->HasSomethingChanged()) {
+        *direction = candidate;
+        return k;
+      }
+    }
+  }
+  return -1;
+}
+
+/* the other outcome of the standard spawns at turn k */
+void ChangeSpawn(Replay* replay, int32_t k) {
+  Replay::Spawn& spawn = replay->turns[k].spawn;
+  spawn.tile = spawn.tile == Tiles::kTile_2 ? Tiles::kTile_4 : Tiles::kTile_2;
+}
+
+std::vector<char> MakeFile(const std::vector<Replay>& games) {
+  replay_format::FileHeader header = {};
+  std::memcpy(header.magic, replay_format::kMagic, sizeof(header.magic));
+  header.version = replay_format::kVersion;
+  const char* bytes = reinterpret_cast<const char*>(&header);
+  std::vector<char> data(bytes, bytes + sizeof(header));
+  for (const Replay& game : games)
+    game.Encode(&data);
+  return data;
+}
+
+void WriteFile(const std::string& path, const std::vector<char>& data) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(data.data(), data.size());
+}
+
+void ExpectFailure(size_t game_idx, int32_t turn, Problems problem,
+                   const ReplayVerifier::Failure& actual) {
+  EXPECT_EQ(game_idx, actual.game_idx);
+  EXPECT_EQ(turn, actual.turn);
+  EXPECT_EQ(problem, actual.problem);
+}
+
+}  // namespace
+
+/* a record cut short, as by a crashed writer, ends the index; so do bytes
+ * after the last record that are no record */
+TEST(ReplayFileTest, ReportsTruncatedAndTrailingBytes) {
+  std::string path = ::testing::TempDir() + "2048_replay_file_test.rpl";
+  std::vector<Replay> games = {RecordGame(4, 1), RecordGame(5, 2),
+                               RecordGame(3, 3)};
+  std::vector<char> data = MakeFile(games);
+  WriteFile(path, data);
+  {
+    ReplayFile file(path);
+    ASSERT_EQ(games.size(), file.GetGamesNumber());
+    EXPECT_EQ(0u, file.GetTrailingBytes());
+    for (size_t i = 0; i < games.size(); i++) {
+      Replay game = file.GetGame(i);
+      EXPECT_EQ(games[i].seed, game.seed);
+      EXPECT_EQ(games[i].rows, game.rows);
+      EXPECT_EQ(games[i].turns.size(), game.turns.size());
+      EXPECT_EQ(games[i].score, game.score);
+    }
+  }
+
+  size_t last_size = 0;
+  {
+    ReplayFile file(path);
+    last_size = file.GetRecordSize(games.size() - 1);
+  }
+  std::vector<char> truncated(data.begin(), data.end() - 5);
+  WriteFile(path, truncated);
+  {
+    ReplayFile file(path);
+    EXPECT_EQ(games.size() - 1, file.GetGamesNumber());
+    EXPECT_EQ(last_size - 5, file.GetTrailingBytes());
+  }
+
+  std::vector<char> trailing = data;
+  trailing.resize(data.size() + 3, 1);
+  WriteFile(path, trailing);
+  {
+    ReplayFile file(path);
+    EXPECT_EQ(games.size(), file.GetGamesNumber());
+    EXPECT_EQ(3u, file.GetTrailingBytes());
+  }
+
+  WriteFile(path, std::vector<char>(data.begin(), data.begin() + 10));
+  EXPECT_THROW(ReplayFile file(path), std::runtime_error);
+  std::vector<char> other_version = data;
+  other_version[offsetof(replay_format::FileHeader, version)]++;
+  WriteFile(path, other_version);
+  EXPECT_THROW(ReplayFile file(path), std::runtime_error);
+  std::remove(path.c_str());
+}
+
+TEST(ReplayVerifierTest, AcceptsRecordedGames) {
+  for (int32_t length = 3; length <= 6; length++) {
+    for (uint64_t seed = 0; seed < 5; seed++) {
+      SCOPED_TRACE(length * 100 + seed);
+      Replay replay = RecordGame(length, seed);
+      int64_t moves = 0;
+      ReplayVerifier::Failure failure =
+          ReplayVerifier::VerifyGame(replay, &moves);
+      EXPECT_EQ(Problems::kNone, failure.problem);
+      EXPECT_EQ(static_cast<int64_t>(replay.turns.size()), moves);
+    }
+  }
+}
+
+/* 4x4 games take the packed boards, with their own spawn stream and
+ * scores; a changed direction has to fail there just as on GameLogic */
+TEST(ReplayVerifierTest, PackedBoardsAgreeWithGameLogic) {
+  std::mt19937_64 rng(1);
+  for (uint64_t seed = 0; seed < 40; seed++) {
+    SCOPED_TRACE(seed);
+    Replay replay = RecordGame(4, seed);
+    if (seed) {
+      Replay::Turn& turn = replay.turns[rng() % replay.turns.size()];
+      turn.direction = kDirections[(static_cast<int32_t>(turn.direction)
+                                    + 1 + rng() % 3) % 4];
+    }
+    int64_t expected_moves = 0, moves = 0;
+    ReplayVerifier::Failure expected = VerifyOnLogic(replay, &expected_moves);
+    ReplayVerifier::Failure actual = ReplayVerifier::VerifyGame(replay,
+                                                                &moves);
+    EXPECT_EQ(expected.turn, actual.turn);
+    EXPECT_EQ(expected.problem, actual.problem);
+    EXPECT_EQ(expected_moves, moves);
+  }
+}
+
+/* each problem on both the packed and the GameLogic path, reported with
+ * its game and turn in file order */
+TEST(ReplayVerifierTest, ReportsTheGameAndTurnOfEachProblem) {
+  std::vector<Replay> games;
+  std::vector<ReplayVerifier::Failure> expected;
+  games.push_back(RecordGame(4, 10));
+  for (int32_t length : {4, 5}) {
+    Replay replay = RecordGame(length, length);
+    Directions direction = Directions::kNone;
+    int32_t k = FindInvalidMove(replay, &direction);
+    ASSERT_GE(k, 0);
+    replay.turns[k].direction = direction;
+    expected.push_back({games.size(), k, Problems::kInvalidMove});
+    games.push_back(replay);
+  }
+  for (int32_t length : {4, 5}) {
+    Replay replay = RecordGame(length, 20 + length);
+    int32_t k = replay.turns.size() / 2;
+    ChangeSpawn(&replay, k);
+    expected.push_back({games.size(), k, Problems::kSpawnMismatch});
+    games.push_back(replay);
+  }
+  for (int32_t length : {4, 5}) {
+    Replay replay = RecordGame(length, 30 + length);
+    replay.score += 4;
+    expected.push_back({games.size(), -1, Problems::kScoreMismatch});
+    games.push_back(replay);
+  }
+  games.push_back(RecordGame(5, 40));
+
+  /* no rows in the header of the last game */
+  std::vector<char> data = MakeFile(games), record;
+  games.back().Encode(&record);
+  data[data.size() - record.size()
+       + offsetof(replay_format::GameHeader, rows)] = 0;
+  expected.push_back({games.size() - 1, -1, Problems::kMalformed});
+
+  std::string path = ::testing::TempDir() + "2048_verifier_test.rpl";
+  WriteFile(path, data);
+  ReplayFile file(path);
+  ReplayVerifier::Report report = ReplayVerifier::Verify(file, 2);
+  std::remove(path.c_str());
+
+  EXPECT_EQ(static_cast<int64_t>(games.size()), report.games);
+  ASSERT_EQ(expected.size(), report.failures.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    SCOPED_TRACE(i);
+    ExpectFailure(expected[i].game_idx, expected[i].turn,
+                  expected[i].problem, report.failures[i]);
+  }
+  EXPECT_EQ(0, report.problems[static_cast<size_t>(Problems::kNone)]);
+  EXPECT_EQ(1, report.problems[static_cast<size_t>(Problems::kMalformed)]);
+  for (Problems problem : {Problems::kInvalidMove, Problems::kSpawnMismatch,
+                           Problems::kScoreMismatch})
+    EXPECT_EQ(2, report.problems[static_cast<size_t>(problem)]);
+}
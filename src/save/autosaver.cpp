@@ -0,0 +1,171 @@
+#include "save/autosaver.h"
+#include "logic/spawn_rng.h"
+#include "replay/replay.h"
+#include "save/saved_game.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/* the directory of path, so that a rename in it can be synced */
+std::string GetDirectory(const std::string& path) {
+  size_t slash = path.rfind('/');
+  if (slash == std::string::npos)
+    return ".";
+  return slash ? path.substr(0, slash) : "/";
+}
+
+/* takes the turns and keyframes of game from turns on from update, and
+ * everything else */
+void Merge(size_t turns, SavedGame update, SavedGame* game) {
+  std::vector<Replay::Turn> kept_turns = std::move(game->replay.turns);
+  std::vector<Replay::Keyframe> keyframes = std::move(game->replay.keyframes);
+  Replay& replay = update.replay;
+  kept_turns.resize(turns);
+  kept_turns.insert(kept_turns.end(), replay.turns.begin(),
+                    replay.turns.end());
+  keyframes.resize(turns / replay.keyframe_interval);
+  keyframes.insert(keyframes.end(),
+                   std::make_move_iterator(replay.keyframes.begin()),
+                   std::make_move_iterator(replay.keyframes.end()));
+  replay.turns = std::move(kept_turns);
+  replay.keyframes = std::move(keyframes);
+  *game = std::move(update);
+}
+
+}  // namespace
+
+AutoSaver::AutoSaver(const std::string& path)
+    : path_(path)
+    , pending_turns_(0)
+    , known_turns_(0)
+    , has_pending_(false)
+    , busy_(false)
+    , closing_(false)
+    , saver_(&AutoSaver::SaveLoop, this) {}
+
+AutoSaver::~AutoSaver() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closing_ = true;
+  }
+  has_request_.notify_one();
+  saver_.join();
+}
+
+void AutoSaver::Save(const Replay& replay, size_t saved_turns,
+                     std::vector<uint64_t> cells, const SpawnRng& rng,
+                     double seconds) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    /* a pending request not taken yet is replaced, from the first turn
+     * either of them changed */
+    size_t turns = std::min({saved_turns, known_turns_, replay.turns.size()});
+    if (has_pending_)
+      turns = std::min(turns, pending_turns_);
+    std::unique_ptr<SavedGame> game(new SavedGame());
+    Replay& tail = game->replay;
+    tail.seed = replay.seed;
+    tail.rows = replay.rows;
+    tail.columns = replay.columns;
+    tail.rule = replay.rule;
+    tail.spawns = replay.spawns;
+    tail.initial_tiles = replay.initial_tiles;
+    tail.turns.assign(replay.turns.begin() + turns, replay.turns.end());
+    tail.score = replay.score;
+    tail.keyframe_interval = replay.keyframe_interval;
+    tail.keyframes.assign(
+        replay.keyframes.begin() + turns / replay.keyframe_interval,
+        replay.keyframes.end());
+    game->cells = std::move(cells);
+    game->rng = rng;
+    game->seconds = seconds;
+    pending_ = std::move(game);
+    pending_turns_ = turns;
+    known_turns_ = replay.turns.size();
+    has_pending_ = true;
+  }
+  has_request_.notify_one();
+}
+
+void AutoSaver::Clear() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.reset();
+    pending_turns_ = known_turns_ = 0;
+    has_pending_ = true;
+  }
+  has_request_.notify_one();
+}
+
+void AutoSaver::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] { return !has_pending_ && !busy_; });
+}
+
+void AutoSaver::SaveLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    has_request_.wait(lock, [this] { return has_pending_ || closing_; });
+    if (!has_pending_)
+      return;
+    std::unique_ptr<SavedGame> update = std::move(pending_);
+    size_t turns = pending_turns_;
+    has_pending_ = false;
+    busy_ = true;
+    lock.unlock();
+    if (update) {
+      Merge(turns, std::move(*update), &game_);
+      Write(game_);
+    } else {
+      game_ = SavedGame();
+      std::remove(path_.c_str());
+    }
+    lock.lock();
+    busy_ = false;
+    done_.notify_all();
+  }
+}
+
+void AutoSaver::Write(const SavedGame& game) const {
+  std::vector<char> data;
+  game.Encode(&data);
+  std::string temporary = path_ + ".tmp";
+  int fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    return;
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t result = write(fd, data.data() + written,
+                           data.size() - written);
+    if (result <= 0)
+      break;
+    written += result;
+  }
+  bool ok = written == data.size() && !fsync(fd);
+  if (close(fd) || !ok || std::rename(temporary.c_str(), path_.c_str())) {
+    std::remove(temporary.c_str());
+    return;
+  }
+  /* the rename itself is only durable once the directory is synced */
+  int directory = open(GetDirectory(path_).c_str(), O_RDONLY | O_DIRECTORY);
+  if (directory < 0)
+    return;
+  fsync(directory);
+  close(directory);
+}
@@ -0,0 +1,70 @@
+#ifndef _2048_SAVE_AUTOSAVER_H_
+#define _2048_SAVE_AUTOSAVER_H_
+
+#include "logic/spawn_rng.h"
+#include "replay/replay.h"
+#include "save/saved_game.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Keeps the save of a game in progress. Save and Clear only hand the
+ * request to a background thread, which keeps its own copy of the game,
+ * encodes it, writes it to a temporary file, syncs it and renames it over
+ * the save, so a crash leaves either the previous save or the new one.
+ * Save copies only the turns the saver does not have yet, so a long game
+ * does not cost a copy of its record every move. Games saved faster than
+ * the disk takes them are skipped. A save that cannot be written is not an
+ * error, the previous one stays. */
+class AutoSaver {
+ public:
+  explicit AutoSaver(const std::string& path);
+
+  /* writes the last request before returning */
+  ~AutoSaver();
+
+  AutoSaver(const AutoSaver&) = delete;
+  AutoSaver& operator=(const AutoSaver&) = delete;
+
+  /* replay is the whole game; its turns before saved_turns, and their
+   * keyframes, have to be those of the game saved last, which an undo may
+   * have cut short since */
+  void Save(const Replay& replay, size_t saved_turns,
+            std::vector<uint64_t> cells, const SpawnRng& rng,
+            double seconds);
+
+  /* removes the save, e.g. once the game is over */
+  void Clear();
+
+  /* waits until the last request is done */
+  void Flush();
+
+ private:
+  void SaveLoop();
+  void Write(const SavedGame& game) const;
+
+  std::string path_;
+  std::mutex mutex_;
+  std::condition_variable has_request_;
+  std::condition_variable done_;
+  /* the game as of the last request, but for the turns and keyframes of
+   * the saver's own game before pending_turns_; nothing removes the save */
+  std::unique_ptr<SavedGame> pending_;
+  size_t pending_turns_;
+  /* turns of the game once the pending request is done */
+  size_t known_turns_;
+  bool has_pending_;
+  bool busy_;
+  bool closing_;
+  /* owned by the saver thread */
+  SavedGame game_;
+  std::thread saver_;
+};
+
+#endif
@@ -0,0 +1,176 @@
+#include "logic/spawn_distribution.h"
+#include "logic/spawn_rng.h"
+#include "replay/replay.h"
+#include "save/autosaver.h"
+#include "save/saved_game.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr Directions kDirections[] = {Directions::kLeft, Directions::kRight,
+                                      Directions::kUp, Directions::kDown};
+
+/* the saver does not check the moves, any turns on a 4x4 board do */
+Replay MakeReplay(uint64_t seed) {
+  Replay replay;
+  replay.seed = seed;
+  replay.rows = replay.columns = 4;
+  replay.spawns = SpawnDistribution::Standard().GetOutcomes();
+  replay.initial_tiles = {{3, Tiles::kTile_2}, {9, Tiles::kTile_4}};
+  replay.keyframe_interval = 16;
+  return replay;
+}
+
+void AddTurn(std::mt19937_64& rng, Replay* replay) {
+  Tiles tile = rng() % 10 ? Tiles::kTile_2 : Tiles::kTile_4;
+  replay->turns.push_back({kDirections[rng() % 4],
+                           {static_cast<int32_t>(rng() % 16), tile}});
+  replay->score += rng() % 64;
+  if (replay->turns.size() % replay->keyframe_interval == 0)
+    replay->keyframes.push_back({replay->score, {rng()}});
+}
+
+void ExpectSameReplay(const Replay& expected, const Replay& actual) {
+  EXPECT_EQ(expected.seed, actual.seed);
+  EXPECT_EQ(expected.rows, actual.rows);
+  EXPECT_EQ(expected.columns, actual.columns);
+  EXPECT_EQ(expected.score, actual.score);
+  EXPECT_EQ(expected.keyframe_interval, actual.keyframe_interval);
+  EXPECT_EQ(expected.initial_tiles.size(), actual.initial_tiles.size());
+  ASSERT_EQ(expected.turns.size(), actual.turns.size());
+  for (size_t i = 0; i < expected.turns.size(); i++) {
+    EXPECT_EQ(expected.turns[i].direction, actual.turns[i].direction) << i;
+    EXPECT_EQ(expected.turns[i].spawn.cell, actual.turns[i].spawn.cell) << i;
+    EXPECT_EQ(expected.turns[i].spawn.tile, actual.turns[i].spawn.tile) << i;
+  }
+  ASSERT_EQ(expected.keyframes.size(), actual.keyframes.size());
+  for (size_t i = 0; i < expected.keyframes.size(); i++) {
+    EXPECT_EQ(expected.keyframes[i].score, actual.keyframes[i].score) << i;
+    EXPECT_EQ(expected.keyframes[i].cells, actual.keyframes[i].cells) << i;
+  }
+}
+
+std::string GetSavePath() {
+  std::string path = ::testing::TempDir() + "2048_save_test.sav";
+  std::remove(path.c_str());
+  return path;
+}
+
+}  // namespace
+
+TEST(SavedGameTest, EncodesAndDecodes) {
+  std::mt19937_64 rng(1);
+  SavedGame game;
+  game.replay = MakeReplay(7);
+  for (int32_t k = 0; k < 300; k++)
+    AddTurn(rng, &game.replay);
+  game.cells = {0x123456789ABCDEF0ULL};
+  game.rng = SpawnRng(7);
+  for (int32_t k = 0; k < 123; k++)
+    game.rng();
+  game.seconds = 12.5;
+
+  std::vector<char> data;
+  game.Encode(&data);
+  SavedGame decoded = SavedGame::Decode(data.data(), data.size());
+  ExpectSameReplay(game.replay, decoded.replay);
+  EXPECT_EQ(game.cells, decoded.cells);
+  EXPECT_EQ(game.seconds, decoded.seconds);
+  EXPECT_EQ(game.rng.GetSeed(), decoded.rng.GetSeed());
+  EXPECT_EQ(game.rng.GetDraws(), decoded.rng.GetDraws());
+  for (int32_t k = 0; k < 10; k++)
+    EXPECT_EQ(game.rng(), decoded.rng());
+}
+
+TEST(SavedGameTest, RejectsDamagedSaves) {
+  std::mt19937_64 rng(2);
+  SavedGame game;
+  game.replay = MakeReplay(2);
+  for (int32_t k = 0; k < 40; k++)
+    AddTurn(rng, &game.replay);
+  game.cells = {0};
+  std::vector<char> data;
+  game.Encode(&data);
+
+  EXPECT_THROW(SavedGame::Decode(data.data(), data.size() - 1),
+               std::runtime_error);
+  for (size_t i : {sizeof(save_format::Header), data.size() - 1}) {
+    std::vector<char> damaged = data;
+    damaged[i] ^= 1;
+    EXPECT_THROW(SavedGame::Decode(damaged.data(), damaged.size()),
+                 std::runtime_error) << i;
+  }
+  SavedGame loaded;
+  EXPECT_FALSE(SavedGame::Load(GetSavePath(), &loaded));
+}
+
+/* saved the way the engine does: only turns past saved_turns are handed
+ * over, and an undo pulls saved_turns back to the turns left */
+TEST(AutoSaverTest, KeepsTheGameAcrossUndo) {
+  std::string path = GetSavePath();
+  std::mt19937_64 rng(3);
+  Replay replay = MakeReplay(3);
+  {
+    AutoSaver saver(path);
+    size_t saved_turns = 0;
+    for (int32_t k = 0; k < 600; k++) {
+      if (!replay.turns.empty() && rng() % 3 == 0) {
+        replay.turns.pop_back();
+        replay.keyframes.resize(replay.turns.size()
+                                / replay.keyframe_interval);
+        saved_turns = std::min(saved_turns, replay.turns.size());
+      } else {
+        AddTurn(rng, &replay);
+      }
+      saver.Save(replay, saved_turns, {rng()}, SpawnRng(3), k);
+      saved_turns = replay.turns.size();
+      if (k % 50 == 0) {
+        saver.Flush();
+        SavedGame game;
+        ASSERT_TRUE(SavedGame::Load(path, &game)) << k;
+        ExpectSameReplay(replay, game.replay);
+        EXPECT_EQ(k, game.seconds);
+        if (::testing::Test::HasFailure())
+          return;
+      }
+    }
+  }
+  SavedGame game;
+  ASSERT_TRUE(SavedGame::Load(path, &game));
+  ExpectSameReplay(replay, game.replay);
+  std::remove(path.c_str());
+}
+
+/* after a Clear the saver has no turns, whatever saved_turns says */
+TEST(AutoSaverTest, ClearRemovesTheSave) {
+  std::string path = GetSavePath();
+  std::mt19937_64 rng(4);
+  Replay replay = MakeReplay(4);
+  for (int32_t k = 0; k < 20; k++)
+    AddTurn(rng, &replay);
+  AutoSaver saver(path);
+  saver.Save(replay, 0, {0}, SpawnRng(4), 0);
+  saver.Flush();
+  SavedGame game;
+  EXPECT_TRUE(SavedGame::Load(path, &game));
+
+  saver.Clear();
+  saver.Flush();
+  EXPECT_FALSE(SavedGame::Load(path, &game));
+
+  saver.Save(replay, replay.turns.size(), {0}, SpawnRng(4), 0);
+  saver.Flush();
+  ASSERT_TRUE(SavedGame::Load(path, &game));
+  ExpectSameReplay(replay, game.replay);
+  std::remove(path.c_str());
+}
@@ -0,0 +1,108 @@
+#include "save/saved_game.h"
+#include "replay/replay.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace save_format {
+
+uint64_t GetChecksum(const char* data, size_t size) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= static_cast<uint8_t>(data[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+}  // namespace save_format
+
+using namespace save_format;
+
+namespace {
+
+size_t GetPadding(size_t size) {
+  return (8 - size % 8) % 8;
+}
+
+}  // namespace
+
+void SavedGame::Encode(std::vector<char>* out) const {
+  size_t start = out->size();
+  out->resize(start + sizeof(Header));
+  const char* bytes = reinterpret_cast<const char*>(cells.data());
+  out->insert(out->end(), bytes, bytes + cells.size() * sizeof(uint64_t));
+  std::string rng_state = rng.GetState();
+  out->insert(out->end(), rng_state.begin(), rng_state.end());
+  out->resize(out->size() + GetPadding(rng_state.size()));
+  replay.Encode(out);
+
+  Header header = {};
+  std::memcpy(header.magic, kMagic, sizeof(header.magic));
+  header.version = kVersion;
+  header.cell_words = cells.size();
+  header.rng_state_size = rng_state.size();
+  header.rng_draws = rng.GetDraws();
+  header.seconds = seconds;
+  header.size = out->size() - start - sizeof(Header);
+  header.checksum = GetChecksum(out->data() + start + sizeof(Header),
+                                header.size);
+  std::memcpy(out->data() + start, &header, sizeof(header));
+}
+
+SavedGame SavedGame::Decode(const char* data, size_t size) {
+  Header header;
+  if (size < sizeof(header))
+    throw std::runtime_error("save is truncated");
+  std::memcpy(&header, data, sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(header.magic))
+      || header.version != kVersion)
+    throw std::runtime_error("not a save");
+  if (header.size != size - sizeof(header))
+    throw std::runtime_error("save is truncated");
+  data += sizeof(header);
+  if (GetChecksum(data, header.size) != header.checksum)
+    throw std::runtime_error("save checksum mismatch");
+
+  size_t cells_size = header.cell_words * sizeof(uint64_t);
+  size_t state_size = header.rng_state_size;
+  size_t offset = cells_size + state_size + GetPadding(state_size);
+  if (offset > header.size)
+    throw std::runtime_error("save is malformed");
+  SavedGame game;
+  game.seconds = header.seconds;
+  game.cells.resize(header.cell_words);
+  std::memcpy(game.cells.data(), data, cells_size);
+  size_t record_size = header.size - offset;
+  if (replay_format::GetRecordSize(data + offset, record_size)
+      != record_size)
+    throw std::runtime_error("save is malformed");
+  game.replay = Replay::Decode(data + offset, record_size);
+  game.rng.SetState(game.replay.seed, header.rng_draws,
+                    std::string(data + cells_size, state_size));
+  if (game.cells.size() != replay_format::GetCellWords(game.replay.rows,
+                                                       game.replay.columns))
+    throw std::runtime_error("save is malformed");
+  return game;
+}
+
+bool SavedGame::Load(const std::string& path, SavedGame* game) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in)
+    return false;
+  std::vector<char> data(static_cast<size_t>(in.tellg()));
+  in.seekg(0);
+  if (!in.read(data.data(), data.size()))
+    return false;
+  try {
+    *game = Decode(data.data(), data.size());
+  } catch (const std::runtime_error&) {
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,61 @@
+#ifndef _2048_SAVE_SAVED_GAME_H_
+#define _2048_SAVE_SAVED_GAME_H_
+
+#include "logic/spawn_rng.h"
+#include "replay/replay.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* A game to resume: the record of its moves, which is also its undo
+ * history, the board after them and how many numbers the spawn rng has
+ * drawn from the seed of the record. The board and the whole rng state
+ * are kept too, so that resuming neither replays the game nor redraws the
+ * rng. */
+struct SavedGame {
+  void Encode(std::vector<char>* out) const;
+
+  /* throws unless data is a whole save with a matching checksum */
+  static SavedGame Decode(const char* data, size_t size);
+
+  /* false if there is no save at path or it is damaged */
+  static bool Load(const std::string& path, SavedGame* game);
+
+  Replay replay;
+  /* one nibble per cell as in Replay::Keyframe */
+  std::vector<uint64_t> cells;
+  SpawnRng rng;
+  /* time played so far */
+  double seconds = 0;
+};
+
+/* A save file is a Header, the cell words of the board, the rng state
+ * padded to 8 bytes and the record of the game in the replay format. The
+ * checksum covers everything after the header, so a torn or corrupted file
+ * is never resumed. */
+namespace save_format {
+
+constexpr char kMagic[8] = "2048SAV";
+constexpr uint32_t kVersion = 1;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t cell_words;
+  uint32_t rng_state_size;
+  uint32_t reserved;
+  uint64_t rng_draws;
+  double seconds;
+  /* bytes after the header */
+  uint64_t size;
+  uint64_t checksum;
+};
+
+/* 64-bit FNV-1a */
+uint64_t GetChecksum(const char* data, size_t size);
+
+}  // namespace save_format
+
+#endif
@@ -0,0 +1,429 @@
+#include "scores/score_store.h"
+#include "display/display.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr size_t ScoreStore::kTopSize;
+constexpr int32_t ScoreStore::kSubBucketBits;
+constexpr int32_t ScoreStore::kMaxScoreBits;
+constexpr size_t ScoreStore::kBufferRecords;
+
+using namespace score_format;
+
+namespace {
+
+constexpr size_t kSubBuckets = static_cast<size_t>(1)
+    << ScoreStore::kSubBucketBits;
+constexpr size_t kBucketsNumber =
+    (ScoreStore::kMaxScoreBits - ScoreStore::kSubBucketBits + 1)
+    * kSubBuckets;
+
+Record ToRecord(const ScoreStore::Result& result) {
+  Record record = {};
+  record.score = result.score;
+  record.seed = result.seed;
+  record.duration = std::llround(std::max(result.seconds, 0.0) * 1e6);
+  record.moves = result.moves;
+  record.max_tile = static_cast<uint8_t>(result.max_tile);
+  record.flags = result.success ? kSuccess : 0;
+  return record;
+}
+
+ScoreStore::Result ToResult(const Record& record) {
+  ScoreStore::Result result;
+  result.score = record.score;
+  result.moves = record.moves;
+  result.max_tile = static_cast<Tiles>(record.max_tile);
+  result.success = record.flags & kSuccess;
+  result.seconds = record.duration / 1e6;
+  result.seed = record.seed;
+  return result;
+}
+
+bool IsProfileName(const std::string& profile) {
+  if (profile.empty())
+    return false;
+  for (char c : profile)
+    if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_')
+      return false;
+  return true;
+}
+
+}  // namespace
+
+ScoreStore::ScoreStore(const std::string& directory,
+                       const std::string& profile)
+    : log_path_(directory + "/" + profile + ".log")
+    , index_path_(directory + "/" + profile + ".top")
+    , log_fd_(-1)
+    , log_data_(nullptr)
+    , log_size_(0)
+    , records_(0)
+    , index_dirty_(false)
+    , flush_requested_(false)
+    , closing_(false) {
+  if (!IsProfileName(profile))
+    throw std::runtime_error("bad profile name " + profile);
+  log_fd_ = open(log_path_.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+  if (log_fd_ < 0)
+    throw std::runtime_error("cannot open " + log_path_);
+  /* the destructor does not run for a constructor that throws */
+  try {
+    Load();
+  } catch (...) {
+    UnmapLog();
+    close(log_fd_);
+    throw;
+  }
+  flusher_ = std::thread(&ScoreStore::FlushLoop, this);
+}
+
+ScoreStore::~ScoreStore() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closing_ = true;
+  }
+  has_request_.notify_one();
+  flusher_.join();
+  try {
+    Flush();
+  } catch (...) {}
+  UnmapLog();
+  close(log_fd_);
+}
+
+/* reads the log, cutting off a torn record, and the index, folding in
+ * the records it missed */
+void ScoreStore::Load() {
+  struct stat info;
+  if (fstat(log_fd_, &info))
+    throw std::runtime_error("cannot open " + log_path_);
+  buffer_.reserve(kBufferRecords * sizeof(Record));
+  LogHeader header;
+  if (info.st_size == 0) {
+    std::memcpy(header.magic, kLogMagic, sizeof(header.magic));
+    header.version = kVersion;
+    header.record_size = sizeof(Record);
+    const char* bytes = reinterpret_cast<const char*>(&header);
+    buffer_.insert(buffer_.end(), bytes, bytes + sizeof(header));
+  } else if (info.st_size < static_cast<off_t>(sizeof(header))
+             || pread(log_fd_, &header, sizeof(header), 0)
+                != sizeof(header)
+             || std::memcmp(header.magic, kLogMagic, sizeof(header.magic))
+             || header.version != kVersion
+             || header.record_size != sizeof(Record)) {
+    throw std::runtime_error("not a score log: " + log_path_);
+  } else {
+    /* a record cut short by a crash would shift every later one */
+    records_ = (info.st_size - sizeof(header)) / sizeof(Record);
+    off_t whole = sizeof(header) + records_ * sizeof(Record);
+    if (whole != info.st_size && ftruncate(log_fd_, whole))
+      throw std::runtime_error("cannot truncate " + log_path_);
+  }
+  WriteLog();
+  MapLog();
+
+  ResetIndex();
+  uint64_t indexed = 0;
+  if (!ReadIndex(&indexed)) {
+    ResetIndex();
+    indexed = 0;
+  }
+  for (uint64_t idx = indexed; idx < records_; idx++) {
+    Record record;
+    std::memcpy(&record,
+                log_data_ + sizeof(LogHeader) + idx * sizeof(Record),
+                sizeof(record));
+    Fold(ToResult(record));
+    index_dirty_ = true;
+  }
+}
+
+/* a full buffer is written by the flusher thread, not the caller's */
+void ScoreStore::Add(const Result& result) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Record record = ToRecord(result);
+    const char* bytes = reinterpret_cast<const char*>(&record);
+    buffer_.insert(buffer_.end(), bytes, bytes + sizeof(record));
+    records_++;
+    Fold(result);
+    index_dirty_ = true;
+    if (buffer_.size() < kBufferRecords * sizeof(Record))
+      return;
+    flush_requested_ = true;
+  }
+  has_request_.notify_one();
+}
+
+void ScoreStore::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  FlushLocked();
+}
+
+void ScoreStore::RequestFlush() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush_requested_ = true;
+  }
+  has_request_.notify_one();
+}
+
+void ScoreStore::FlushLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    has_request_.wait(lock, [this] { return flush_requested_ || closing_; });
+    if (!flush_requested_)
+      return;
+    flush_requested_ = false;
+    try {
+      FlushLocked();
+    } catch (const std::runtime_error&) {}
+  }
+}
+
+void ScoreStore::FlushLocked() {
+  WriteLog();
+  if (index_dirty_)
+    WriteIndex();
+  index_dirty_ = false;
+}
+
+uint64_t ScoreStore::GetGamesNumber() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return records_;
+}
+
+ScoreStore::Result ScoreStore::GetResult(uint64_t idx) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (idx >= records_)
+    throw std::runtime_error("no result " + std::to_string(idx));
+  size_t offset = sizeof(LogHeader) + idx * sizeof(Record);
+  if (offset + sizeof(Record) > log_size_) {
+    WriteLog();
+    MapLog();
+  }
+  Record record;
+  std::memcpy(&record, log_data_ + offset, sizeof(record));
+  return ToResult(record);
+}
+
+std::vector<ScoreStore::Result> ScoreStore::GetTop(size_t number) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  number = std::min(number, top_.size());
+  return std::vector<Result>(top_.begin(), top_.begin() + number);
+}
+
+int64_t ScoreStore::GetPercentile(double percentile) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!records_)
+    return 0;
+  uint64_t rank = std::max<uint64_t>(static_cast<uint64_t>(
+      std::ceil(percentile / 100 * records_)), 1);
+  rank = std::min(rank, records_);
+  /* the best scores are known exactly */
+  if (records_ - rank < top_.size())
+    return top_[records_ - rank].score;
+  uint64_t count = 0;
+  for (size_t bucket = 0; bucket < histogram_.size(); bucket++) {
+    count += histogram_[bucket];
+    if (count >= rank)
+      return GetBucketScore(bucket);
+  }
+  return best_score_;
+}
+
+double ScoreStore::GetPercentRank(int64_t score) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!records_)
+    return 0;
+  uint64_t lower = 0;
+  size_t end = GetBucket(score);
+  for (size_t bucket = 0; bucket < end; bucket++)
+    lower += histogram_[bucket];
+  return 100.0 * lower / records_;
+}
+
+ScoreStore::Summary ScoreStore::GetSummary() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Summary summary;
+  summary.games = records_;
+  if (records_) {
+    summary.mean_score = static_cast<double>(total_score_) / records_;
+    summary.success_rate = static_cast<double>(successes_) / records_;
+  }
+  summary.best_score = best_score_;
+  summary.moves = total_moves_;
+  summary.seconds = total_seconds_;
+  summary.max_tiles = max_tiles_;
+  return summary;
+}
+
+size_t ScoreStore::GetBucket(int64_t score) {
+  uint64_t value = std::min<uint64_t>(std::max<int64_t>(score, 0),
+                                      (1ULL << kMaxScoreBits) - 1);
+  if (value < kSubBuckets)
+    return value;
+  int32_t shift = 63 - __builtin_clzll(value) - kSubBucketBits;
+  return shift * kSubBuckets + (value >> shift);
+}
+
+int64_t ScoreStore::GetBucketScore(size_t bucket) {
+  if (bucket < 2 * kSubBuckets)
+    return bucket;
+  int32_t shift = bucket / kSubBuckets - 1;
+  return static_cast<int64_t>(bucket % kSubBuckets + kSubBuckets) << shift;
+}
+
+void ScoreStore::Fold(const Result& result) {
+  histogram_[GetBucket(result.score)]++;
+  max_tiles_[std::min<size_t>(static_cast<size_t>(result.max_tile),
+                              kMaxTilesNumber - 1)]++;
+  successes_ += result.success;
+  total_score_ += result.score;
+  best_score_ = std::max(best_score_, result.score);
+  total_moves_ += result.moves;
+  total_seconds_ += result.seconds;
+  if (top_.size() == kTopSize && result.score <= top_.back().score)
+    return;
+  auto position = std::upper_bound(
+      top_.begin(), top_.end(), result,
+      [](const Result& a, const Result& b) { return a.score > b.score; });
+  top_.insert(position, result);
+  if (top_.size() > kTopSize)
+    top_.pop_back();
+}
+
+/* what reached the log leaves the buffer even when a write fails part
+ * way, so the next one goes on from there instead of repeating it */
+void ScoreStore::WriteLog() {
+  size_t written = 0;
+  while (written < buffer_.size()) {
+    ssize_t result = write(log_fd_, buffer_.data() + written,
+                           buffer_.size() - written);
+    if (result <= 0) {
+      buffer_.erase(buffer_.begin(), buffer_.begin() + written);
+      throw std::runtime_error("cannot write " + log_path_);
+    }
+    written += result;
+  }
+  buffer_.clear();
+}
+
+/* written aside and renamed; an index that cannot be written is not an
+ * error, the next open folds the log in again */
+void ScoreStore::WriteIndex() const {
+  IndexHeader header = {};
+  std::memcpy(header.magic, kIndexMagic, sizeof(header.magic));
+  header.version = kVersion;
+  header.top_number = top_.size();
+  header.records = records_;
+  header.buckets_number = histogram_.size();
+  header.successes = successes_;
+  header.total_score = total_score_;
+  header.best_score = best_score_;
+  header.total_moves = total_moves_;
+  header.total_seconds = total_seconds_;
+
+  std::string temporary = index_path_ + ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(max_tiles_.data()),
+              max_tiles_.size() * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(histogram_.data()),
+              histogram_.size() * sizeof(uint64_t));
+    for (const Result& result : top_) {
+      Record record = ToRecord(result);
+      out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    if (!out) {
+      std::remove(temporary.c_str());
+      return;
+    }
+  }
+  if (std::rename(temporary.c_str(), index_path_.c_str()))
+    std::remove(temporary.c_str());
+}
+
+/* false unless the index is intact and covers no more than the log */
+bool ScoreStore::ReadIndex(uint64_t* indexed) {
+  std::ifstream in(index_path_, std::ios::binary);
+  IndexHeader header;
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+      || std::memcmp(header.magic, kIndexMagic, sizeof(header.magic))
+      || header.version != kVersion || header.top_number > kTopSize
+      || header.buckets_number != kBucketsNumber
+      || header.records > records_)
+    return false;
+  max_tiles_.resize(kMaxTilesNumber);
+  histogram_.resize(kBucketsNumber);
+  in.read(reinterpret_cast<char*>(max_tiles_.data()),
+          max_tiles_.size() * sizeof(uint64_t));
+  in.read(reinterpret_cast<char*>(histogram_.data()),
+          histogram_.size() * sizeof(uint64_t));
+  std::vector<Record> records(header.top_number);
+  in.read(reinterpret_cast<char*>(records.data()),
+          records.size() * sizeof(Record));
+  if (!in)
+    return false;
+  top_.clear();
+  for (const Record& record : records)
+    top_.push_back(ToResult(record));
+  successes_ = header.successes;
+  total_score_ = header.total_score;
+  best_score_ = header.best_score;
+  total_moves_ = header.total_moves;
+  total_seconds_ = header.total_seconds;
+  *indexed = header.records;
+  return true;
+}
+
+void ScoreStore::MapLog() {
+  UnmapLog();
+  struct stat info;
+  if (fstat(log_fd_, &info))
+    throw std::runtime_error("cannot map " + log_path_);
+  void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, log_fd_,
+                    0);
+  if (data == MAP_FAILED)
+    throw std::runtime_error("cannot map " + log_path_);
+  log_data_ = static_cast<const char*>(data);
+  log_size_ = info.st_size;
+}
+
+void ScoreStore::UnmapLog() {
+  if (log_data_)
+    munmap(const_cast<char*>(log_data_), log_size_);
+  log_data_ = nullptr;
+  log_size_ = 0;
+}
+
+void ScoreStore::ResetIndex() {
+  top_.clear();
+  histogram_.assign(kBucketsNumber, 0);
+  max_tiles_.assign(kMaxTilesNumber, 0);
+  successes_ = 0;
+  total_score_ = 0;
+  best_score_ = 0;
+  total_moves_ = 0;
+  total_seconds_ = 0;
+}
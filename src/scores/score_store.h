@@ -0,0 +1,175 @@
+#ifndef _2048_SCORES_SCORE_STORE_H_
+#define _2048_SCORES_SCORE_STORE_H_
+
+#include "display/display.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Results of the games of one profile. Every result is appended to a log
+ * of fixed size records, which is mapped for reading, and folded into an
+ * index: the kTopSize best results, a score histogram and totals. The
+ * index is a few dozen kilobytes written aside on Flush, so queries never
+ * touch the log, and opening only folds in the records the index missed,
+ * e.g. after a crash. Results are buffered, so adding one costs a copy;
+ * a full buffer is written to the log on a thread of the store.
+ * Safe to use from several threads, not from several processes. */
+class ScoreStore {
+ public:
+  static constexpr size_t kTopSize = 100;
+  /* histogram buckets are exact below 2^kSubBucketBits and within
+   * 2^-kSubBucketBits of the score above */
+  static constexpr int32_t kSubBucketBits = 7;
+  static constexpr int32_t kMaxScoreBits = 48;
+
+  struct Result {
+    int64_t score = 0;
+    int32_t moves = 0;
+    Tiles max_tile = Tiles::kNoTile;
+    bool success = false;
+    double seconds = 0;
+    uint64_t seed = 0;
+  };
+
+  struct Summary {
+    uint64_t games = 0;
+    double mean_score = 0;
+    int64_t best_score = 0;
+    double success_rate = 0;
+    int64_t moves = 0;
+    double seconds = 0;
+    /* number of games ended with the given max tile, indexed by Tiles */
+    std::vector<uint64_t> max_tiles;
+  };
+
+  /* opens or creates directory/profile.log and directory/profile.top;
+   * profile names are letters, digits, '-' and '_' */
+  ScoreStore(const std::string& directory, const std::string& profile);
+
+  /* flushes */
+  ~ScoreStore();
+
+  ScoreStore(const ScoreStore&) = delete;
+  ScoreStore& operator=(const ScoreStore&) = delete;
+
+  void Add(const Result& result);
+
+  /* writes the buffered results to the log, then the index */
+  void Flush();
+
+  /* hands Flush to a background thread and returns at once, e.g. for the
+   * game thread; a flush that fails there is left to the next one */
+  void RequestFlush();
+
+  uint64_t GetGamesNumber() const;
+
+  /* the n-th result added, read from the mapped log */
+  Result GetResult(uint64_t idx);
+
+  /* best first, ties in the order they were added; at most kTopSize */
+  std::vector<Result> GetTop(size_t number) const;
+
+  /* the nearest rank score of percentile (0, 100], as Tournament computes
+   * it, up to the precision of the histogram; 0 without games */
+  int64_t GetPercentile(double percentile) const;
+
+  /* percentage of the games with a lower score */
+  double GetPercentRank(int64_t score) const;
+
+  Summary GetSummary() const;
+
+  static size_t GetBucket(int64_t score);
+
+  /* the lowest score of the bucket */
+  static int64_t GetBucketScore(size_t bucket);
+
+ private:
+  static constexpr size_t kBufferRecords = 1 << 15;
+
+  void Load();
+  void FlushLoop();
+  void FlushLocked();
+  void Fold(const Result& result);
+  void WriteLog();
+  void WriteIndex() const;
+  bool ReadIndex(uint64_t* indexed);
+  void MapLog();
+  void UnmapLog();
+  void ResetIndex();
+
+  std::string log_path_;
+  std::string index_path_;
+  mutable std::mutex mutex_;
+  int log_fd_;
+  const char* log_data_;
+  size_t log_size_;
+  /* records in the log file, written or not */
+  uint64_t records_;
+  std::vector<char> buffer_;
+  std::vector<Result> top_;
+  std::vector<uint64_t> histogram_;
+  std::vector<uint64_t> max_tiles_;
+  uint64_t successes_;
+  int64_t total_score_;
+  int64_t best_score_;
+  int64_t total_moves_;
+  double total_seconds_;
+  bool index_dirty_;
+  std::condition_variable has_request_;
+  bool flush_requested_;
+  bool closing_;
+  std::thread flusher_;
+};
+
+/* The log is a LogHeader followed by Records. The index is an IndexHeader,
+ * max tile counts, histogram buckets and the top Records, best first; it
+ * covers the first IndexHeader::records records of the log. Both are only
+ * read on a machine with the byte order that wrote them. */
+namespace score_format {
+
+constexpr char kLogMagic[8] = "2048LOG";
+constexpr char kIndexMagic[8] = "2048TOP";
+constexpr uint32_t kVersion = 1;
+constexpr size_t kMaxTilesNumber = 16;
+
+/* Record::flags */
+constexpr uint8_t kSuccess = 1;
+
+struct LogHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t record_size;
+};
+
+struct Record {
+  int64_t score;
+  uint64_t seed;
+  /* microseconds */
+  uint64_t duration;
+  uint32_t moves;
+  uint8_t max_tile;
+  uint8_t flags;
+  uint16_t reserved;
+};
+
+struct IndexHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t top_number;
+  uint64_t records;
+  uint64_t buckets_number;
+  uint64_t successes;
+  int64_t total_score;
+  int64_t best_score;
+  int64_t total_moves;
+  double total_seconds;
+};
+
+}  // namespace score_format
+
+#endif
@@ -0,0 +1,267 @@
+#include "scores/score_store.h"
+#include "display/display.h"
+
+#include <dirent.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string MakeDirectory() {
+  std::string pattern = ::testing::TempDir() + "2048_scores_XXXXXX";
+  std::vector<char> path(pattern.begin(), pattern.end());
+  path.push_back('\0');
+  if (!mkdtemp(path.data()))
+    throw std::runtime_error("cannot make " + pattern);
+  return path.data();
+}
+
+void RemoveDirectory(const std::string& directory) {
+  for (const char* suffix : {".log", ".top", ".top.tmp"})
+    std::remove((directory + "/games" + suffix).c_str());
+  rmdir(directory.c_str());
+}
+
+ScoreStore::Result MakeResult(std::mt19937_64& rng, int64_t max_score) {
+  ScoreStore::Result result;
+  result.score = rng() % max_score;
+  result.moves = rng() % 1000;
+  result.max_tile = static_cast<Tiles>(1 + rng() % 11);
+  result.success = rng() % 2;
+  result.seconds = rng() % 1000 / 8.0;
+  result.seed = rng();
+  return result;
+}
+
+void ExpectSameResult(const ScoreStore::Result& expected,
+                      const ScoreStore::Result& actual) {
+  EXPECT_EQ(expected.score, actual.score);
+  EXPECT_EQ(expected.moves, actual.moves);
+  EXPECT_EQ(expected.max_tile, actual.max_tile);
+  EXPECT_EQ(expected.success, actual.success);
+  EXPECT_EQ(expected.seconds, actual.seconds);
+  EXPECT_EQ(expected.seed, actual.seed);
+}
+
+void ExpectSameStore(const ScoreStore& expected, const ScoreStore& actual) {
+  ScoreStore::Summary a = expected.GetSummary(), b = actual.GetSummary();
+  EXPECT_EQ(a.games, b.games);
+  EXPECT_EQ(a.mean_score, b.mean_score);
+  EXPECT_EQ(a.best_score, b.best_score);
+  EXPECT_EQ(a.success_rate, b.success_rate);
+  EXPECT_EQ(a.moves, b.moves);
+  EXPECT_DOUBLE_EQ(a.seconds, b.seconds);
+  EXPECT_EQ(a.max_tiles, b.max_tiles);
+  std::vector<ScoreStore::Result> top_a = expected.GetTop(ScoreStore::kTopSize);
+  std::vector<ScoreStore::Result> top_b = actual.GetTop(ScoreStore::kTopSize);
+  ASSERT_EQ(top_a.size(), top_b.size());
+  for (size_t i = 0; i < top_a.size(); i++)
+    ExpectSameResult(top_a[i], top_b[i]);
+  for (double percentile : {1.0, 25.0, 50.0, 90.0, 99.9, 100.0})
+    EXPECT_EQ(expected.GetPercentile(percentile),
+              actual.GetPercentile(percentile));
+}
+
+}  // namespace
+
+/* nearest rank on the sorted scores, as Tournament computes it: exact in
+ * the top results and below 2^kSubBucketBits, within a bucket above */
+TEST(ScoreStoreTest, PercentilesFollowTheScores) {
+  for (int64_t max_score : {int64_t(100), int64_t(1) << 20}) {
+    SCOPED_TRACE(max_score);
+    std::string directory = MakeDirectory();
+    ScoreStore store(directory, "games");
+    std::mt19937_64 rng(max_score);
+    std::vector<int64_t> scores;
+    for (int32_t k = 0; k < 5000; k++) {
+      ScoreStore::Result result = MakeResult(rng, max_score);
+      scores.push_back(result.score);
+      store.Add(result);
+    }
+    std::sort(scores.begin(), scores.end());
+    for (double percentile : {0.01, 1.0, 25.0, 50.0, 90.0, 98.5, 100.0}) {
+      SCOPED_TRACE(percentile);
+      size_t rank = std::max<size_t>(
+          std::ceil(percentile / 100 * scores.size()), 1);
+      int64_t expected = scores[rank - 1];
+      int64_t actual = store.GetPercentile(percentile);
+      if (scores.size() - rank < ScoreStore::kTopSize || max_score <= 128) {
+        EXPECT_EQ(expected, actual);
+      } else {
+        EXPECT_LE(actual, expected);
+        EXPECT_GE(actual, expected - (expected >> ScoreStore::kSubBucketBits));
+      }
+    }
+    int64_t median = scores[scores.size() / 2];
+    double below = std::lower_bound(scores.begin(), scores.end(), median)
+        - scores.begin();
+    if (max_score <= 128) {
+      EXPECT_DOUBLE_EQ(100 * below / scores.size(),
+                       store.GetPercentRank(median));
+    }
+    std::vector<ScoreStore::Result> top = store.GetTop(10);
+    ASSERT_EQ(10u, top.size());
+    for (size_t i = 0; i < top.size(); i++)
+      EXPECT_EQ(scores[scores.size() - 1 - i], top[i].score);
+    RemoveDirectory(directory);
+  }
+}
+
+/* an index lost or left behind by a crash is rebuilt from the log */
+TEST(ScoreStoreTest, RebuildsTheIndexFromTheLog) {
+  std::string directory = MakeDirectory();
+  std::string index = directory + "/games.top";
+  std::mt19937_64 rng(1);
+  std::vector<char> old_index;
+  {
+    ScoreStore store(directory, "games");
+    for (int32_t k = 0; k < 300; k++)
+      store.Add(MakeResult(rng, 100000));
+    store.Flush();
+    std::ifstream in(index, std::ios::binary);
+    old_index.assign(std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>());
+    for (int32_t k = 0; k < 300; k++)
+      store.Add(MakeResult(rng, 100000));
+  }
+  /* only read from here on, it has nothing to flush */
+  ScoreStore expected(directory, "games");
+
+  std::remove(index.c_str());
+  {
+    ScoreStore rebuilt(directory, "games");
+    ExpectSameStore(expected, rebuilt);
+  }
+  {
+    std::ofstream out(index, std::ios::binary);
+    out.write(old_index.data(), old_index.size());
+  }
+  {
+    ScoreStore folded(directory, "games");
+    EXPECT_EQ(600u, folded.GetGamesNumber());
+    ExpectSameStore(expected, folded);
+  }
+  {
+    std::ofstream out(index, std::ios::binary);
+    out << "damaged";
+  }
+  ScoreStore damaged(directory, "games");
+  ExpectSameStore(expected, damaged);
+  RemoveDirectory(directory);
+}
+
+/* a record cut short by a crash is dropped, the next one takes its place */
+TEST(ScoreStoreTest, CutsOffATornRecord) {
+  std::string directory = MakeDirectory();
+  std::mt19937_64 rng(2);
+  std::vector<ScoreStore::Result> results;
+  {
+    ScoreStore store(directory, "games");
+    for (int32_t k = 0; k < 10; k++) {
+      results.push_back(MakeResult(rng, 100000));
+      store.Add(results.back());
+    }
+  }
+  {
+    std::ofstream out(directory + "/games.log",
+                      std::ios::binary | std::ios::app);
+    out << "torn";
+  }
+  {
+    ScoreStore store(directory, "games");
+    EXPECT_EQ(10u, store.GetGamesNumber());
+    results.push_back(MakeResult(rng, 100000));
+    store.Add(results.back());
+  }
+  ScoreStore store(directory, "games");
+  ASSERT_EQ(results.size(), store.GetGamesNumber());
+  for (size_t i = 0; i < results.size(); i++)
+    ExpectSameResult(results[i], store.GetResult(i));
+  RemoveDirectory(directory);
+}
+
+TEST(ScoreStoreTest, FlushesInTheBackground) {
+  std::string directory = MakeDirectory();
+  std::mt19937_64 rng(3);
+  ScoreStore store(directory, "games");
+  ScoreStore::Result result = MakeResult(rng, 100000);
+  store.Add(result);
+  store.RequestFlush();
+  for (int32_t k = 0; k < 1000; k++) {
+    std::ifstream in(directory + "/games.top", std::ios::binary);
+    if (in)
+      break;
+    usleep(1000);
+  }
+  ScoreStore reopened(directory, "games");
+  ASSERT_EQ(1u, reopened.GetGamesNumber());
+  ExpectSameResult(result, reopened.GetResult(0));
+  RemoveDirectory(directory);
+}
+
+/* a log that cannot be written fails the constructor without keeping the
+ * file open */
+TEST(ScoreStoreTest, ClosesTheLogWhenOpeningFails) {
+  std::string directory = MakeDirectory();
+  ASSERT_EQ(0, symlink("/dev/full", (directory + "/full.log").c_str()));
+  auto count_files = [] {
+    int32_t files = 0;
+    DIR* fds = opendir("/proc/self/fd");
+    while (readdir(fds))
+      files++;
+    closedir(fds);
+    return files;
+  };
+  int32_t files = count_files();
+  for (int32_t k = 0; k < 10; k++)
+    EXPECT_THROW(ScoreStore(directory, "full"), std::runtime_error);
+  EXPECT_EQ(files, count_files());
+  std::remove((directory + "/full.log").c_str());
+  RemoveDirectory(directory);
+}
+
+/* a file size limit inside the fourth record stops the first flush part
+ * way; the next one has to go on from there, neither repeating the
+ * records written nor shifting the ones after */
+TEST(ScoreStoreTest, GoesOnAfterAPartialLogWrite) {
+  std::string directory = MakeDirectory();
+  std::mt19937_64 rng(4);
+  std::vector<ScoreStore::Result> results;
+  {
+    ScoreStore store(directory, "games");
+    for (int32_t k = 0; k < 10; k++) {
+      results.push_back(MakeResult(rng, 100000));
+      store.Add(results.back());
+    }
+    rlimit unlimited, limited;
+    ASSERT_EQ(0, getrlimit(RLIMIT_FSIZE, &unlimited));
+    limited = unlimited;
+    limited.rlim_cur = sizeof(score_format::LogHeader)
+        + 3 * sizeof(score_format::Record) + 5;
+    auto handler = std::signal(SIGXFSZ, SIG_IGN);
+    ASSERT_EQ(0, setrlimit(RLIMIT_FSIZE, &limited));
+    EXPECT_THROW(store.Flush(), std::runtime_error);
+    ASSERT_EQ(0, setrlimit(RLIMIT_FSIZE, &unlimited));
+    std::signal(SIGXFSZ, handler);
+    store.Flush();
+  }
+  ScoreStore reopened(directory, "games");
+  ASSERT_EQ(results.size(), reopened.GetGamesNumber());
+  for (size_t i = 0; i < results.size(); i++)
+    ExpectSameResult(results[i], reopened.GetResult(i));
+  RemoveDirectory(directory);
+}
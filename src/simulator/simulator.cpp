@@ -0,0 +1,123 @@
+#include "simulator/simulator.h"
+#include "ai/board.h"
+#include "ai/strategy.h"
+#include "logic/logic.h"
+#include "logic/spawn_distribution.h"
+#include "replay/replay.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+Board Simulator::NewTile(Board board, const SpawnDistribution& spawns,
+                         std::mt19937_64& rng) {
+  int32_t free = board.CountEmpty();
+  if (!free)
+    return board;
+  int32_t cell = board.GetEmptyCell(rng() % free);
+  board.SetTile(cell / Board::kLength, cell % Board::kLength,
+                spawns.Sample(rng));
+  return board;
+}
+
+Replay::Spawn Simulator::GetSpawn(Board before, Board after) {
+  uint64_t changed = before.GetCells() ^ after.GetCells();
+  if (!changed)
+    return {-1, Tiles::kNoTile};
+  int32_t cell = __builtin_ctzll(changed) / 4;
+  return {cell, after.GetTile(cell / Board::kLength, cell % Board::kLength)};
+}
+
+Simulator::GameResult Simulator::PlayGame(uint64_t seed) const {
+  std::unique_ptr<Strategy> strategy = factory_();
+  return PlayGame(seed, *strategy, spawns_);
+}
+
+Simulator::GameResult Simulator::PlayGame(uint64_t seed, Strategy& strategy,
+                                          const SpawnDistribution& spawns,
+                                          Replay* replay) {
+  auto start = std::chrono::steady_clock::now();
+  strategy.Reset(seed);
+  std::mt19937_64 rng(seed);
+  if (replay) {
+    *replay = Replay();
+    replay->seed = seed;
+    replay->rows = replay->columns = Board::kLength;
+    replay->spawns = spawns.GetOutcomes();
+  }
+  Board board;
+  for (size_t i = 0; i < Logic::kInitialTilesNumber; i++) {
+    Board before = board;
+    board = NewTile(board, spawns, rng);
+    if (replay)
+      replay->initial_tiles.push_back(GetSpawn(before, board));
+  }
+
+  GameResult result;
+  while (true) {
+    Directions move = strategy.ChooseMove(board);
+    if (move == Directions::kNone)
+      break;
+    int32_t score = 0;
+    board = board.Move(move, &score);
+    result.score += score;
+    result.moves++;
+    if (replay)
+      replay->turns.push_back({move, {-1, Tiles::kNoTile}});
+    if (board.GetMaxTile() == Tiles::kTile_2048) {
+      result.success = true;
+      break;
+    }
+    Board before = board;
+    board = NewTile(board, spawns, rng);
+    if (replay)
+      replay->turns.back().spawn = GetSpawn(before, board);
+  }
+  if (replay)
+    replay->score = result.score;
+  result.max_tile = board.GetMaxTile();
+  result.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  return result;
+}
+
+Simulator::BatchResult Simulator::PlayBatch(const std::vector<uint64_t>& seeds,
+                                            int32_t threads_number) const {
+  if (threads_number <= 0)
+    threads_number = std::max(1U, std::thread::hardware_concurrency());
+  threads_number = std::min<int32_t>(threads_number, seeds.size());
+
+  BatchResult batch;
+  batch.games.resize(seeds.size());
+  auto start = std::chrono::steady_clock::now();
+  std::atomic<size_t> next_game(0);
+  auto worker = [this, &seeds, &batch, &next_game] {
+    std::unique_ptr<Strategy> strategy = factory_();
+    for (size_t i = next_game++; i < seeds.size(); i = next_game++)
+      batch.games[i] = PlayGame(seeds[i], *strategy, spawns_);
+  };
+  std::vector<std::thread> threads;
+  for (int32_t i = 1; i < threads_number; i++)
+    threads.emplace_back(worker);
+  if (threads_number > 0)
+    worker();
+  for (auto& thread : threads)
+    thread.join();
+  batch.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+  for (const auto& game : batch.games) {
+    batch.mean_score += game.score;
+    batch.success_rate += game.success;
+  }
+  if (!batch.games.empty()) {
+    batch.mean_score /= batch.games.size();
+    batch.success_rate /= batch.games.size();
+  }
+  return batch;
+}
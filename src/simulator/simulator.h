@@ -0,0 +1,70 @@
+#ifndef _2048_SIMULATOR_SIMULATOR_H_
+#define _2048_SIMULATOR_SIMULATOR_H_
+
+#include "ai/board.h"
+#include "ai/heuristic.h"
+#include "ai/search.h"
+#include "ai/strategy.h"
+#include "display/display.h"
+#include "logic/spawn_distribution.h"
+#include "replay/replay.h"
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+/* Plays whole games on packed boards with the same rules as Logic: spawns
+ * are drawn from a per-game RNG seeded by the caller, so equal seeds give
+ * equal spawn streams to every player (common random numbers). */
+class Simulator {
+ public:
+  struct GameResult {
+    int64_t score = 0;
+    int32_t moves = 0;
+    Tiles max_tile = Tiles::kNoTile;
+    bool success = false;
+    double seconds = 0;
+  };
+
+  struct BatchResult {
+    std::vector<GameResult> games;
+    double mean_score = 0;
+    double success_rate = 0;
+    double seconds = 0;
+  };
+
+  explicit Simulator(StrategyFactory factory,
+                     const SpawnDistribution& spawns = SpawnDistribution())
+      : factory_(std::move(factory))
+      , spawns_(spawns) {}
+
+  /* the search plays the game with the spawns it expects */
+  Simulator(const Heuristic::Weights& weights, const Search::Options& options)
+      : Simulator(GetStrategyFactory("expectimax", weights, options),
+                  options.spawns) {}
+
+  GameResult PlayGame(uint64_t seed) const;
+
+  /* replay, if given, receives the record of the game */
+  static GameResult PlayGame(uint64_t seed, Strategy& strategy,
+                             const SpawnDistribution& spawns,
+                             Replay* replay = nullptr);
+
+  /* games are distributed over threads_number worker threads,
+   * zero means one per hardware thread */
+  BatchResult PlayBatch(const std::vector<uint64_t>& seeds,
+                        int32_t threads_number = 0) const;
+
+  static Board NewTile(Board board, const SpawnDistribution& spawns,
+                       std::mt19937_64& rng);
+
+  /* the tile NewTile placed on before to make after */
+  static Replay::Spawn GetSpawn(Board before, Board after);
+
+ private:
+  StrategyFactory factory_;
+  SpawnDistribution spawns_;
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include "simulator/simulator.h"
+#include "ai/board.h"
+#include "ai/heuristic.h"
+#include "ai/search.h"
+#include "ai/strategy.h"
+#include "display/display.h"
+#include "logic/spawn_distribution.h"
+#include "replay/replay.h"
+#include "replay/verifier.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+void ExpectSameGame(const Simulator::GameResult& expected,
+                    const Simulator::GameResult& actual) {
+  EXPECT_EQ(expected.score, actual.score);
+  EXPECT_EQ(expected.moves, actual.moves);
+  EXPECT_EQ(expected.max_tile, actual.max_tile);
+  EXPECT_EQ(expected.success, actual.success);
+}
+
+}  // namespace
+
+TEST(SimulatorTest, NewTileFillsAFreeCell) {
+  SpawnDistribution spawns = SpawnDistribution::Standard();
+  std::mt19937_64 rng(1);
+  Board board;
+  for (int32_t free = Board::kLength * Board::kLength; free > 0; free--) {
+    Board after = Simulator::NewTile(board, spawns, rng);
+    EXPECT_EQ(free - 1, after.CountEmpty());
+    Replay::Spawn spawn = Simulator::GetSpawn(board, after);
+    ASSERT_GE(spawn.cell, 0);
+    EXPECT_EQ(Tiles::kNoTile, board.GetTile(spawn.cell / Board::kLength,
+                                            spawn.cell % Board::kLength));
+    EXPECT_TRUE(spawn.tile == Tiles::kTile_2 || spawn.tile == Tiles::kTile_4);
+    board = after;
+  }
+  EXPECT_EQ(board.GetCells(), Simulator::NewTile(board, spawns, rng)
+                                  .GetCells());
+  EXPECT_EQ(-1, Simulator::GetSpawn(board, board).cell);
+}
+
+/* a game depends on its seed only, not on the thread that plays it */
+TEST(SimulatorTest, BatchesDoNotDependOnThreads) {
+  Simulator simulator(GetStrategyFactory("greedy", Heuristic::Weights(),
+                                         Search::Options()),
+                      SpawnDistribution::Standard());
+  std::vector<uint64_t> seeds;
+  for (uint64_t seed = 1; seed <= 16; seed++)
+    seeds.push_back(seed);
+  Simulator::BatchResult single = simulator.PlayBatch(seeds, 1);
+  Simulator::BatchResult parallel = simulator.PlayBatch(seeds, 4);
+  ASSERT_EQ(seeds.size(), single.games.size());
+  ASSERT_EQ(seeds.size(), parallel.games.size());
+  double mean_score = 0;
+  for (size_t i = 0; i < seeds.size(); i++) {
+    SCOPED_TRACE(seeds[i]);
+    ExpectSameGame(single.games[i], parallel.games[i]);
+    ExpectSameGame(simulator.PlayGame(seeds[i]), single.games[i]);
+    EXPECT_GT(single.games[i].moves, 0);
+    mean_score += single.games[i].score;
+  }
+  EXPECT_DOUBLE_EQ(mean_score / seeds.size(), single.mean_score);
+  EXPECT_DOUBLE_EQ(single.mean_score, parallel.mean_score);
+  EXPECT_EQ(single.success_rate, parallel.success_rate);
+  EXPECT_TRUE(simulator.PlayBatch({}, 4).games.empty());
+}
+
+/* the packed boards play by the rules the replays are checked against */
+TEST(SimulatorTest, RecordsReplaysTheVerifierAccepts) {
+  for (SpawnDistribution spawns : {SpawnDistribution(),
+                                   SpawnDistribution::Standard()}) {
+    for (uint64_t seed = 0; seed < 10; seed++) {
+      SCOPED_TRACE(seed);
+      std::unique_ptr<Strategy> strategy = GetStrategyFactory(
+          seed % 2 ? "corner" : "random", Heuristic::Weights(),
+          Search::Options())();
+      Replay replay;
+      Simulator::GameResult result = Simulator::PlayGame(seed, *strategy,
+                                                         spawns, &replay);
+      EXPECT_EQ(result.score, replay.score);
+      EXPECT_EQ(result.moves, static_cast<int32_t>(replay.turns.size()));
+      int64_t moves = 0;
+      EXPECT_EQ(ReplayVerifier::Problems::kNone,
+                ReplayVerifier::VerifyGame(replay, &moves).problem);
+      EXPECT_EQ(result.moves, moves);
+    }
+  }
+}
@@ -0,0 +1,333 @@
+#include "solver/solver.h"
+#include "ai/row_tables.h"
+#include "logic/logic.h"
+#include "parallel/parallel.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr char kMagic[8] = {'2', '0', '4', '8', 'S', 'L', 'V', '\0'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kChunkSize = 1 << 12;
+constexpr Directions kMoves[] = {
+  Directions::kLeft, Directions::kRight, Directions::kUp, Directions::kDown,
+};
+
+int32_t Shift(int32_t row, int32_t column) {
+  return 4 * (Solver::kLength * row + column);
+}
+
+}  // namespace
+
+struct SolverTable::Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t length;
+  uint32_t goal;
+  uint32_t layers_number;
+  uint64_t positions_number;
+};
+
+Tiles Solver::GetTile(uint64_t position, int32_t row, int32_t column) {
+  return static_cast<Tiles>((position >> Shift(row, column)) & 0xF);
+}
+
+uint64_t Solver::SetTile(uint64_t position, int32_t row, int32_t column,
+                         Tiles tile) {
+  int32_t shift = Shift(row, column);
+  return (position & ~(0xFULL << shift))
+      | (static_cast<uint64_t>(tile) << shift);
+}
+
+int32_t Solver::GetSum(uint64_t position) {
+  int32_t sum = 0;
+  for (; position; position >>= 4)
+    if (position & 0xF)
+      sum += 1 << ((position & 0xF) - 1);
+  return sum;
+}
+
+uint64_t Solver::Move(uint64_t position, Directions direction) {
+  const RowTables& tables = RowTables::Get(kLength);
+  bool is_row = direction == Directions::kLeft
+      || direction == Directions::kRight;
+  bool is_left = direction == Directions::kLeft
+      || direction == Directions::kUp;
+  uint64_t moved = 0;
+  for (int32_t i = 0; i < kLength; i++) {
+    uint16_t line = 0;
+    for (int32_t j = 0; j < kLength; j++)
+      line |= ((position >> (is_row ? Shift(i, j) : Shift(j, i))) & 0xF)
+          << (4 * j);
+    line = is_left ? tables.MoveLeft(line) : tables.MoveRight(line);
+    for (int32_t j = 0; j < kLength; j++)
+      moved |= static_cast<uint64_t>((line >> (4 * j)) & 0xF)
+          << (is_row ? Shift(i, j) : Shift(j, i));
+  }
+  return moved;
+}
+
+Solver::Solver(const Options& options)
+    : options_(options) {}
+
+bool Solver::IsWin(uint64_t position) const {
+  for (; position; position >>= 4)
+    if ((position & 0xF) >= static_cast<uint64_t>(options_.goal))
+      return true;
+  return false;
+}
+
+void Solver::Expand(const Layer& layer, Layer& next) const {
+  int32_t threads_number = GetThreadsNumber(options_.threads);
+  std::vector<std::vector<uint64_t>> children(threads_number);
+  ParallelFor(layer.positions.size(), kChunkSize, threads_number,
+              [this, &layer, &children](size_t begin, size_t end,
+                                        int32_t thread_idx) {
+    std::vector<uint64_t>& output = children[thread_idx];
+    for (size_t k = begin; k < end; k++) {
+      uint64_t position = layer.positions[k];
+      for (Directions direction : kMoves) {
+        uint64_t moved = Move(position, direction);
+        if (moved == position || IsWin(moved))
+          continue;
+        for (int32_t i = 0; i < kLength; i++)
+          for (int32_t j = 0; j < kLength; j++)
+            if (GetTile(moved, i, j) == Tiles::kNoTile)
+              output.push_back(SetTile(moved, i, j, Logic::kInitialTile));
+      }
+      /* keep the buffers small, duplicates are common */
+      if (output.size() > (1 << 22)) {
+        std::sort(output.begin(), output.end());
+        output.erase(std::unique(output.begin(), output.end()), output.end());
+      }
+    }
+  });
+
+  next.sum = layer.sum + 2;
+  next.positions.clear();
+  for (auto& output : children) {
+    next.positions.insert(next.positions.end(), output.begin(), output.end());
+    std::vector<uint64_t>().swap(output);
+  }
+  std::sort(next.positions.begin(), next.positions.end());
+  next.positions.erase(
+      std::unique(next.positions.begin(), next.positions.end()),
+      next.positions.end());
+}
+
+float Solver::GetMoveValue(uint64_t moved, const Layer* next) const {
+  if (IsWin(moved))
+    return 1;
+  if (!next)
+    throw std::runtime_error("solver layer is missing");
+  float sum = 0;
+  int32_t count = 0;
+  for (int32_t i = 0; i < kLength; i++) {
+    for (int32_t j = 0; j < kLength; j++) {
+      if (GetTile(moved, i, j) != Tiles::kNoTile)
+        continue;
+      uint64_t child = SetTile(moved, i, j, Logic::kInitialTile);
+      auto it = std::lower_bound(next->positions.begin(),
+                                 next->positions.end(), child);
+      if (it == next->positions.end() || *it != child)
+        throw std::runtime_error("solver position is missing");
+      sum += next->values[it - next->positions.begin()];
+      count++;
+    }
+  }
+  return sum / count;
+}
+
+void Solver::Evaluate(Layer& layer, const Layer* next) const {
+  layer.values.assign(layer.positions.size(), 0);
+  ParallelFor(layer.positions.size(), kChunkSize, options_.threads,
+              [this, &layer, next](size_t begin, size_t end, int32_t) {
+    for (size_t k = begin; k < end; k++) {
+      uint64_t position = layer.positions[k];
+      float best = 0;
+      for (Directions direction : kMoves) {
+        uint64_t moved = Move(position, direction);
+        if (moved != position)
+          best = std::max(best, GetMoveValue(moved, next));
+      }
+      layer.values[k] = best;
+    }
+  });
+}
+
+void Solver::Solve() {
+  layers_.clear();
+  Layer first;
+  for (int32_t a = 0; a < kLength * kLength; a++) {
+    for (int32_t b = a + 1; b < kLength * kLength; b++) {
+      uint64_t position = 0;
+      position = SetTile(position, a / kLength, a % kLength,
+                         Logic::kInitialTile);
+      position = SetTile(position, b / kLength, b % kLength,
+                         Logic::kInitialTile);
+      first.positions.push_back(position);
+    }
+  }
+  std::sort(first.positions.begin(), first.positions.end());
+  first.sum = GetSum(first.positions.front());
+  layers_.push_back(std::move(first));
+
+  while (true) {
+    Layer next;
+    Expand(layers_.back(), next);
+    if (next.positions.empty())
+      break;
+    layers_.push_back(std::move(next));
+  }
+  for (size_t k = layers_.size(); k-- > 0;)
+    Evaluate(layers_[k], k + 1 < layers_.size() ? &layers_[k + 1] : nullptr);
+}
+
+int64_t Solver::GetPositionsNumber() const {
+  int64_t number = 0;
+  for (const auto& layer : layers_)
+    number += layer.positions.size();
+  return number;
+}
+
+const Solver::Layer* Solver::FindLayer(int32_t sum) const {
+  if (layers_.empty() || sum < layers_.front().sum
+      || (sum - layers_.front().sum) % 2)
+    return nullptr;
+  size_t idx = (sum - layers_.front().sum) / 2;
+  return idx < layers_.size() ? &layers_[idx] : nullptr;
+}
+
+float Solver::GetValue(uint64_t position) const {
+  const Layer* layer = FindLayer(GetSum(position));
+  if (layer) {
+    auto it = std::lower_bound(layer->positions.begin(),
+                               layer->positions.end(), position);
+    if (it != layer->positions.end() && *it == position)
+      return layer->values[it - layer->positions.begin()];
+  }
+  throw std::runtime_error("position is not reachable");
+}
+
+Directions Solver::GetBestMove(uint64_t position, float* value) const {
+  Directions best_move = Directions::kNone;
+  float best = -1;
+  const Layer* next = FindLayer(GetSum(position) + 2);
+  for (Directions direction : kMoves) {
+    uint64_t moved = Move(position, direction);
+    if (moved == position)
+      continue;
+    float move_value = GetMoveValue(moved, next);
+    if (move_value > best) {
+      best = move_value;
+      best_move = direction;
+    }
+  }
+  if (value)
+    *value = std::max(best, 0.0f);
+  return best_move;
+}
+
+void Solver::Write(const std::string& path) const {
+  SolverTable::Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.length = kLength;
+  header.goal = static_cast<uint32_t>(options_.goal);
+  header.layers_number = layers_.size();
+  header.positions_number = GetPositionsNumber();
+
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  uint64_t offset = 0;
+  for (const auto& layer : layers_) {
+    out.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+    offset += layer.positions.size();
+  }
+  out.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+  for (const auto& layer : layers_)
+    out.write(reinterpret_cast<const char*>(layer.positions.data()),
+              layer.positions.size() * sizeof(uint64_t));
+  for (const auto& layer : layers_)
+    out.write(reinterpret_cast<const char*>(layer.values.data()),
+              layer.values.size() * sizeof(float));
+  for (const auto& layer : layers_)
+    out.write(reinterpret_cast<const char*>(&layer.sum), sizeof(layer.sum));
+  if (!out)
+    throw std::runtime_error("cannot write solver table " + path);
+}
+
+SolverTable::SolverTable(const std::string& path)
+    : data_(nullptr)
+    , size_(0) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("cannot open solver table " + path);
+  struct stat info;
+  if (fstat(fd, &info) || info.st_size < static_cast<off_t>(sizeof(Header))) {
+    close(fd);
+    throw std::runtime_error("solver table is truncated: " + path);
+  }
+  size_ = info.st_size;
+  data_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data_ == MAP_FAILED)
+    throw std::runtime_error("cannot map solver table " + path);
+
+  const char* bytes = static_cast<const char*>(data_);
+  header_ = reinterpret_cast<const Header*>(bytes);
+  size_t layers = header_->layers_number;
+  size_t positions = header_->positions_number;
+  size_t expected = sizeof(Header) + (layers + 1) * sizeof(uint64_t)
+      + positions * (sizeof(uint64_t) + sizeof(float))
+      + layers * sizeof(int32_t);
+  if (std::memcmp(header_->magic, kMagic, sizeof(kMagic))
+      || header_->version != kVersion
+      || header_->length != Solver::kLength || size_ != expected || !layers) {
+    munmap(data_, size_);
+    throw std::runtime_error("bad solver table " + path);
+  }
+  offsets_ = reinterpret_cast<const uint64_t*>(bytes + sizeof(Header));
+  positions_ = offsets_ + layers + 1;
+  values_ = reinterpret_cast<const float*>(positions_ + positions);
+  sums_ = reinterpret_cast<const int32_t*>(values_ + positions);
+}
+
+SolverTable::~SolverTable() {
+  munmap(data_, size_);
+}
+
+Tiles SolverTable::GetGoal() const {
+  return static_cast<Tiles>(header_->goal);
+}
+
+int64_t SolverTable::GetPositionsNumber() const {
+  return header_->positions_number;
+}
+
+float SolverTable::GetValue(uint64_t position) const {
+  int32_t sum = Solver::GetSum(position);
+  if (sum < sums_[0] || (sum - sums_[0]) % 2)
+    return -1;
+  size_t idx = (sum - sums_[0]) / 2;
+  if (idx >= header_->layers_number)
+    return -1;
+  const uint64_t* begin = positions_ + offsets_[idx];
+  const uint64_t* end = positions_ + offsets_[idx + 1];
+  const uint64_t* it = std::lower_bound(begin, end, position);
+  if (it == end || *it != position)
+    return -1;
+  return values_[it - positions_];
+}
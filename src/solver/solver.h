@@ -0,0 +1,105 @@
+#ifndef _2048_SOLVER_SOLVER_H_
+#define _2048_SOLVER_SOLVER_H_
+
+#include "logic/logic.h"
+#include "display/display.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Exact solver for the 3x3 game. A position is packed into the low 36 bits
+ * of a 64-bit word (nibble 3 * row + column holds a Tiles value) and is
+ * the board the player has to move on. Every turn adds a 2 to the board,
+ * so positions fall into layers by tile sum and the value of a layer only
+ * depends on the next one: the solver enumerates layers forward, then
+ * computes win probabilities under optimal play backward, each layer in
+ * parallel. */
+class Solver {
+ public:
+  static constexpr int32_t kLength = 3;
+  /* with every spawn a 2 the nine cells top out at the tiles 2..512, so
+   * 1024 and 2048 are never reached on this board */
+  static constexpr Tiles kDefaultGoal = Tiles::kTile_512;
+
+  struct Options {
+    Tiles goal = kDefaultGoal;
+    int32_t threads = 0;
+  };
+
+  /* positions are sorted, values[i] belongs to positions[i] */
+  struct Layer {
+    int32_t sum;
+    std::vector<uint64_t> positions;
+    std::vector<float> values;
+  };
+
+  explicit Solver(const Options& options);
+
+  void Solve();
+
+  const std::vector<Layer>& GetLayers() const {
+    return layers_;
+  }
+
+  int64_t GetPositionsNumber() const;
+
+  /* win probability of the position with the player to move,
+   * throws if the position is unreachable */
+  float GetValue(uint64_t position) const;
+
+  /* best move and its value, kNone if there is no move */
+  Directions GetBestMove(uint64_t position, float* value = nullptr) const;
+
+  void Write(const std::string& path) const;
+
+  static uint64_t Move(uint64_t position, Directions direction);
+  static Tiles GetTile(uint64_t position, int32_t row, int32_t column);
+  static uint64_t SetTile(uint64_t position, int32_t row, int32_t column,
+                          Tiles tile);
+  static int32_t GetSum(uint64_t position);
+
+ private:
+  void Expand(const Layer& layer, Layer& next) const;
+  void Evaluate(Layer& layer, const Layer* next) const;
+  float GetMoveValue(uint64_t moved, const Layer* next) const;
+  bool IsWin(uint64_t position) const;
+  const Layer* FindLayer(int32_t sum) const;
+
+  Options options_;
+  std::vector<Layer> layers_;
+};
+
+/* Read-only view of a table written by Solver::Write, mapped into memory.
+ * The file keeps the sorted positions of every layer next to their values,
+ * a lookup finds the layer by tile sum and the position by binary search. */
+class SolverTable {
+ public:
+  explicit SolverTable(const std::string& path);
+  ~SolverTable();
+
+  SolverTable(const SolverTable&) = delete;
+  SolverTable& operator=(const SolverTable&) = delete;
+
+  Tiles GetGoal() const;
+
+  int64_t GetPositionsNumber() const;
+
+  /* negative if the position is not in the table */
+  float GetValue(uint64_t position) const;
+
+ private:
+  friend class Solver;
+
+  struct Header;
+
+  const Header* header_;
+  const int32_t* sums_;
+  const uint64_t* offsets_;
+  const uint64_t* positions_;
+  const float* values_;
+  void* data_;
+  size_t size_;
+};
+
+#endif
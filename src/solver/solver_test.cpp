@@ -0,0 +1,152 @@
+#include "solver/solver.h"
+#include "display/display.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+
+namespace {
+
+constexpr int32_t kLength = Solver::kLength;
+
+/* tile exponents, 0 for an empty cell, row by row */
+using Cells = std::array<int32_t, kLength * kLength>;
+
+/* slides and merges the cells towards the start of every line, with the
+ * lines along the rows or the columns and read forwards or backwards */
+Cells MoveCells(const Cells& cells, Directions direction) {
+  bool is_row = direction == Directions::kLeft
+      || direction == Directions::kRight;
+  bool is_forward = direction == Directions::kLeft
+      || direction == Directions::kUp;
+  Cells moved = {};
+  for (int32_t i = 0; i < kLength; i++) {
+    auto index = [i, is_row, is_forward](int32_t j) {
+      int32_t k = is_forward ? j : kLength - 1 - j;
+      return is_row ? kLength * i + k : kLength * k + i;
+    };
+    int32_t out = 0, pending = 0;
+    for (int32_t j = 0; j < kLength; j++) {
+      int32_t tile = cells[index(j)];
+      if (!tile)
+        continue;
+      if (tile == pending) {
+        moved[index(out++)] = tile + 1;
+        pending = 0;
+      } else {
+        if (pending)
+          moved[index(out++)] = pending;
+        pending = tile;
+      }
+    }
+    if (pending)
+      moved[index(out)] = pending;
+  }
+  return moved;
+}
+
+/* plain expectimax over every move and every place of the next 2, with
+ * the positions already seen remembered */
+class BruteForce {
+ public:
+  explicit BruteForce(Tiles goal) : goal_(static_cast<int32_t>(goal)) {}
+
+  double GetValue(const Cells& cells) {
+    auto it = values_.find(cells);
+    if (it != values_.end())
+      return it->second;
+    double best = 0;
+    for (Directions direction : {Directions::kLeft, Directions::kRight,
+                                 Directions::kUp, Directions::kDown}) {
+      Cells moved = MoveCells(cells, direction);
+      if (moved != cells)
+        best = std::max(best, GetMoveValue(moved));
+    }
+    values_[cells] = best;
+    return best;
+  }
+
+ private:
+  double GetMoveValue(const Cells& moved) {
+    if (*std::max_element(moved.begin(), moved.end()) >= goal_)
+      return 1;
+    double sum = 0;
+    int32_t count = 0;
+    for (size_t k = 0; k < moved.size(); k++) {
+      if (moved[k])
+        continue;
+      Cells child = moved;
+      child[k] = static_cast<int32_t>(Tiles::kTile_2);
+      sum += GetValue(child);
+      count++;
+    }
+    return sum / count;
+  }
+
+  int32_t goal_;
+  std::map<Cells, double> values_;
+};
+
+Cells ToCells(uint64_t position) {
+  Cells cells;
+  for (int32_t k = 0; k < kLength * kLength; k++)
+    cells[k] = static_cast<int32_t>(
+        Solver::GetTile(position, k / kLength, k % kLength));
+  return cells;
+}
+
+}  // namespace
+
+TEST(SolverTest, MovesLikeThePlainRules) {
+  uint64_t position = 0;
+  int32_t tiles[] = {1, 1, 2, 0, 2, 2, 3, 3, 3};
+  for (int32_t k = 0; k < kLength * kLength; k++)
+    position = Solver::SetTile(position, k / kLength, k % kLength,
+                               static_cast<Tiles>(tiles[k]));
+  for (Directions direction : {Directions::kLeft, Directions::kRight,
+                               Directions::kUp, Directions::kDown})
+    EXPECT_EQ(MoveCells(ToCells(position), direction),
+              ToCells(Solver::Move(position, direction)));
+  EXPECT_EQ(Cells({2, 2, 0, 3, 0, 0, 4, 3, 0}),
+            MoveCells(ToCells(position), Directions::kLeft));
+}
+
+/* every position of every layer has the value a plain expectimax gives it,
+ * and the best move reaches that value */
+TEST(SolverTest, AgreesWithBruteForceExpectimax) {
+  for (Tiles goal : {Tiles::kTile_8, Tiles::kTile_16, Tiles::kTile_32}) {
+    SCOPED_TRACE(static_cast<int32_t>(goal));
+    Solver::Options options;
+    options.goal = goal;
+    options.threads = 2;
+    Solver solver(options);
+    solver.Solve();
+    BruteForce brute_force(goal);
+    int64_t positions = 0;
+    for (const Solver::Layer& layer : solver.GetLayers()) {
+      ASSERT_EQ(layer.positions.size(), layer.values.size());
+      for (size_t k = 0; k < layer.positions.size(); k++) {
+        uint64_t position = layer.positions[k];
+        double expected = brute_force.GetValue(ToCells(position));
+        ASSERT_NEAR(expected, layer.values[k], 1e-5);
+        EXPECT_EQ(layer.values[k], solver.GetValue(position));
+        float value = -1;
+        Directions move = solver.GetBestMove(position, &value);
+        EXPECT_NEAR(expected, value, 1e-5);
+        if (move != Directions::kNone) {
+          EXPECT_NE(position, Solver::Move(position, move));
+        }
+        positions++;
+      }
+    }
+    EXPECT_EQ(solver.GetPositionsNumber(), positions);
+    EXPECT_GT(positions, 36);
+  }
+  /* a 2 on every cell is never reached */
+  Solver solver(Solver::Options{});
+  EXPECT_THROW(solver.GetValue(0x111111111), std::runtime_error);
+}
@@ -0,0 +1,106 @@
+#include "tournament/tournament.h"
+#include "ai/strategy.h"
+#include "logic/spawn_distribution.h"
+#include "parallel/parallel.h"
+#include "simulator/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+constexpr double Tournament::kPercentiles[];
+
+Tournament::Tournament(const std::vector<Entry>& entries,
+                       int32_t threads_number,
+                       const SpawnDistribution& spawns)
+    : entries_(entries)
+    , threads_number_(GetThreadsNumber(threads_number))
+    , spawns_(spawns) {
+  if (entries_.empty())
+    throw std::runtime_error("tournament needs at least one strategy");
+}
+
+Tournament::Estimate Tournament::GetEstimate(
+    const std::vector<double>& samples) {
+  Estimate estimate;
+  if (samples.empty())
+    return estimate;
+  for (double sample : samples)
+    estimate.mean += sample;
+  estimate.mean /= samples.size();
+  if (samples.size() < 2)
+    return estimate;
+  double variance = 0;
+  for (double sample : samples)
+    variance += (sample - estimate.mean) * (sample - estimate.mean);
+  variance /= samples.size() - 1;
+  estimate.half_width = kNormalQuantile * std::sqrt(variance / samples.size());
+  return estimate;
+}
+
+std::vector<Tournament::Standing> Tournament::Run(
+    const std::vector<uint64_t>& seeds, ReplayWriter* recorder) const {
+  size_t entries_number = entries_.size();
+  std::vector<Standing> standings(entries_number);
+  for (size_t i = 0; i < entries_number; i++) {
+    standings[i].name = entries_[i].name;
+    standings[i].games.resize(seeds.size());
+  }
+
+  /* seed-major order keeps all strategies progressing together; strategies
+   * are made lazily, one per thread and entry */
+  std::vector<std::vector<std::unique_ptr<Strategy>>> strategies(
+      threads_number_);
+  for (auto& thread_strategies : strategies)
+    thread_strategies.resize(entries_number);
+  ParallelFor(seeds.size() * entries_number, 1, threads_number_,
+              [&](size_t begin, size_t end, int32_t thread_idx) {
+    for (size_t k = begin; k < end; k++) {
+      size_t seed_idx = k / entries_number, entry_idx = k % entries_number;
+      std::unique_ptr<Strategy>& strategy =
+          strategies[thread_idx][entry_idx];
+      if (!strategy)
+        strategy = entries_[entry_idx].factory();
+      Replay replay;
+      standings[entry_idx].games[seed_idx] =
+          Simulator::PlayGame(seeds[seed_idx], *strategy, spawns_,
+                              recorder ? &replay : nullptr);
+      if (recorder)
+        recorder->Write(replay);
+    }
+  });
+
+  for (Standing& standing : standings) {
+    std::vector<double> scores, differences, speeds;
+    standing.max_tiles.assign(static_cast<size_t>(Tiles::kTile_2048) + 1, 0);
+    for (size_t j = 0; j < seeds.size(); j++) {
+      const Simulator::GameResult& game = standing.games[j];
+      scores.push_back(game.score);
+      differences.push_back(game.score - standings[0].games[j].score);
+      if (game.seconds > 0)
+        speeds.push_back(game.moves / game.seconds);
+      standing.max_tiles[static_cast<size_t>(game.max_tile)]++;
+      standing.success_rate += game.success;
+    }
+    if (!seeds.empty())
+      standing.success_rate /= seeds.size();
+    standing.score = GetEstimate(scores);
+    standing.score_difference = GetEstimate(differences);
+    standing.moves_per_second = GetEstimate(speeds);
+
+    std::sort(scores.begin(), scores.end());
+    for (double percentile : kPercentiles) {
+      if (scores.empty())
+        break;
+      size_t rank = static_cast<size_t>(
+          std::ceil(percentile / 100 * scores.size()));
+      standing.score_percentiles.push_back(
+          scores[std::max<size_t>(rank, 1) - 1]);
+    }
+  }
+  return standings;
+}
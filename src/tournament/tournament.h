@@ -0,0 +1,61 @@
+#ifndef _2048_TOURNAMENT_TOURNAMENT_H_
+#define _2048_TOURNAMENT_TOURNAMENT_H_
+
+#include "ai/strategy.h"
+#include "display/display.h"
+#include "logic/spawn_distribution.h"
+#include "replay/replay_writer.h"
+#include "simulator/simulator.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Plays every strategy on the same seeds, so all of them face identical
+ * spawn sequences, with the games of all strategies spread over one thread
+ * pool. Confidence intervals are 95% normal approximations over games. */
+class Tournament {
+ public:
+  struct Entry {
+    std::string name;
+    StrategyFactory factory;
+  };
+
+  struct Estimate {
+    double mean = 0;
+    double half_width = 0;
+  };
+
+  struct Standing {
+    std::string name;
+    std::vector<Simulator::GameResult> games;
+    Estimate score;
+    /* per game score difference from the first entry on the same seed */
+    Estimate score_difference;
+    Estimate moves_per_second;
+    std::vector<double> score_percentiles;
+    /* number of games ended with the given max tile, indexed by Tiles */
+    std::vector<int64_t> max_tiles;
+    double success_rate = 0;
+  };
+
+  static constexpr double kPercentiles[] = {10, 25, 50, 75, 90, 99};
+
+  Tournament(const std::vector<Entry>& entries, int32_t threads_number,
+             const SpawnDistribution& spawns = SpawnDistribution());
+
+  /* every game is appended to recorder if there is one */
+  std::vector<Standing> Run(const std::vector<uint64_t>& seeds,
+                            ReplayWriter* recorder = nullptr) const;
+
+  static Estimate GetEstimate(const std::vector<double>& samples);
+
+ private:
+  static constexpr double kNormalQuantile = 1.96;
+
+  std::vector<Entry> entries_;
+  int32_t threads_number_;
+  SpawnDistribution spawns_;
+};
+
+#endif
@@ -0,0 +1,221 @@
+#include "tuner/cma_es.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <istream>
+#include <numeric>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+static void JacobiEigen(CmaEs::Matrix matrix, CmaEs::Matrix& vectors,
+                        CmaEs::Vector& values) {
+  int32_t n = matrix.size();
+  vectors.assign(n, CmaEs::Vector(n, 0));
+  for (int32_t i = 0; i < n; i++)
+    vectors[i][i] = 1;
+  for (int32_t sweep = 0; sweep < 100; sweep++) {
+    double off = 0;
+    for (int32_t p = 0; p < n; p++)
+      for (int32_t q = p + 1; q < n; q++)
+        off += matrix[p][q] * matrix[p][q];
+    if (off < 1e-30)
+      break;
+    for (int32_t p = 0; p < n; p++) {
+      for (int32_t q = p + 1; q < n; q++) {
+        if (std::fabs(matrix[p][q]) < 1e-300)
+          continue;
+        double theta = (matrix[q][q] - matrix[p][p]) / (2 * matrix[p][q]);
+        double t = (theta >= 0 ? 1 : -1)
+            / (std::fabs(theta) + std::sqrt(theta * theta + 1));
+        double c = 1 / std::sqrt(t * t + 1), s = t * c;
+        for (int32_t k = 0; k < n; k++) {
+          double a_kp = matrix[k][p], a_kq = matrix[k][q];
+          matrix[k][p] = c * a_kp - s * a_kq;
+          matrix[k][q] = s * a_kp + c * a_kq;
+        }
+        for (int32_t k = 0; k < n; k++) {
+          double a_pk = matrix[p][k], a_qk = matrix[q][k];
+          matrix[p][k] = c * a_pk - s * a_qk;
+          matrix[q][k] = s * a_pk + c * a_qk;
+        }
+        for (int32_t k = 0; k < n; k++) {
+          double v_kp = vectors[k][p], v_kq = vectors[k][q];
+          vectors[k][p] = c * v_kp - s * v_kq;
+          vectors[k][q] = s * v_kp + c * v_kq;
+        }
+      }
+    }
+  }
+  values.resize(n);
+  for (int32_t i = 0; i < n; i++)
+    values[i] = matrix[i][i];
+}
+
+/* checked before the population size takes its logarithm */
+static int32_t GetDimension(const CmaEs::Vector& mean) {
+  if (mean.empty())
+    throw std::runtime_error("cma-es needs at least one dimension");
+  return mean.size();
+}
+
+CmaEs::CmaEs(const Vector& mean, double sigma, uint64_t seed)
+    : dimension_(GetDimension(mean))
+    , lambda_(4 + static_cast<int32_t>(3 * std::log(dimension_)))
+    , mu_(lambda_ / 2)
+    , weights_(mu_)
+    , mean_(mean)
+    , sigma_(sigma)
+    , path_c_(dimension_, 0)
+    , path_s_(dimension_, 0)
+    , covariance_(dimension_, Vector(dimension_, 0))
+    , generation_(0)
+    , rng_(seed) {
+  for (int32_t i = 0; i < mu_; i++)
+    weights_[i] = std::log(mu_ + 0.5) - std::log(i + 1);
+  double sum = std::accumulate(weights_.begin(), weights_.end(), 0.0);
+  double square_sum = 0;
+  for (double& weight : weights_) {
+    weight /= sum;
+    square_sum += weight * weight;
+  }
+  mu_eff_ = 1 / square_sum;
+
+  double n = dimension_;
+  c_c_ = (4 + mu_eff_ / n) / (n + 4 + 2 * mu_eff_ / n);
+  c_s_ = (mu_eff_ + 2) / (n + mu_eff_ + 5);
+  c_1_ = 2 / ((n + 1.3) * (n + 1.3) + mu_eff_);
+  c_mu_ = std::min(1 - c_1_, 2 * (mu_eff_ - 2 + 1 / mu_eff_)
+                                 / ((n + 2) * (n + 2) + mu_eff_));
+  damps_ = 1 + 2 * std::max(0.0, std::sqrt((mu_eff_ - 1) / (n + 1)) - 1)
+      + c_s_;
+  chi_n_ = std::sqrt(n) * (1 - 1 / (4 * n) + 1 / (21 * n * n));
+
+  for (int32_t i = 0; i < dimension_; i++)
+    covariance_[i][i] = 1;
+  UpdateEigensystem();
+}
+
+void CmaEs::UpdateEigensystem() {
+  Vector eigenvalues;
+  JacobiEigen(covariance_, eigenvectors_, eigenvalues);
+  eigenvalues_sqrt_.resize(dimension_);
+  for (int32_t i = 0; i < dimension_; i++)
+    eigenvalues_sqrt_[i] = std::sqrt(std::max(eigenvalues[i], 1e-20));
+}
+
+std::vector<CmaEs::Vector> CmaEs::Ask() {
+  std::normal_distribution<double> normal;
+  std::vector<Vector> population(lambda_, Vector(dimension_));
+  for (auto& candidate : population) {
+    Vector z(dimension_);
+    for (double& value : z)
+      value = normal(rng_);
+    for (int32_t i = 0; i < dimension_; i++) {
+      double step = 0;
+      for (int32_t j = 0; j < dimension_; j++)
+        step += eigenvectors_[i][j] * eigenvalues_sqrt_[j] * z[j];
+      candidate[i] = mean_[i] + sigma_ * step;
+    }
+  }
+  return population;
+}
+
+void CmaEs::Tell(const std::vector<Vector>& population, const Vector& fitness) {
+  if (population.size() != fitness.size()
+      || static_cast<int32_t>(population.size()) < mu_)
+    throw std::runtime_error("cma-es population and fitness mismatch");
+  std::vector<size_t> order(population.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&fitness](size_t a, size_t b) {
+    return fitness[a] > fitness[b];
+  });
+
+  Vector old_mean = mean_;
+  for (int32_t i = 0; i < dimension_; i++) {
+    mean_[i] = 0;
+    for (int32_t k = 0; k < mu_; k++)
+      mean_[i] += weights_[k] * population[order[k]][i];
+  }
+
+  Vector shift(dimension_), whitened(dimension_, 0);
+  for (int32_t i = 0; i < dimension_; i++)
+    shift[i] = (mean_[i] - old_mean[i]) / sigma_;
+  /* C^(-1/2) * shift = B * D^(-1) * B^T * shift */
+  Vector projected(dimension_, 0);
+  for (int32_t j = 0; j < dimension_; j++) {
+    for (int32_t i = 0; i < dimension_; i++)
+      projected[j] += eigenvectors_[i][j] * shift[i];
+    projected[j] /= eigenvalues_sqrt_[j];
+  }
+  for (int32_t i = 0; i < dimension_; i++)
+    for (int32_t j = 0; j < dimension_; j++)
+      whitened[i] += eigenvectors_[i][j] * projected[j];
+
+  double path_s_norm = 0;
+  for (int32_t i = 0; i < dimension_; i++) {
+    path_s_[i] = (1 - c_s_) * path_s_[i]
+        + std::sqrt(c_s_ * (2 - c_s_) * mu_eff_) * whitened[i];
+    path_s_norm += path_s_[i] * path_s_[i];
+  }
+  path_s_norm = std::sqrt(path_s_norm);
+  generation_++;
+  bool h_sigma = path_s_norm
+      / std::sqrt(1 - std::pow(1 - c_s_, 2 * generation_)) / chi_n_
+      < 1.4 + 2.0 / (dimension_ + 1);
+  for (int32_t i = 0; i < dimension_; i++)
+    path_c_[i] = (1 - c_c_) * path_c_[i]
+        + h_sigma * std::sqrt(c_c_ * (2 - c_c_) * mu_eff_) * shift[i];
+
+  double decay = 1 - c_1_ - c_mu_
+      + (1 - h_sigma) * c_1_ * c_c_ * (2 - c_c_);
+  for (int32_t i = 0; i < dimension_; i++) {
+    for (int32_t j = 0; j < dimension_; j++) {
+      double rank_mu = 0;
+      for (int32_t k = 0; k < mu_; k++) {
+        const Vector& x = population[order[k]];
+        rank_mu += weights_[k] * (x[i] - old_mean[i]) * (x[j] - old_mean[j]);
+      }
+      covariance_[i][j] = decay * covariance_[i][j]
+          + c_1_ * path_c_[i] * path_c_[j]
+          + c_mu_ * rank_mu / (sigma_ * sigma_);
+    }
+  }
+  sigma_ *= std::exp((c_s_ / damps_) * (path_s_norm / chi_n_ - 1));
+  UpdateEigensystem();
+}
+
+void CmaEs::Save(std::ostream& out) const {
+  out.precision(17);
+  out << dimension_ << ' ' << generation_ << ' ' << sigma_ << '\n';
+  for (const Vector* vector : {&mean_, &path_c_, &path_s_}) {
+    for (double value : *vector)
+      out << value << ' ';
+    out << '\n';
+  }
+  for (const auto& row : covariance_) {
+    for (double value : row)
+      out << value << ' ';
+    out << '\n';
+  }
+  out << rng_ << '\n';
+}
+
+void CmaEs::Load(std::istream& in) {
+  int32_t dimension;
+  in >> dimension >> generation_ >> sigma_;
+  if (!in || dimension != dimension_)
+    throw std::runtime_error("cma-es checkpoint does not match dimension");
+  for (Vector* vector : {&mean_, &path_c_, &path_s_})
+    for (double& value : *vector)
+      in >> value;
+  for (auto& row : covariance_)
+    for (double& value : row)
+      in >> value;
+  in >> rng_;
+  if (!in)
+    throw std::runtime_error("cma-es checkpoint is truncated");
+  UpdateEigensystem();
+}
@@ -0,0 +1,65 @@
+#ifndef _2048_TUNER_CMA_ES_H_
+#define _2048_TUNER_CMA_ES_H_
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <random>
+#include <vector>
+
+/* Covariance matrix adaptation evolution strategy maximizing a noisy
+ * function: Ask samples a population, Tell updates the distribution from
+ * the fitness of every candidate. */
+class CmaEs {
+ public:
+  using Vector = std::vector<double>;
+  using Matrix = std::vector<std::vector<double>>;
+
+  CmaEs(const Vector& mean, double sigma, uint64_t seed);
+
+  std::vector<Vector> Ask();
+
+  void Tell(const std::vector<Vector>& population, const Vector& fitness);
+
+  const Vector& GetMean() const {
+    return mean_;
+  }
+
+  double GetSigma() const {
+    return sigma_;
+  }
+
+  int32_t GetGeneration() const {
+    return generation_;
+  }
+
+  int32_t GetPopulationSize() const {
+    return lambda_;
+  }
+
+  void Save(std::ostream& out) const;
+
+  void Load(std::istream& in);
+
+ private:
+  void UpdateEigensystem();
+
+  int32_t dimension_;
+  int32_t lambda_;
+  int32_t mu_;
+  Vector weights_;
+  double mu_eff_;
+  double c_c_, c_s_, c_1_, c_mu_, damps_, chi_n_;
+
+  Vector mean_;
+  double sigma_;
+  Vector path_c_;
+  Vector path_s_;
+  Matrix covariance_;
+  Matrix eigenvectors_;
+  Vector eigenvalues_sqrt_;
+  int32_t generation_;
+  std::mt19937_64 rng_;
+};
+
+#endif
@@ -0,0 +1,83 @@
+#include "tuner/cma_es.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+const CmaEs::Vector kOptimum = {1, -2, 0.5, 3};
+
+double GetFitness(const CmaEs::Vector& x) {
+  double fitness = 0;
+  for (size_t i = 0; i < x.size(); i++)
+    fitness -= (x[i] - kOptimum[i]) * (x[i] - kOptimum[i]);
+  return fitness;
+}
+
+void RunGenerations(CmaEs& cma_es, int32_t generations) {
+  for (int32_t k = 0; k < generations; k++) {
+    std::vector<CmaEs::Vector> population = cma_es.Ask();
+    CmaEs::Vector fitness;
+    for (const CmaEs::Vector& x : population)
+      fitness.push_back(GetFitness(x));
+    cma_es.Tell(population, fitness);
+  }
+}
+
+}  // namespace
+
+TEST(CmaEsTest, FindsTheMaximumOfAQuadratic) {
+  CmaEs cma_es(CmaEs::Vector(kOptimum.size(), 0), 0.5, 1);
+  EXPECT_EQ(8, cma_es.GetPopulationSize());
+  RunGenerations(cma_es, 200);
+  EXPECT_EQ(200, cma_es.GetGeneration());
+  for (size_t i = 0; i < kOptimum.size(); i++)
+    EXPECT_NEAR(kOptimum[i], cma_es.GetMean()[i], 1e-4);
+  EXPECT_LT(cma_es.GetSigma(), 1e-3);
+}
+
+/* a checkpointed run goes on exactly as the one that was never stopped */
+TEST(CmaEsTest, ResumesFromASavedState) {
+  CmaEs cma_es(CmaEs::Vector(kOptimum.size(), 0), 0.5, 2);
+  RunGenerations(cma_es, 5);
+  std::stringstream checkpoint;
+  cma_es.Save(checkpoint);
+
+  CmaEs resumed(CmaEs::Vector(kOptimum.size(), 0), 0.5, 3);
+  resumed.Load(checkpoint);
+  EXPECT_EQ(cma_es.GetGeneration(), resumed.GetGeneration());
+  EXPECT_EQ(cma_es.GetSigma(), resumed.GetSigma());
+  EXPECT_EQ(cma_es.GetMean(), resumed.GetMean());
+  for (int32_t k = 0; k < 3; k++) {
+    std::vector<CmaEs::Vector> population = cma_es.Ask();
+    EXPECT_EQ(population, resumed.Ask());
+    CmaEs::Vector fitness;
+    for (const CmaEs::Vector& x : population)
+      fitness.push_back(GetFitness(x));
+    cma_es.Tell(population, fitness);
+    resumed.Tell(population, fitness);
+  }
+  EXPECT_EQ(cma_es.GetMean(), resumed.GetMean());
+}
+
+TEST(CmaEsTest, RejectsMismatches) {
+  EXPECT_THROW(CmaEs(CmaEs::Vector(), 0.5, 1), std::runtime_error);
+
+  CmaEs cma_es(CmaEs::Vector(3, 0), 0.5, 1);
+  std::vector<CmaEs::Vector> population = cma_es.Ask();
+  EXPECT_THROW(cma_es.Tell(population, CmaEs::Vector(1)),
+               std::runtime_error);
+
+  std::stringstream checkpoint;
+  cma_es.Save(checkpoint);
+  CmaEs other(CmaEs::Vector(4, 0), 0.5, 1);
+  EXPECT_THROW(other.Load(checkpoint), std::runtime_error);
+  std::string text = checkpoint.str();
+  std::istringstream truncated(text.substr(0, text.size() / 2));
+  EXPECT_THROW(cma_es.Load(truncated), std::runtime_error);
+}